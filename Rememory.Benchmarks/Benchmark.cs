@@ -0,0 +1,84 @@
+﻿using Rememory.Core;
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using System.Threading.Tasks;
+
+namespace Rememory.Benchmarks
+{
+    /// <summary>
+    /// A measured scenario. Timings are taken after a warm-up run and printed as the median and the fastest run
+    /// </summary>
+    public abstract class Benchmark
+    {
+        public abstract string Name { get; }
+
+        public abstract string Description { get; }
+
+        public abstract Task RunAsync();
+
+        protected static TimeSpan Measure(string label, int runs, Action action)
+        {
+            action();
+
+            var times = new List<TimeSpan>(runs);
+            for (int i = 0; i < runs; i++)
+            {
+                long start = Stopwatch.GetTimestamp();
+                action();
+                times.Add(Stopwatch.GetElapsedTime(start));
+            }
+
+            return Report(label, times);
+        }
+
+        protected static async Task<TimeSpan> MeasureAsync(string label, int runs, Func<Task> action)
+        {
+            await action();
+
+            var times = new List<TimeSpan>(runs);
+            for (int i = 0; i < runs; i++)
+            {
+                long start = Stopwatch.GetTimestamp();
+                await action();
+                times.Add(Stopwatch.GetElapsedTime(start));
+            }
+
+            return Report(label, times);
+        }
+
+        // Steps timed inside the core, the same figures as in Settings > About > Performance
+        protected static MetricSummary? GetTiming(string name)
+        {
+            return PerformanceMetrics.GetTimings().FirstOrDefault(timing => timing.Name == name && timing.Count > 0);
+        }
+
+        protected static void ReportTiming(string label, string name)
+        {
+            if (GetTiming(name) is not MetricSummary timing)
+            {
+                Console.WriteLine($"{label,-48} no {name} timings");
+                return;
+            }
+
+            Console.WriteLine($"{label,-48} median {Format(timing.Median)}, p95 {Format(timing.P95)}, max {Format(timing.Max)} ({timing.Count} calls)");
+        }
+
+        protected static ulong GetCounter(string name) => PerformanceMetrics.GetCounters().TryGetValue(name, out var value) ? value : 0;
+
+        protected static string Format(TimeSpan time)
+        {
+            return time.TotalMilliseconds >= 1 ? $"{time.TotalMilliseconds:F2} ms" : $"{time.TotalMicroseconds:F1} µs";
+        }
+
+        private static TimeSpan Report(string label, List<TimeSpan> times)
+        {
+            times.Sort();
+            var median = times[times.Count / 2];
+
+            Console.WriteLine($"{label,-48} median {Format(median)}, min {Format(times[0])} ({times.Count} runs)");
+            return median;
+        }
+    }
+}
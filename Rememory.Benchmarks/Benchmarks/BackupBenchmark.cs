@@ -0,0 +1,92 @@
+﻿using Rememory.Helper;
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.IO;
+using System.IO.Compression;
+using System.Linq;
+using System.Threading.Tasks;
+
+namespace Rememory.Benchmarks.Benchmarks
+{
+    /// <summary>
+    /// Export of a multi-gigabyte history: the parallel writer the app uses against a single ZipArchive
+    /// </summary>
+    public class BackupBenchmark : Benchmark
+    {
+        private const long HistorySize = 2L * 1024 * 1024 * 1024;
+        private const int FileSize = 8 * 1024 * 1024;
+
+        public override string Name => "backup";
+
+        public override string Description => "Zip export of a 2 GB history, PNGs stored and the rest deflated";
+
+        public override async Task RunAsync()
+        {
+            string folderPath = Path.Combine(Path.GetTempPath(), "Rememory.Benchmarks", Path.GetRandomFileName());
+            Directory.CreateDirectory(folderPath);
+
+            try
+            {
+                var files = CreateHistoryFiles(folderPath);
+                string archivePath = Path.Combine(folderPath, "Backup.zip");
+
+                long start = Stopwatch.GetTimestamp();
+                await ParallelZipWriter.WriteAsync(archivePath, files.Select(file => new ParallelZipWriter.EntrySource(
+                    Path.GetFileName(file.Path), () => File.OpenRead(file.Path), file.CompressionLevel, DateTime.Now)), folderPath);
+                ReportThroughput("ParallelZipWriter", Stopwatch.GetElapsedTime(start), archivePath);
+
+                start = Stopwatch.GetTimestamp();
+                using (var archive = ZipFile.Open(archivePath, ZipArchiveMode.Create))
+                {
+                    foreach (var (path, compressionLevel) in files)
+                    {
+                        archive.CreateEntryFromFile(path, Path.GetFileName(path), compressionLevel);
+                    }
+                }
+                ReportThroughput("ZipArchive", Stopwatch.GetElapsedTime(start), archivePath);
+            }
+            finally
+            {
+                Directory.Delete(folderPath, true);
+            }
+        }
+
+        // Like a history of screenshots: 60% random PNG-like data that doesn't compress, 40% bitmap-like data that does
+        private static List<(string Path, CompressionLevel CompressionLevel)> CreateHistoryFiles(string folderPath)
+        {
+            var files = new List<(string, CompressionLevel)>();
+            var random = new Random(1);
+            var data = new byte[FileSize];
+
+            for (int i = 0; i < HistorySize / FileSize; i++)
+            {
+                bool isPng = i % 5 < 3;
+                if (isPng)
+                {
+                    random.NextBytes(data);
+                }
+                else
+                {
+                    for (int j = 0; j < data.Length; j++)
+                    {
+                        data[j] = (byte)(j / 4 % 251 + i);
+                    }
+                }
+
+                string path = Path.Combine(folderPath, $"{i}.{(isPng ? "png" : "bmp")}");
+                File.WriteAllBytes(path, data);
+                files.Add((path, isPng ? CompressionLevel.NoCompression : CompressionLevel.Optimal));
+            }
+
+            return files;
+        }
+
+        private static void ReportThroughput(string label, TimeSpan time, string archivePath)
+        {
+            double megabytes = HistorySize / (1024.0 * 1024);
+            Console.WriteLine($"{label,-48} {time.TotalSeconds:F1} s, {megabytes / time.TotalSeconds:F0} MB/s, archive {new FileInfo(archivePath).Length / (1024 * 1024)} MB");
+            File.Delete(archivePath);
+        }
+    }
+}
@@ -0,0 +1,45 @@
+﻿using Rememory.Core;
+using System.Collections.Generic;
+using System.IO;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace Rememory.Benchmarks.Benchmarks
+{
+    /// <summary>
+    /// Crash-safe history file writes: temporary file, write-through and rename, timed inside the capture
+    /// </summary>
+    public class BlobWriteBenchmark : Benchmark
+    {
+        private const int CapturesPerSize = 10;
+
+        private static readonly int[] Sizes = [64 * 1024, 1024 * 1024, 16 * 1024 * 1024];
+
+        public override string Name => "blob-write";
+
+        public override string Description => "SaveToFile of captured HTML of 64 KB, 1 MB and 16 MB";
+
+        public override async Task RunAsync()
+        {
+            using var session = new CaptureSession();
+
+            foreach (int size in Sizes)
+            {
+                PerformanceMetrics.Reset();
+
+                for (int i = 0; i < CapturesPerSize; i++)
+                {
+                    // The number keeps every capture distinct from the previous one
+                    string htmlPath = Path.Combine(session.HistoryFolderPath, $"{size}-{i}.html");
+                    var html = new StringBuilder(size).Append($"<p>{i}</p>");
+                    html.Append('x', size - html.Length);
+                    await File.WriteAllTextAsync(htmlPath, html.ToString());
+
+                    await session.CaptureAsync(new Dictionary<ClipboardFormat, string> { [ClipboardFormat.Html] = htmlPath });
+                }
+
+                ReportTiming($"{size / 1024} KB", "SaveToFile");
+            }
+        }
+    }
+}
@@ -0,0 +1,46 @@
+﻿using Rememory.Core;
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Threading.Tasks;
+
+namespace Rememory.Benchmarks.Benchmarks
+{
+    /// <summary>
+    /// Capture of short texts step by step, with the number of timings the metrics record for each capture
+    /// </summary>
+    public class CaptureBenchmark : Benchmark
+    {
+        private const int CaptureCount = 100;
+
+        // Steps that keep a thread busy, the debounce and the staging delay only wait
+        private static readonly string[] BusySteps = ["OpenClipboard", "CopyFormat", "Hash", "SaveToFile", "Dispatch"];
+
+        public override string Name => "capture";
+
+        public override string Description => "Captures of 100 short texts, the time of each step and the metrics recorded on the way";
+
+        public override async Task RunAsync()
+        {
+            using var session = new CaptureSession();
+            int capture = 0;
+
+            // The number keeps every capture distinct from the previous one
+            await MeasureAsync("Capture, paste to ContentDetected", CaptureCount, () =>
+                session.CaptureAsync(new Dictionary<ClipboardFormat, string> { [ClipboardFormat.Text] = $"Short clip {capture++}: the quick brown fox jumps over the lazy dog" }));
+
+            foreach (var step in new[] { "Debounce" }.Concat(BusySteps))
+            {
+                ReportTiming(step, step);
+            }
+
+            // Medians of the steps one capture goes through, as a lower bound of the time it keeps threads busy
+            var busy = BusySteps.Select(GetTiming).OfType<MetricSummary>().Aggregate(TimeSpan.Zero, (sum, timing) => sum + timing.Median);
+            ulong captures = Math.Max(GetCounter("Captures"), 1);
+            double timingsPerCapture = PerformanceMetrics.GetTimings().Sum(timing => (double)timing.Count) / captures;
+
+            Console.WriteLine($"{"Busy steps of a capture",-48} {Format(busy)}");
+            Console.WriteLine($"{"Timings recorded per capture",-48} {timingsPerCapture:F1}");
+        }
+    }
+}
@@ -0,0 +1,54 @@
+﻿using Rememory.Core;
+using System;
+using System.Collections.Generic;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace Rememory.Benchmarks.Benchmarks
+{
+    /// <summary>
+    /// Content classification of 5 MB texts: prose ruled out early, and single tokens read to the end
+    /// </summary>
+    public class ClassifierBenchmark : Benchmark
+    {
+        private const int TextSize = 5 * 1024 * 1024;
+
+        public override string Name => "classify";
+
+        public override string Description => "FormatManager.ClassifyText on 5 MB texts, the check every text capture makes";
+
+        public override Task RunAsync()
+        {
+            int length = TextSize / sizeof(char);
+            var texts = new Dictionary<string, string>
+            {
+                ["Log lines"] = Repeat("2024-05-01 INFO Saved clip to HistoryFolder/PngFormat\r\n", length),
+                ["One link"] = "https://example.com/" + Repeat("path/", length - 20),
+                ["One file path"] = @"C:\Users\Public\" + Repeat(@"folder\", length - 16),
+                ["One word, an email candidate"] = Repeat("abcdefgh", length - 12) + "@example.com",
+            };
+
+            double megabytes = TextSize / (1024.0 * 1024);
+            foreach (var (label, text) in texts)
+            {
+                TextContent content = TextContent.None;
+                var median = Measure($"{label}, {megabytes:F0} MB", 11, () => content = FormatManager.ClassifyText(text));
+                Console.WriteLine($"{$"{label}, classified as",-48} {content}, {megabytes / median.TotalSeconds:F0} MB/s");
+            }
+
+            return Task.CompletedTask;
+        }
+
+        private static string Repeat(string part, int length)
+        {
+            var text = new StringBuilder(length + part.Length);
+            while (text.Length < length)
+            {
+                text.Append(part);
+            }
+
+            text.Length = length;
+            return text.ToString();
+        }
+    }
+}
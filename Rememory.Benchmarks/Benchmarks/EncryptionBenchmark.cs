@@ -0,0 +1,68 @@
+﻿using Rememory.Core;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace Rememory.Benchmarks.Benchmarks
+{
+    /// <summary>
+    /// Cost of history encryption where it's paid: writing captured files and reading them back for a paste, sealed against plain
+    /// </summary>
+    public class EncryptionBenchmark : Benchmark
+    {
+        private const int CapturesPerSize = 10;
+
+        private static readonly int[] Sizes = [1024 * 1024, 16 * 1024 * 1024];
+
+        public override string Name => "encryption";
+
+        public override string Description => "Writes and pastes of 1 MB and 16 MB HTML clips with history encryption off and on";
+
+        public override async Task RunAsync()
+        {
+            using var session = new CaptureSession();
+
+            foreach (int size in Sizes)
+            {
+                foreach (bool isEncrypted in new[] { false, true })
+                {
+                    session.Monitor.IsHistoryEncryptionEnabled = isEncrypted;
+                    string label = $"{size / (1024 * 1024)} MB, {(isEncrypted ? "sealed" : "plain")}";
+
+                    PerformanceMetrics.Reset();
+                    var savedPaths = new List<string>(CapturesPerSize);
+
+                    for (int i = 0; i < CapturesPerSize; i++)
+                    {
+                        // The number keeps every capture distinct from the previous one
+                        string htmlPath = Path.Combine(session.HistoryFolderPath, $"{size}-{isEncrypted}-{i}.html");
+                        var html = new StringBuilder(size).Append($"<p>{i}</p>");
+                        html.Append('x', size - html.Length);
+                        await File.WriteAllTextAsync(htmlPath, html.ToString());
+
+                        var snapshot = await session.CaptureAsync(new Dictionary<ClipboardFormat, string> { [ClipboardFormat.Html] = htmlPath });
+                        savedPaths.Add(snapshot.Records.First(record => record.Format == ClipboardFormat.Html).Data);
+                    }
+
+                    ReportTiming($"{label}, write", "SaveToFile");
+
+                    // Pasting a saved file reads it back from the history folder and opens it if it's sealed
+                    PerformanceMetrics.Reset();
+                    foreach (var savedPath in savedPaths)
+                    {
+                        await session.CaptureAsync(new Dictionary<ClipboardFormat, string> { [ClipboardFormat.Html] = savedPath });
+                    }
+
+                    ReportTiming($"{label}, paste", "Paste");
+                    if (isEncrypted)
+                    {
+                        ReportTiming($"{label}, per 64 KB chunk sealed", "Encrypt");
+                        ReportTiming($"{label}, per 64 KB chunk opened", "Decrypt");
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,90 @@
+﻿using Microsoft.UI.Dispatching;
+using Microsoft.UI.Xaml.Hosting;
+using Rememory.Helper;
+using System;
+using System.Diagnostics;
+using System.IO;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace Rememory.Benchmarks.Benchmarks
+{
+    /// <summary>
+    /// Icons for the rows of a copied list of 5k .cs files, asked for on a XAML thread like the file list view does
+    /// </summary>
+    public class FileIconBenchmark : Benchmark
+    {
+        private const int RowCount = 5000;
+
+        public override string Name => "file-icons";
+
+        public override string Description => "FileIconHelper icons for 5k rows of .cs files, the render against the cached rows";
+
+        public override async Task RunAsync()
+        {
+            string folderPath = Path.Combine(Path.GetTempPath(), "Rememory.Benchmarks", Path.GetRandomFileName());
+            Directory.CreateDirectory(folderPath);
+
+            // SHGetFileInfo looks at the files, so they have to exist
+            var paths = Enumerable.Range(0, RowCount).Select(row => Path.Combine(folderPath, $"file_{row:D4}.cs")).ToArray();
+            foreach (var path in paths)
+            {
+                File.WriteAllText(path, string.Empty);
+            }
+
+            // Another file type, its render warms up the shell image list and XAML without caching the .cs icon
+            string warmUpPath = Path.Combine(folderPath, "warm-up.txt");
+            File.WriteAllText(warmUpPath, string.Empty);
+
+            var controller = DispatcherQueueController.CreateOnDedicatedThread();
+            try
+            {
+                var completion = new TaskCompletionSource(TaskCreationOptions.RunContinuationsAsynchronously);
+                controller.DispatcherQueue.TryEnqueue(async () =>
+                {
+                    try
+                    {
+                        await MeasureRowsAsync(warmUpPath, paths);
+                        completion.SetResult();
+                    }
+                    catch (Exception ex)
+                    {
+                        completion.SetException(ex);
+                    }
+                });
+
+                await completion.Task;
+            }
+            finally
+            {
+                await controller.ShutdownQueueAsync();
+                Directory.Delete(folderPath, true);
+            }
+        }
+
+        // SoftwareBitmapSource needs XAML on the calling thread, and the awaits have to come back to it
+        private static async Task MeasureRowsAsync(string warmUpPath, string[] paths)
+        {
+            using var xamlManager = WindowsXamlManager.InitializeForCurrentThread();
+            SynchronizationContext.SetSynchronizationContext(new DispatcherQueueSynchronizationContext(DispatcherQueue.GetForCurrentThread()));
+            await FileIconHelper.GetFileIconAsync(warmUpPath);
+
+            long start = Stopwatch.GetTimestamp();
+            await FileIconHelper.GetFileIconAsync(paths[0]);
+            var firstRow = Stopwatch.GetElapsedTime(start);
+
+            start = Stopwatch.GetTimestamp();
+            foreach (var path in paths.Skip(1))
+            {
+                await FileIconHelper.GetFileIconAsync(path);
+            }
+            var otherRows = Stopwatch.GetElapsedTime(start);
+
+            // Before the cache every row paid what the first one does
+            Console.WriteLine($"{"First row, icon rendered",-48} {Format(firstRow)}");
+            Console.WriteLine($"{$"Other {paths.Length - 1} rows, cached",-48} {Format(otherRows)}, {Format(otherRows / (paths.Length - 1))} per row");
+            Console.WriteLine($"{$"{paths.Length} rows rendering every icon, estimated",-48} {Format(firstRow * paths.Length)}");
+        }
+    }
+}
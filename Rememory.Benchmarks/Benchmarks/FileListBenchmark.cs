@@ -0,0 +1,45 @@
+﻿using Rememory.Core;
+using System.Collections.Generic;
+using System.Linq;
+using System.Threading.Tasks;
+
+namespace Rememory.Benchmarks.Benchmarks
+{
+    /// <summary>
+    /// CF_HDROP lists of 10k and 100k paths, read into the joined path list on capture and written back on paste
+    /// </summary>
+    public class FileListBenchmark : Benchmark
+    {
+        private const int CapturesPerSize = 5;
+
+        private static readonly int[] PathCounts = [10_000, 100_000];
+
+        public override string Name => "file-list";
+
+        public override string Description => "Capture and paste of 10k and 100k copied file paths";
+
+        public override async Task RunAsync()
+        {
+            using var session = new CaptureSession();
+            string separator = FormatManager.FilePathsSeparator;
+
+            foreach (int pathCount in PathCounts)
+            {
+                PerformanceMetrics.Reset();
+
+                for (int i = 0; i < CapturesPerSize; i++)
+                {
+                    // A folder per capture keeps every list distinct from the previous one
+                    string paths = string.Join(separator, Enumerable.Range(0, pathCount)
+                        .Select(path => $@"C:\Users\Public\Rememory.Benchmarks\{i}\module{path % 500:D3}\file_{path:D6}.cs"));
+
+                    await session.CaptureAsync(new Dictionary<ClipboardFormat, string> { [ClipboardFormat.Files] = paths });
+                }
+
+                // The writer's SetClipboardData is timed as Paste, the monitor reading the list back as CopyFormat
+                ReportTiming($"{pathCount} paths, paste", "Paste");
+                ReportTiming($"{pathCount} paths, capture", "CopyFormat");
+            }
+        }
+    }
+}
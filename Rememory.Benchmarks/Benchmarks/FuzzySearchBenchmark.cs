@@ -0,0 +1,82 @@
+﻿using Rememory.Core;
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace Rememory.Benchmarks.Benchmarks
+{
+    /// <summary>
+    /// One search keystroke over 100k clip texts, split into handing the texts to the core and ranking them
+    /// </summary>
+    public class FuzzySearchBenchmark : Benchmark
+    {
+        private const int TextCount = 100_000;
+        private const uint MaxResultCount = 1000;   // As SearchService asks for
+
+        private static readonly string[] Queries = ["cfgprod", "prod", "config production", "srchupd", "zqxj", "e"];
+        private static readonly string[] Words = ["config", "production", "server", "deploy", "user", "request", "error", "build", "release", "cache",
+            "token", "client", "window", "history", "search", "update", "format", "image", "value", "result"];
+
+        public override string Name => "fuzzy-search";
+
+        public override string Description => "FuzzyMatcher over 100k texts against the 16 ms budget of a keystroke";
+
+        public override async Task RunAsync()
+        {
+            // The list SearchService builds, crossing the ABI as IVectorView<String>
+            var texts = CreateTexts();
+            Console.WriteLine($"{TextCount} texts, {texts.Average(text => text.Length):F0} characters on average");
+
+            // An empty query returns right after the texts are copied in, so this is the copy alone
+            var emptyMatcher = new FuzzyMatcher(string.Empty);
+            Measure("Texts copied across the ABI", 11, () => emptyMatcher.FindBest(texts, MaxResultCount));
+
+            foreach (var query in Queries)
+            {
+                var matcher = new FuzzyMatcher(query);
+                int resultCount = 0;
+
+                PerformanceMetrics.Reset();
+                await MeasureAsync($"\"{query}\", FindBestAsync", 11, async () => resultCount = (await matcher.FindBestAsync(texts, MaxResultCount)).Count);
+                ReportTiming($"\"{query}\", ranking only ({resultCount} results)", "FuzzySearch");
+            }
+        }
+
+        // File paths, links, short notes and longer snippets in equal parts
+        private static List<string> CreateTexts()
+        {
+            var random = new Random(1);
+            string Word() => Words[random.Next(Words.Length)];
+
+            var texts = new List<string>(TextCount);
+            for (int i = 0; i < TextCount; i++)
+            {
+                var text = new StringBuilder();
+                switch (i % 4)
+                {
+                    case 0:
+                        text.Append($@"C:\Users\dev\src\{Word()}\{Word()}\{Word()}-{Word()}.yaml");
+                        break;
+                    case 1:
+                        text.Append($"https://example.com/{Word()}/{random.Next(100_000)}");
+                        break;
+                    case 2:
+                        text.AppendJoin(' ', Enumerable.Range(0, random.Next(8, 24)).Select(_ => Word()));
+                        break;
+                    default:
+                        foreach (int word in Enumerable.Range(0, random.Next(40, 240)))
+                        {
+                            text.Append(Word()).Append(word % 9 == 8 ? '\n' : ' ');
+                        }
+                        break;
+                }
+
+                texts.Add(text.ToString());
+            }
+
+            return texts;
+        }
+    }
+}
@@ -0,0 +1,72 @@
+﻿using Rememory.Core;
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Threading.Tasks;
+using Windows.Graphics.Imaging;
+
+namespace Rememory.Benchmarks.Benchmarks
+{
+    /// <summary>
+    /// Cost of the perceptual hash that similar image detection adds to every image capture
+    /// </summary>
+    public class ImageHashBenchmark : Benchmark
+    {
+        private const int CapturesPerSize = 5;
+
+        private static readonly (int Width, int Height)[] Sizes = [(1920, 1080), (3840, 2160), (7680, 4320)];
+
+        public override string Name => "image-hash";
+
+        public override string Description => "dHash of captured PNG screenshots per megapixel";
+
+        public override async Task RunAsync()
+        {
+            using var session = new CaptureSession();
+            session.Monitor.IsSimilarImageDetectionEnabled = true;
+
+            foreach (var (width, height) in Sizes)
+            {
+                PerformanceMetrics.Reset();
+
+                for (int i = 0; i < CapturesPerSize; i++)
+                {
+                    // Every capture differs, a repeat of the previous one would be dropped before hashing
+                    string imagePath = Path.Combine(session.HistoryFolderPath, $"{width}x{height}-{i}.png");
+                    await WritePngAsync(imagePath, width, height, i);
+                    await session.CaptureAsync(new Dictionary<ClipboardFormat, string> { [ClipboardFormat.Png] = imagePath });
+                }
+
+                double megapixels = width * height / 1e6;
+                ReportTiming($"{width}x{height} ({megapixels:F1} MP)", "ImageHash");
+
+                if (GetTiming("ImageHash") is MetricSummary timing)
+                {
+                    Console.WriteLine($"{"",-48} {timing.Median.TotalMilliseconds / megapixels:F2} ms/MP");
+                }
+            }
+        }
+
+        // Gradients shifted by the seed, they compress quickly and stay far from each other's hash
+        private static async Task WritePngAsync(string path, int width, int height, int seed)
+        {
+            var pixels = new byte[width * height * 4];
+            for (int y = 0; y < height; y++)
+            {
+                for (int x = 0; x < width; x++)
+                {
+                    int offset = (y * width + x) * 4;
+                    pixels[offset] = (byte)(x * 255 / width + seed * 50);
+                    pixels[offset + 1] = (byte)(y * 255 / height);
+                    pixels[offset + 2] = (byte)((x + y) * seed);
+                    pixels[offset + 3] = 255;
+                }
+            }
+
+            using var stream = File.Create(path);
+            var encoder = await BitmapEncoder.CreateAsync(BitmapEncoder.PngEncoderId, stream.AsRandomAccessStream());
+            encoder.SetPixelData(BitmapPixelFormat.Bgra8, BitmapAlphaMode.Ignore, (uint)width, (uint)height, 96, 96, pixels);
+            await encoder.FlushAsync();
+        }
+    }
+}
@@ -0,0 +1,137 @@
+﻿using Microsoft.Data.Sqlite;
+using System;
+using System.Diagnostics;
+using System.IO;
+using System.Linq;
+using System.Threading.Tasks;
+
+namespace Rememory.Benchmarks.Benchmarks
+{
+    /// <summary>
+    /// Database side of cleanup: one commit per deleted clip, as cleanup used to run, against the batch DeleteClips runs now
+    /// </summary>
+    public class RetentionBenchmark : Benchmark
+    {
+        private static readonly int[] HistorySizes = [10_000, 100_000];
+        private static readonly int[] VictimCounts = [1, 100, 1000];
+
+        // Clips and Data as the migrations leave them, with the same statement SqliteService deletes with
+        private const string Schema = @"
+            CREATE TABLE Clips (
+              Id INTEGER PRIMARY KEY AUTOINCREMENT NOT NULL,
+              ClipTime DATETIME NOT NULL,
+              IsFavorite INTEGER NOT NULL,
+              OwnerId INTEGER
+            );
+
+            CREATE TABLE Data (
+              Id INTEGER PRIMARY KEY AUTOINCREMENT NOT NULL,
+              ClipId INTEGER NOT NULL,
+              Format TEXT NOT NULL,
+              Data TEXT NOT NULL,
+              Hash BLOB NOT NULL,
+              MetadataFormat TEXT,
+              Size INTEGER,
+              FOREIGN KEY (ClipId) REFERENCES Clips (Id) ON DELETE CASCADE
+            );
+
+            CREATE INDEX IX_Data_ClipId ON Data (ClipId);
+            CREATE INDEX IX_Clips_ClipTime ON Clips (ClipTime);
+            ";
+        private const string DeleteClip = "DELETE FROM Clips WHERE Id = @id;";
+
+        public override string Name => "retention";
+
+        public override string Description => "Deleting the oldest clips from a 10k and 100k clip database, per-clip commits against one batch";
+
+        public override Task RunAsync()
+        {
+            foreach (int historySize in HistorySizes)
+            {
+                foreach (int victimCount in VictimCounts)
+                {
+                    var perClip = Run(historySize, victimCount, isBatch: false);
+                    var batch = Run(historySize, victimCount, isBatch: true);
+                    Console.WriteLine($"{$"{historySize} clips, {victimCount} deleted",-48} per clip {Format(perClip)}, batch {Format(batch)}");
+                }
+            }
+
+            return Task.CompletedTask;
+        }
+
+        private static TimeSpan Run(int historySize, int victimCount, bool isBatch)
+        {
+            string databasePath = Path.Combine(Path.GetTempPath(), $"Rememory.Benchmarks.{Path.GetRandomFileName()}.db");
+
+            try
+            {
+                using var connection = new SqliteConnection($"Data Source={databasePath};Pooling=False");
+                connection.Open();
+                Execute(connection, "PRAGMA journal_mode = WAL;");
+                Execute(connection, "PRAGMA synchronous = NORMAL;");
+                Execute(connection, Schema);
+                Fill(connection, historySize);
+
+                using var command = connection.CreateCommand();
+                command.CommandText = DeleteClip;
+                var idParameter = command.Parameters.Add("id", SqliteType.Integer);
+
+                long start = Stopwatch.GetTimestamp();
+                if (isBatch)
+                {
+                    Execute(connection, "BEGIN IMMEDIATE;");
+                }
+                foreach (int id in Enumerable.Range(1, victimCount))
+                {
+                    idParameter.Value = id;
+                    command.ExecuteNonQuery();
+                }
+                if (isBatch)
+                {
+                    Execute(connection, "COMMIT;");
+                }
+
+                return Stopwatch.GetElapsedTime(start);
+            }
+            finally
+            {
+                SqliteConnection.ClearAllPools();
+                foreach (var path in new[] { databasePath, databasePath + "-wal", databasePath + "-shm" })
+                {
+                    File.Delete(path);
+                }
+            }
+        }
+
+        // Oldest clips get the lowest ids, each clip has a text and a file format
+        private static void Fill(SqliteConnection connection, int historySize)
+        {
+            using var clipCommand = connection.CreateCommand();
+            clipCommand.CommandText = "INSERT INTO Clips (ClipTime, IsFavorite) VALUES (@clipTime, 0);";
+            var clipTime = clipCommand.Parameters.Add("clipTime", SqliteType.Text);
+
+            using var dataCommand = connection.CreateCommand();
+            dataCommand.CommandText = @"
+                INSERT INTO Data (ClipId, Format, Data, Hash, Size) VALUES (last_insert_rowid(), 'CF_UNICODETEXT', 'Clip text', x'00', 18);
+                INSERT INTO Data (ClipId, Format, Data, Hash, Size) VALUES ((SELECT MAX(Id) FROM Clips), 'PNG', 'PngFormat\image.png', x'00', 250000);";
+
+            var time = DateTime.Now.AddDays(-historySize);
+            Execute(connection, "BEGIN;");
+            for (int i = 0; i < historySize; i++)
+            {
+                clipTime.Value = time.AddMinutes(i);
+                clipCommand.ExecuteNonQuery();
+                dataCommand.ExecuteNonQuery();
+            }
+
+            Execute(connection, "COMMIT;");
+        }
+
+        private static void Execute(SqliteConnection connection, string commandText)
+        {
+            using var command = connection.CreateCommand();
+            command.CommandText = commandText;
+            command.ExecuteNonQuery();
+        }
+    }
+}
@@ -0,0 +1,66 @@
+﻿using Rememory.Core;
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using System.Threading.Tasks;
+
+namespace Rememory.Benchmarks.Benchmarks
+{
+    /// <summary>
+    /// Copies a text makes from the clipboard into the app and back: the capture, the managed string and the paste
+    /// </summary>
+    public class TextRoundTripBenchmark : Benchmark
+    {
+        private const int CapturesPerSize = 5;
+
+        private static readonly int[] Sizes = [1024 * 1024, 16 * 1024 * 1024];
+
+        public override string Name => "text-round-trip";
+
+        public override string Description => "Bytes copied and time taken by a capture and paste of 1 MB and 16 MB texts";
+
+        public override async Task RunAsync()
+        {
+            using var session = new CaptureSession();
+
+            foreach (int size in Sizes)
+            {
+                PerformanceMetrics.Reset();
+                var texts = new List<string>(CapturesPerSize);
+                var toManaged = new List<TimeSpan>(CapturesPerSize);
+
+                for (int i = 0; i < CapturesPerSize; i++)
+                {
+                    // The number keeps every capture distinct from the previous one
+                    string text = $"{i} ".PadRight(size / sizeof(char), 'x');
+                    var snapshot = await session.CaptureAsync(new Dictionary<ClipboardFormat, string> { [ClipboardFormat.Text] = text });
+                    var record = snapshot.Records.First(record => record.Format == ClipboardFormat.Text);
+
+                    // Reading the record copies the HSTRING into a managed string, the way ClipboardService takes it
+                    long start = Stopwatch.GetTimestamp();
+                    texts.Add(record.Data);
+                    toManaged.Add(Stopwatch.GetElapsedTime(start));
+                }
+
+                ulong copiedIn = GetCounter("CopiedBytes") / CapturesPerSize;
+                ReportTiming($"{size / (1024 * 1024)} MB, clipboard to record", "CopyFormat");
+                toManaged.Sort();
+                Console.WriteLine($"{$"{size / (1024 * 1024)} MB, record to managed string",-48} median {Format(toManaged[toManaged.Count / 2])}");
+
+                // Pastes hand the managed string over by reference, the only copy is into the clipboard memory.
+                // Waiting for their captures keeps the monitor off the clipboard while the next one is timed
+                PerformanceMetrics.Reset();
+                foreach (var text in texts)
+                {
+                    await session.CaptureAsync(new Dictionary<ClipboardFormat, string> { [ClipboardFormat.Text] = text });
+                }
+                ReportTiming($"{size / (1024 * 1024)} MB, paste", "Paste");
+
+                ulong copiedOut = (ulong)(size + sizeof(char));
+                Console.WriteLine($"{$"{size / (1024 * 1024)} MB, bytes copied per round trip",-48} {copiedIn + (ulong)size + copiedOut} " +
+                    $"({copiedIn} into the record, {size} into the managed string, {copiedOut} into the clipboard)");
+            }
+        }
+    }
+}
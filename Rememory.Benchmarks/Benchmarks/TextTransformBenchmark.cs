@@ -0,0 +1,66 @@
+﻿using Rememory.Core;
+using System;
+using System.Collections.Generic;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace Rememory.Benchmarks.Benchmarks
+{
+    /// <summary>
+    /// Paste of a 5 MB log with every text transform, against the same paste without one
+    /// </summary>
+    public class TextTransformBenchmark : Benchmark
+    {
+        private const int PastesPerTransform = 10;
+        private const int TextSize = 5 * 1024 * 1024;
+
+        public override string Name => "text-transform";
+
+        public override string Description => "Throughput of each text transform pasting a 5 MB log";
+
+        public override Task RunAsync()
+        {
+            using var session = new CaptureSession();
+
+            // Only the paste is timed here, a capture of every paste would compete with it for the clipboard
+            session.Monitor.StopMonitoring();
+
+            var dataMap = new Dictionary<ClipboardFormat, string> { [ClipboardFormat.Text] = CreateLog() };
+            double megabytes = TextSize / (1024.0 * 1024);
+
+            foreach (var transform in Enum.GetValues<TextTransform>())
+            {
+                PerformanceMetrics.Reset();
+
+                for (int i = 0; i < PastesPerTransform; i++)
+                {
+                    if (!session.Paste(dataMap, transform))
+                    {
+                        throw new InvalidOperationException("The clipboard couldn't be opened");
+                    }
+                }
+
+                if (GetTiming("Paste") is MetricSummary timing)
+                {
+                    Console.WriteLine($"{transform,-48} median {Format(timing.Median)}, {megabytes / timing.Median.TotalSeconds:F0} MB/s ({timing.Count} pastes)");
+                }
+            }
+
+            return Task.CompletedTask;
+        }
+
+        // ASCII log lines with mixed case, separators and indentation, the text the case and word transforms see most
+        private static string CreateLog()
+        {
+            int length = TextSize / sizeof(char);
+            var log = new StringBuilder(length + 256);
+            for (int line = 0; log.Length < length; line++)
+            {
+                log.Append($"  2024-05-{line % 28 + 1:D2} INFO [ClipboardService] Saved clip_{line} to HistoryFolder/PngFormat, size={line * 37 % 100000} bytes\r\n");
+            }
+
+            log.Length = length;
+            return log.ToString();
+        }
+    }
+}
@@ -0,0 +1,66 @@
+﻿using System;
+using System.IO;
+using System.Linq;
+using System.Threading.Tasks;
+
+namespace Rememory.Benchmarks.Benchmarks
+{
+    /// <summary>
+    /// What History folder usage would cost as a directory walk, against the single file size read the running totals need per capture
+    /// </summary>
+    public class UsageBenchmark : Benchmark
+    {
+        private static readonly int[] FileCounts = [10_000, 50_000];
+        private static readonly string[] FormatFolders = ["PngFormat", "BitmapFormat", "HtmlFormat", "RtfFormat"];
+
+        public override string Name => "usage";
+
+        public override string Description => "History folder size by walking 10k and 50k files against one size read per capture";
+
+        public override Task RunAsync()
+        {
+            foreach (int fileCount in FileCounts)
+            {
+                string folderPath = Path.Combine(Path.GetTempPath(), "Rememory.Benchmarks", Path.GetRandomFileName());
+                try
+                {
+                    string lastFilePath = CreateHistoryFolder(folderPath, fileCount);
+
+                    Measure($"{fileCount} files, folder walk", 5, () =>
+                    {
+                        _ = new DirectoryInfo(folderPath).EnumerateFiles("*", SearchOption.AllDirectories).Sum(file => file.Length);
+                    });
+
+                    // The size a new clip adds to the totals, read once when it's inserted
+                    Measure($"{fileCount} files, size of the captured file", 1000, () =>
+                    {
+                        _ = new FileInfo(lastFilePath).Length;
+                    });
+                }
+                finally
+                {
+                    Directory.Delete(folderPath, true);
+                }
+            }
+
+            return Task.CompletedTask;
+        }
+
+        private static string CreateHistoryFolder(string folderPath, int fileCount)
+        {
+            var data = new byte[4096];
+            string filePath = string.Empty;
+
+            for (int i = 0; i < fileCount; i++)
+            {
+                string formatFolderPath = Path.Combine(folderPath, FormatFolders[i % FormatFolders.Length]);
+                Directory.CreateDirectory(formatFolderPath);
+
+                filePath = Path.Combine(formatFolderPath, $"{i}.bin");
+                File.WriteAllBytes(filePath, data);
+            }
+
+            return filePath;
+        }
+    }
+}
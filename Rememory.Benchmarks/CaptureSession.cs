@@ -0,0 +1,69 @@
+﻿using Rememory.Core;
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Threading.Tasks;
+
+namespace Rememory.Benchmarks
+{
+    /// <summary>
+    /// Clipboard round trips through the core the way the app makes them.
+    /// One monitor puts the data on the clipboard like a paste does, a second one captures it and saves it into a temporary history folder.
+    /// The clipboard is shared with every other app, so nothing else should copy while a session runs
+    /// </summary>
+    public sealed class CaptureSession : IDisposable
+    {
+        private static readonly TimeSpan CaptureTimeout = TimeSpan.FromSeconds(30);
+
+        // Needs a listener window to own the pasted content, and skips its own changes like the app's monitor does
+        private readonly ClipboardMonitor _writer = new();
+        private TaskCompletionSource<ClipboardSnapshot>? _pendingCapture;
+
+        public ClipboardMonitor Monitor { get; } = new();
+
+        public CaptureSession()
+        {
+            string historyFolderPath = Path.Combine(Path.GetTempPath(), "Rememory.Benchmarks", Path.GetRandomFileName());
+            Directory.CreateDirectory(historyFolderPath);
+
+            Monitor.HistoryFolderPath = historyFolderPath;
+            Monitor.ContentDetected += (_, snapshot) => _pendingCapture?.TrySetResult(snapshot);
+
+            _writer.StartMonitoring();
+            Monitor.StartMonitoring();
+        }
+
+        public string HistoryFolderPath => Monitor.HistoryFolderPath;
+
+        public bool Paste(Dictionary<ClipboardFormat, string> dataMap, TextTransform textTransform = TextTransform.None)
+        {
+            return _writer.SetClipboardData(dataMap, textTransform);
+        }
+
+        // Pastes the data and waits until its capture is saved. Content equal to the previous capture is dropped by the monitor and times out
+        public async Task<ClipboardSnapshot> CaptureAsync(Dictionary<ClipboardFormat, string> dataMap)
+        {
+            var pendingCapture = new TaskCompletionSource<ClipboardSnapshot>(TaskCreationOptions.RunContinuationsAsynchronously);
+            _pendingCapture = pendingCapture;
+
+            if (!Paste(dataMap))
+            {
+                throw new InvalidOperationException("The clipboard couldn't be opened");
+            }
+
+            return await pendingCapture.Task.WaitAsync(CaptureTimeout);
+        }
+
+        public void Dispose()
+        {
+            _writer.StopMonitoring();
+            Monitor.StopMonitoring();
+
+            try
+            {
+                Directory.Delete(HistoryFolderPath, true);
+            }
+            catch (IOException) { }
+        }
+    }
+}
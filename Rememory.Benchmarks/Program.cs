@@ -0,0 +1,53 @@
+﻿using Rememory.Benchmarks.Benchmarks;
+using Rememory.Core;
+using System;
+using System.Linq;
+using System.Threading.Tasks;
+
+namespace Rememory.Benchmarks
+{
+    public class Program
+    {
+        // Usage: Rememory.Benchmarks [name...], runs every benchmark when no name is given.
+        // Build in Release, the timings of a Debug build of the core say little about the shipped one.
+        static async Task<int> Main(string[] args)
+        {
+            Benchmark[] benchmarks =
+            [
+                new CaptureBenchmark(),
+                new ImageHashBenchmark(),
+                new BlobWriteBenchmark(),
+                new BackupBenchmark(),
+                new RetentionBenchmark(),
+                new UsageBenchmark(),
+                new FileListBenchmark(),
+                new FileIconBenchmark(),
+                new TextTransformBenchmark(),
+                new TextRoundTripBenchmark(),
+                new ClassifierBenchmark(),
+                new EncryptionBenchmark(),
+                new FuzzySearchBenchmark(),
+            ];
+
+            var selected = args.Length == 0
+                ? benchmarks
+                : benchmarks.Where(benchmark => args.Contains(benchmark.Name, StringComparer.OrdinalIgnoreCase)).ToArray();
+
+            if (selected.Length == 0)
+            {
+                Console.Error.WriteLine($"Usage: Rememory.Benchmarks [{string.Join(" | ", benchmarks.Select(benchmark => benchmark.Name))}]...");
+                return 1;
+            }
+
+            foreach (var benchmark in selected)
+            {
+                Console.WriteLine($"== {benchmark.Name}: {benchmark.Description}");
+                PerformanceMetrics.Reset();
+                await benchmark.RunAsync();
+                Console.WriteLine();
+            }
+
+            return 0;
+        }
+    }
+}
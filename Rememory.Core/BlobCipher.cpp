@@ -0,0 +1,436 @@
+#include "pch.h"
+#include <algorithm>
+#include <vector>
+#include <dpapi.h>
+#include "BlobCipher.h"
+#include "BlobWriter.h"
+#include "Metrics.h"
+#pragma comment(lib, "bcrypt.lib")
+#pragma comment(lib, "crypt32.lib")
+
+namespace {
+    const wchar_t* const KEY_FILE_NAME = L"History.key";
+    const char KEY_ENTROPY[] = "Rememory.History";
+    const DWORD MAX_KEY_FILE_SIZE = 4096;
+}
+
+namespace winrt::Rememory::Core::implementation
+{
+    void BlobCipher::Initialize(const std::filesystem::path& rootHistoryFolder)
+    {
+        std::scoped_lock lock{ s_keyMutex };
+        s_keyPath = rootHistoryFolder / KEY_FILE_NAME;
+    }
+
+    bool BlobCipher::IsEnabled()
+    {
+        return s_isEnabled.load(std::memory_order_relaxed);
+    }
+
+    void BlobCipher::SetEnabled(bool value)
+    {
+        // Nothing is sealed unless the key exists, so data never ends up sealed with a key that isn't saved
+        s_isEnabled.store(value && GetKey(true) != nullptr, std::memory_order_relaxed);
+    }
+
+    bool BlobCipher::IsSealed(std::span<const BYTE> data)
+    {
+        return data.size() >= HEADER_SIZE
+            && std::equal(MAGIC.begin(), MAGIC.end(), data.begin())
+            && data[MAGIC.size()] == VERSION;
+    }
+
+    size_t BlobCipher::GetSealedSize(size_t size)
+    {
+        size_t chunkCount = (std::max)((size + CHUNK_SIZE - 1) / CHUNK_SIZE, size_t{ 1 });
+        return HEADER_SIZE + size + chunkCount * TAG_SIZE;
+    }
+
+    std::optional<size_t> BlobCipher::GetOpenedSize(size_t sealedSize)
+    {
+        if (sealedSize < HEADER_SIZE + TAG_SIZE)
+        {
+            return std::nullopt;
+        }
+
+        size_t payloadSize = sealedSize - HEADER_SIZE;
+        size_t chunkCount = (payloadSize + CHUNK_SIZE + TAG_SIZE - 1) / (CHUNK_SIZE + TAG_SIZE);
+        size_t lastChunkSize = payloadSize - (chunkCount - 1) * (CHUNK_SIZE + TAG_SIZE);
+
+        if (lastChunkSize < TAG_SIZE)
+        {
+            return std::nullopt;
+        }
+
+        return payloadSize - chunkCount * TAG_SIZE;
+    }
+
+    bool BlobCipher::Seal(std::span<const BYTE> data, BYTE* sealed)
+    {
+        auto key = GetKey(true);
+        auto header = CreateHeader();
+        if (!key || !header)
+        {
+            return false;
+        }
+
+        std::copy(header->begin(), header->end(), sealed);
+        sealed += HEADER_SIZE;
+
+        uint32_t index = 0;
+        do
+        {
+            auto chunk = data.first((std::min)(data.size(), CHUNK_SIZE));
+            data = data.subspan(chunk.size());
+
+            if (!SealChunk(key, *header, index++, data.empty(), chunk, sealed))
+            {
+                return false;
+            }
+
+            sealed += chunk.size() + TAG_SIZE;
+        } while (!data.empty());
+
+        return true;
+    }
+
+    bool BlobCipher::Open(std::span<const BYTE> sealed, BYTE* data)
+    {
+        if (!IsSealed(sealed) || !GetOpenedSize(sealed.size()))
+        {
+            return false;
+        }
+
+        auto key = GetKey(false);
+        if (!key)
+        {
+            return false;
+        }
+
+        Header header;
+        std::copy_n(sealed.begin(), HEADER_SIZE, header.begin());
+        sealed = sealed.subspan(HEADER_SIZE);
+
+        for (uint32_t index = 0; !sealed.empty(); index++)
+        {
+            auto chunk = sealed.first((std::min)(sealed.size(), CHUNK_SIZE + TAG_SIZE));
+            sealed = sealed.subspan(chunk.size());
+
+            if (!OpenChunk(key, header, index, sealed.empty(), chunk, data))
+            {
+                return false;
+            }
+
+            data += chunk.size() - TAG_SIZE;
+        }
+
+        return true;
+    }
+
+    bool BlobCipher::WriteSealed(HANDLE hFile, const void* data, size_t size)
+    {
+        auto key = GetKey(true);
+        auto header = CreateHeader();
+        if (!key || !header || !BlobWriter::WriteAll(hFile, header->data(), header->size()))
+        {
+            return false;
+        }
+
+        // Chunks are sealed into one reusable buffer, a large blob is never copied as a whole
+        std::span<const BYTE> remaining{ static_cast<const BYTE*>(data), size };
+        std::vector<BYTE> sealedChunk(CHUNK_SIZE + TAG_SIZE);
+        uint32_t index = 0;
+
+        do
+        {
+            auto chunk = remaining.first((std::min)(remaining.size(), CHUNK_SIZE));
+            remaining = remaining.subspan(chunk.size());
+
+            if (!SealChunk(key, *header, index++, remaining.empty(), chunk, sealedChunk.data())
+                || !BlobWriter::WriteAll(hFile, sealedChunk.data(), chunk.size() + TAG_SIZE))
+            {
+                return false;
+            }
+        } while (!remaining.empty());
+
+        return true;
+    }
+
+    bool BlobCipher::IsFileSealed(const std::filesystem::path& path)
+    {
+        HANDLE hFile = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (hFile == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        Header header{};
+        DWORD read = 0;
+        bool isSealed = ::ReadFile(hFile, header.data(), HEADER_SIZE, &read, nullptr) && IsSealed({ header.data(), read });
+
+        CloseHandle(hFile);
+        return isSealed;
+    }
+
+    bool BlobCipher::ReadFile(const std::filesystem::path& path, const std::function<BYTE*(size_t)>& allocate)
+    {
+        HANDLE hFile = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (hFile == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        LARGE_INTEGER fileSize{};
+        if (!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart <= 0 || static_cast<uint64_t>(fileSize.QuadPart) > static_cast<uint64_t>(SIZE_MAX))
+        {
+            CloseHandle(hFile);
+            return false;
+        }
+
+        size_t size = static_cast<size_t>(fileSize.QuadPart);
+        Header header{};
+        size_t headerSize = (std::min)(size, HEADER_SIZE);
+        bool isRead = ReadAll(hFile, header.data(), headerSize);
+
+        if (isRead && !IsSealed({ header.data(), headerSize }))
+        {
+            // Plain files are read straight into the target buffer
+            BYTE* output = allocate(size);
+            isRead = output != nullptr;
+
+            if (isRead)
+            {
+                std::copy_n(header.data(), headerSize, output);
+                isRead = ReadAll(hFile, output + headerSize, size - headerSize);
+            }
+        }
+        else if (isRead)
+        {
+            auto openedSize = GetOpenedSize(size);
+            auto key = GetKey(false);
+            BYTE* output = openedSize && key ? allocate(*openedSize) : nullptr;
+            isRead = output != nullptr;
+
+            std::vector<BYTE> sealedChunk(isRead ? CHUNK_SIZE + TAG_SIZE : 0);
+            size_t remaining = size - HEADER_SIZE;
+
+            for (uint32_t index = 0; isRead && remaining > 0; index++)
+            {
+                size_t chunkSize = (std::min)(remaining, CHUNK_SIZE + TAG_SIZE);
+                remaining -= chunkSize;
+
+                isRead = ReadAll(hFile, sealedChunk.data(), chunkSize)
+                    && OpenChunk(key, header, index, remaining == 0, { sealedChunk.data(), chunkSize }, output);
+                output += chunkSize - TAG_SIZE;
+            }
+        }
+
+        CloseHandle(hFile);
+        return isRead;
+    }
+
+    BCRYPT_KEY_HANDLE BlobCipher::GetKey(bool create)
+    {
+        std::scoped_lock lock{ s_keyMutex };
+
+        if (!s_key && !s_keyPath.empty())
+        {
+            s_key = LoadKey();
+
+            // An existing key file that can't be loaded is never replaced, the data sealed with it may still be recovered
+            if (!s_key && create && !std::filesystem::exists(s_keyPath))
+            {
+                s_key = CreateKey();
+            }
+        }
+
+        return s_key;
+    }
+
+    BCRYPT_KEY_HANDLE BlobCipher::LoadKey()
+    {
+        HANDLE hFile = CreateFileW(s_keyPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (hFile == INVALID_HANDLE_VALUE)
+        {
+            return nullptr;
+        }
+
+        std::vector<BYTE> protectedKey(MAX_KEY_FILE_SIZE);
+        DWORD read = 0;
+        bool isRead = ::ReadFile(hFile, protectedKey.data(), MAX_KEY_FILE_SIZE, &read, nullptr) && read > 0;
+        CloseHandle(hFile);
+
+        if (!isRead)
+        {
+            return nullptr;
+        }
+
+        DATA_BLOB input{ read, protectedKey.data() };
+        DATA_BLOB entropy{ sizeof(KEY_ENTROPY) - 1, reinterpret_cast<BYTE*>(const_cast<char*>(KEY_ENTROPY)) };
+        DATA_BLOB output{};
+
+        if (!CryptUnprotectData(&input, nullptr, &entropy, nullptr, nullptr, CRYPTPROTECT_UI_FORBIDDEN, &output))
+        {
+            return nullptr;
+        }
+
+        BCRYPT_KEY_HANDLE key = output.cbData == KEY_SIZE ? ImportKey(output.pbData) : nullptr;
+        SecureZeroMemory(output.pbData, output.cbData);
+        LocalFree(output.pbData);
+
+        return key;
+    }
+
+    BCRYPT_KEY_HANDLE BlobCipher::CreateKey()
+    {
+        std::array<BYTE, KEY_SIZE> keyBytes{};
+        if (!BCRYPT_SUCCESS(BCryptGenRandom(nullptr, keyBytes.data(), KEY_SIZE, BCRYPT_USE_SYSTEM_PREFERRED_RNG)))
+        {
+            return nullptr;
+        }
+
+        DATA_BLOB input{ KEY_SIZE, keyBytes.data() };
+        DATA_BLOB entropy{ sizeof(KEY_ENTROPY) - 1, reinterpret_cast<BYTE*>(const_cast<char*>(KEY_ENTROPY)) };
+        DATA_BLOB output{};
+
+        BCRYPT_KEY_HANDLE key = nullptr;
+
+        if (CryptProtectData(&input, L"Rememory history key", &entropy, nullptr, nullptr, CRYPTPROTECT_UI_FORBIDDEN, &output))
+        {
+            // The key is only used once it's safely on disk
+            std::error_code error;
+            std::filesystem::create_directories(s_keyPath.parent_path(), error);
+
+            HANDLE hFile = CreateFileW(s_keyPath.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_NEW, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_WRITE_THROUGH, nullptr);
+            if (hFile != INVALID_HANDLE_VALUE)
+            {
+                bool isWritten = BlobWriter::WriteAll(hFile, output.pbData, output.cbData) && FlushFileBuffers(hFile);
+                CloseHandle(hFile);
+
+                if (isWritten)
+                {
+                    key = ImportKey(keyBytes.data());
+                }
+                else
+                {
+                    DeleteFileW(s_keyPath.c_str());
+                }
+            }
+
+            LocalFree(output.pbData);
+        }
+
+        SecureZeroMemory(keyBytes.data(), keyBytes.size());
+        return key;
+    }
+
+    BCRYPT_KEY_HANDLE BlobCipher::ImportKey(const BYTE* keyBytes)
+    {
+        BCRYPT_KEY_HANDLE key = nullptr;
+        NTSTATUS status = BCryptGenerateSymmetricKey(BCRYPT_AES_GCM_ALG_HANDLE, &key, nullptr, 0, const_cast<PUCHAR>(keyBytes), KEY_SIZE, 0);
+        return BCRYPT_SUCCESS(status) ? key : nullptr;
+    }
+
+    std::optional<BlobCipher::Header> BlobCipher::CreateHeader()
+    {
+        // Magic, version, 3 reserved bytes and an 8-byte random nonce prefix
+        Header header{};
+        std::copy(MAGIC.begin(), MAGIC.end(), header.begin());
+        header[MAGIC.size()] = VERSION;
+
+        if (!BCRYPT_SUCCESS(BCryptGenRandom(nullptr, header.data() + MAGIC_SIZE, HEADER_SIZE - MAGIC_SIZE, BCRYPT_USE_SYSTEM_PREFERRED_RNG)))
+        {
+            return std::nullopt;
+        }
+
+        return header;
+    }
+
+    std::array<BYTE, BlobCipher::NONCE_SIZE> BlobCipher::GetNonce(const Header& header, uint32_t index, bool isLast)
+    {
+        // Nonce prefix of the header followed by the big-endian chunk index, the top bit marks the last chunk
+        std::array<BYTE, NONCE_SIZE> nonce{};
+        std::copy(header.begin() + MAGIC_SIZE, header.end(), nonce.begin());
+
+        uint32_t counter = (index & 0x7FFFFFFF) | (isLast ? 0x80000000 : 0);
+        nonce[NONCE_SIZE - 4] = static_cast<BYTE>(counter >> 24);
+        nonce[NONCE_SIZE - 3] = static_cast<BYTE>(counter >> 16);
+        nonce[NONCE_SIZE - 2] = static_cast<BYTE>(counter >> 8);
+        nonce[NONCE_SIZE - 1] = static_cast<BYTE>(counter);
+
+        return nonce;
+    }
+
+    bool BlobCipher::SealChunk(BCRYPT_KEY_HANDLE key, const Header& header, uint32_t index, bool isLast, std::span<const BYTE> chunk, BYTE* sealed)
+    {
+        Metrics::Scope scope{ MetricId::Encrypt };
+
+        auto nonce = GetNonce(header, index, isLast);
+
+        BCRYPT_AUTHENTICATED_CIPHER_MODE_INFO authInfo;
+        BCRYPT_INIT_AUTH_MODE_INFO(authInfo);
+        authInfo.pbNonce = nonce.data();
+        authInfo.cbNonce = NONCE_SIZE;
+        authInfo.pbAuthData = const_cast<PUCHAR>(header.data());
+        authInfo.cbAuthData = MAGIC_SIZE;
+        authInfo.pbTag = sealed + chunk.size();
+        authInfo.cbTag = TAG_SIZE;
+
+        ULONG written = 0;
+        NTSTATUS status = BCryptEncrypt(key, const_cast<PUCHAR>(chunk.data()), static_cast<ULONG>(chunk.size()), &authInfo,
+            nullptr, 0, sealed, static_cast<ULONG>(chunk.size()), &written, 0);
+
+        return BCRYPT_SUCCESS(status) && written == chunk.size();
+    }
+
+    bool BlobCipher::OpenChunk(BCRYPT_KEY_HANDLE key, const Header& header, uint32_t index, bool isLast, std::span<const BYTE> sealed, BYTE* chunk)
+    {
+        Metrics::Scope scope{ MetricId::Decrypt };
+
+        if (sealed.size() < TAG_SIZE)
+        {
+            return false;
+        }
+
+        auto nonce = GetNonce(header, index, isLast);
+        size_t chunkSize = sealed.size() - TAG_SIZE;
+
+        BCRYPT_AUTHENTICATED_CIPHER_MODE_INFO authInfo;
+        BCRYPT_INIT_AUTH_MODE_INFO(authInfo);
+        authInfo.pbNonce = nonce.data();
+        authInfo.cbNonce = NONCE_SIZE;
+        authInfo.pbAuthData = const_cast<PUCHAR>(header.data());
+        authInfo.cbAuthData = MAGIC_SIZE;
+        authInfo.pbTag = const_cast<PUCHAR>(sealed.data() + chunkSize);
+        authInfo.cbTag = TAG_SIZE;
+
+        // Fails with STATUS_AUTH_TAG_MISMATCH if the chunk was modified or is out of place
+        ULONG written = 0;
+        NTSTATUS status = BCryptDecrypt(key, const_cast<PUCHAR>(sealed.data()), static_cast<ULONG>(chunkSize), &authInfo,
+            nullptr, 0, chunk, static_cast<ULONG>(chunkSize), &written, 0);
+
+        return BCRYPT_SUCCESS(status) && written == chunkSize;
+    }
+
+    bool BlobCipher::ReadAll(HANDLE hFile, void* buffer, size_t size)
+    {
+        // ReadFile takes at most 4GB per call
+        auto* current = static_cast<BYTE*>(buffer);
+
+        while (size > 0)
+        {
+            DWORD chunkSize = static_cast<DWORD>((std::min)(size, static_cast<size_t>(MAXDWORD)));
+            DWORD read = 0;
+
+            if (!::ReadFile(hFile, current, chunkSize, &read, nullptr) || read == 0)
+            {
+                return false;
+            }
+
+            current += read;
+            size -= read;
+        }
+
+        return true;
+    }
+}
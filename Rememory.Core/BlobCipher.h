@@ -0,0 +1,80 @@
+#pragma once
+#include "pch.h"
+#include <array>
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <bcrypt.h>
+
+namespace winrt::Rememory::Core::implementation
+{
+    // Authenticated encryption of history blobs and stored text with AES-256-GCM. CNG runs it on AES-NI and PCLMULQDQ where available.
+    // The key is generated once and kept next to the history, protected with DPAPI for the current user.
+    //
+    // Sealed layout: a header with a random nonce prefix, then the data in fixed-size chunks, each followed by its tag.
+    // A chunk nonce is the prefix, the chunk index and a last-chunk flag, so chunks can't be reordered, dropped or appended.
+    // Data is processed one chunk at a time, so files are sealed and opened while they are written and read.
+    class BlobCipher
+    {
+    public:
+        static constexpr size_t HEADER_SIZE = 16;
+        static constexpr size_t CHUNK_SIZE = 64 * 1024;
+        static constexpr size_t TAG_SIZE = 16;
+
+        using Header = std::array<BYTE, HEADER_SIZE>;
+
+        // Sets the folder that holds the key file. Call before anything is sealed or opened.
+        static void Initialize(const std::filesystem::path& rootHistoryFolder);
+
+        // New data is sealed while enabled, sealed data is opened either way.
+        // Enabling creates the key on first use and has no effect if no key can be created.
+        static bool IsEnabled();
+        static void SetEnabled(bool value);
+
+        // Checks the header only, the rest is verified while the data is opened
+        static bool IsSealed(std::span<const BYTE> data);
+        static size_t GetSealedSize(size_t size);
+        static std::optional<size_t> GetOpenedSize(size_t sealedSize);
+
+        // sealed holds GetSealedSize bytes, data holds GetOpenedSize bytes
+        static bool Seal(std::span<const BYTE> data, BYTE* sealed);
+        static bool Open(std::span<const BYTE> sealed, BYTE* data);
+
+        // Writes data sealed to an open file
+        static bool WriteSealed(HANDLE hFile, const void* data, size_t size);
+
+        // Reads only the header of the file
+        static bool IsFileSealed(const std::filesystem::path& path);
+
+        // Reads a whole history file into the buffer returned by allocate, opening it if it's sealed
+        static bool ReadFile(const std::filesystem::path& path, const std::function<BYTE*(size_t)>& allocate);
+
+    private:
+        static constexpr std::array<BYTE, 4> MAGIC = { 0x00, 'R', 'M', 'S' };
+        static constexpr BYTE VERSION = 1;
+        static constexpr size_t MAGIC_SIZE = MAGIC.size() + 1 + 3;   // Magic, version and reserved bytes, authenticated with every chunk
+        static constexpr size_t KEY_SIZE = 32;
+        static constexpr size_t NONCE_SIZE = 12;
+
+        static inline std::filesystem::path s_keyPath{};
+        static inline std::mutex s_keyMutex{};
+        static inline BCRYPT_KEY_HANDLE s_key = nullptr;
+        static inline std::atomic<bool> s_isEnabled = false;
+
+        // Loads the key, creating it if asked to and there's none yet
+        static BCRYPT_KEY_HANDLE GetKey(bool create);
+        static BCRYPT_KEY_HANDLE LoadKey();
+        static BCRYPT_KEY_HANDLE CreateKey();
+        static BCRYPT_KEY_HANDLE ImportKey(const BYTE* keyBytes);
+
+        static std::optional<Header> CreateHeader();
+        static std::array<BYTE, NONCE_SIZE> GetNonce(const Header& header, uint32_t index, bool isLast);
+        static bool SealChunk(BCRYPT_KEY_HANDLE key, const Header& header, uint32_t index, bool isLast, std::span<const BYTE> chunk, BYTE* sealed);
+        static bool OpenChunk(BCRYPT_KEY_HANDLE key, const Header& header, uint32_t index, bool isLast, std::span<const BYTE> sealed, BYTE* chunk);
+
+        static bool ReadAll(HANDLE hFile, void* buffer, size_t size);
+    };
+}
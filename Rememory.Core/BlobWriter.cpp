@@ -0,0 +1,129 @@
+#include "pch.h"
+#include <algorithm>
+#include "BlobWriter.h"
+#include "FormatManager.h"
+#include "BlobCipher.h"
+
+namespace winrt::Rememory::Core::implementation
+{
+    winrt::Windows::Foundation::IAsyncOperation<bool> BlobWriter::WriteAsync(std::filesystem::path path, const void* data, size_t size, bool writeThrough)
+    {
+        bool seal = BlobCipher::IsEnabled();
+        co_await winrt::resume_background();
+
+        // Resumes on the thread pool once a slot is free, a free slot is taken right away on this thread
+        if (s_writeSlots)
+        {
+            co_await winrt::resume_on_signal(s_writeSlots.get());
+        }
+
+        auto tempPath = GetTempPath(path);
+        bool isWritten = WriteFileData(tempPath, data, size, writeThrough, seal) && Commit(tempPath, path);
+
+        if (s_writeSlots)
+        {
+            ReleaseSemaphore(s_writeSlots.get(), 1, nullptr);
+        }
+
+        if (!isWritten)
+        {
+            DeleteFileW(tempPath.c_str());
+        }
+
+        co_return isWritten;
+    }
+
+    winrt::Windows::Foundation::IAsyncOperation<bool> BlobWriter::WritePngAsync(std::filesystem::path path, winrt::array_view<const uint8_t> pixels, uint32_t width, uint32_t height, bool writeThrough)
+    {
+        // The image is encoded in memory, so it goes through the same write path as every other blob
+        winrt::Windows::Storage::Streams::InMemoryRandomAccessStream stream;
+        auto encoder = co_await winrt::Windows::Graphics::Imaging::BitmapEncoder::CreateAsync(winrt::Windows::Graphics::Imaging::BitmapEncoder::PngEncoderId(), stream);
+
+        encoder.SetPixelData(
+            winrt::Windows::Graphics::Imaging::BitmapPixelFormat::Bgra8,
+            winrt::Windows::Graphics::Imaging::BitmapAlphaMode::Ignore,
+            width,
+            height,
+            96.0, 96.0,
+            pixels
+        );
+
+        co_await encoder.FlushAsync();
+
+        uint32_t encodedSize = static_cast<uint32_t>(stream.Size());
+        winrt::Windows::Storage::Streams::Buffer encoded{ encodedSize };
+        stream.Seek(0);
+        co_await stream.ReadAsync(encoded, encodedSize, winrt::Windows::Storage::Streams::InputStreamOptions::None);
+
+        co_return co_await WriteAsync(path, encoded.data(), encoded.Length(), writeThrough);
+    }
+
+    std::filesystem::path BlobWriter::GetTempPath(const std::filesystem::path& path)
+    {
+        // <History>/<Folder>/<name>.ext -> <History>/Temp/<name>.ext.tmp
+        auto historyFolder = path.parent_path().parent_path();
+        return historyFolder / FormatManager::TempFolderName().c_str() / (path.filename().wstring() + L".tmp");
+    }
+
+    bool BlobWriter::Commit(const std::filesystem::path& tempPath, const std::filesystem::path& path)
+    {
+        std::error_code error;
+        std::filesystem::create_directories(path.parent_path(), error);
+
+        // Both folders are on the same volume, so the rename is atomic
+        return MoveFileExW(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+    }
+
+    void BlobWriter::RemoveIncompleteFiles(const std::filesystem::path& rootHistoryFolder)
+    {
+        // Temporary files live in their own folder, so recovery doesn't have to walk the history
+        std::error_code error;
+        std::filesystem::remove_all(rootHistoryFolder / FormatManager::TempFolderName().c_str(), error);
+    }
+
+    bool BlobWriter::WriteFileData(const std::filesystem::path& path, const void* data, size_t size, bool writeThrough, bool seal)
+    {
+        std::error_code error;
+        std::filesystem::create_directories(path.parent_path(), error);
+
+        DWORD flags = FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN | (writeThrough ? FILE_FLAG_WRITE_THROUGH : 0);
+        HANDLE hFile = CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, flags, nullptr);
+        if (hFile == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        bool isWritten = seal ? BlobCipher::WriteSealed(hFile, data, size) : WriteAll(hFile, data, size);
+
+        if (isWritten && writeThrough)
+        {
+            isWritten = FlushFileBuffers(hFile);
+        }
+
+        CloseHandle(hFile);
+        return isWritten;
+    }
+
+    bool BlobWriter::WriteAll(HANDLE hFile, const void* data, size_t size)
+    {
+        // WriteFile takes at most 4GB per call
+        auto* current = static_cast<const BYTE*>(data);
+        size_t remaining = size;
+
+        while (remaining > 0)
+        {
+            DWORD chunkSize = static_cast<DWORD>(std::min<size_t>(remaining, MAXDWORD));
+            DWORD written = 0;
+
+            if (!WriteFile(hFile, current, chunkSize, &written, nullptr) || written != chunkSize)
+            {
+                return false;
+            }
+
+            current += written;
+            remaining -= written;
+        }
+
+        return true;
+    }
+}
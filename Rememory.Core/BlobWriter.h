@@ -0,0 +1,40 @@
+#pragma once
+#include "pch.h"
+#include <filesystem>
+
+namespace winrt::Rememory::Core::implementation
+{
+    // Crash-safe writes of history files: data goes to a temporary file that replaces the target only once it's complete,
+    // so a crash never leaves a truncated blob behind
+    class BlobWriter
+    {
+    public:
+        // Writes the buffer to path on a background thread. The buffer must stay alive until the operation completes.
+        // With writeThrough the data is on disk before the file appears under its final name.
+        // The file is sealed with BlobCipher while history encryption is enabled.
+        static winrt::Windows::Foundation::IAsyncOperation<bool> WriteAsync(std::filesystem::path path, const void* data, size_t size, bool writeThrough = true);
+
+        // Encodes 32bpp BGRA pixels as PNG and writes it like WriteAsync
+        static winrt::Windows::Foundation::IAsyncOperation<bool> WritePngAsync(std::filesystem::path path, winrt::array_view<const uint8_t> pixels, uint32_t width, uint32_t height, bool writeThrough = true);
+
+        // Temporary location for a file that will be committed to path
+        static std::filesystem::path GetTempPath(const std::filesystem::path& path);
+
+        // Moves a completed temporary file over its target
+        static bool Commit(const std::filesystem::path& tempPath, const std::filesystem::path& path);
+
+        // Removes temporary files left behind by writes interrupted by a crash. Call before any write starts.
+        static void RemoveIncompleteFiles(const std::filesystem::path& rootHistoryFolder);
+
+        // Writes the whole buffer to an open file
+        static bool WriteAll(HANDLE hFile, const void* data, size_t size);
+
+    private:
+        // Bound on the writes running at once, so a burst of captures doesn't occupy the whole thread pool.
+        // A Win32 semaphore rather than std::counting_semaphore, so waiting for a slot doesn't hold a thread
+        static constexpr LONG MAX_PENDING_WRITES = 4;
+        static inline winrt::handle s_writeSlots{ CreateSemaphoreW(nullptr, MAX_PENDING_WRITES, MAX_PENDING_WRITES, nullptr) };
+
+        static bool WriteFileData(const std::filesystem::path& path, const void* data, size_t size, bool writeThrough, bool seal);
+    };
+}
@@ -0,0 +1,128 @@
+#include "pch.h"
+#include <mutex>
+#include "ClipboardListener.h"
+#include "ClipboardMonitor.h"
+
+namespace winrt::Rememory::Core::implementation
+{
+    ClipboardListener::ClipboardListener(ClipboardMonitor* monitor)
+        : m_monitor(monitor)
+    {
+        if (!m_monitor)
+        {
+            throw std::invalid_argument{ "ClipboardMonitor cannot be null." };
+        }
+
+        std::promise<bool> started;
+        auto isStarted = started.get_future();
+        m_thread = std::thread{ &ClipboardListener::Run, this, std::move(started) };
+
+        if (!isStarted.get())
+        {
+            m_thread.join();
+            throw std::runtime_error{ "Failed to start clipboard format listener." };
+        }
+    }
+
+    ClipboardListener::~ClipboardListener()
+    {
+        if (m_hWnd)
+        {
+            PostMessage(m_hWnd, WM_CLOSE, 0, 0);
+        }
+
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+    }
+
+    void ClipboardListener::Run(std::promise<bool> started)
+    {
+        // Single-threaded apartment, so a capture resumes on this thread after every co_await
+        winrt::init_apartment(winrt::apartment_type::single_threaded);
+        SetThreadDescription(GetCurrentThread(), L"Rememory clipboard listener");
+
+        RegisterWindowClass();
+        HWND hWnd = CreateWindowEx(0, WINDOW_CLASS_NAME, L"", 0, 0, 0, 0, 0, HWND_MESSAGE, nullptr, GetModuleHandle(nullptr), this);
+
+        if (!hWnd || !AddClipboardFormatListener(hWnd))
+        {
+            if (hWnd)
+            {
+                DestroyWindow(hWnd);
+            }
+
+            started.set_value(false);
+            winrt::uninit_apartment();
+            return;
+        }
+
+        m_hWnd = hWnd;
+        started.set_value(true);
+
+        MSG msg;
+        while (GetMessage(&msg, nullptr, 0, 0) > 0)
+        {
+            TranslateMessage(&msg);
+            DispatchMessage(&msg);
+        }
+
+        winrt::uninit_apartment();
+    }
+
+    void ClipboardListener::RegisterWindowClass()
+    {
+        static std::once_flag registered;
+        std::call_once(registered, []()
+            {
+                WNDCLASSEX windowClass{ sizeof(windowClass) };
+                windowClass.lpfnWndProc = WindowProc;
+                windowClass.hInstance = GetModuleHandle(nullptr);
+                windowClass.lpszClassName = WINDOW_CLASS_NAME;
+                RegisterClassEx(&windowClass);
+            });
+    }
+
+    LRESULT CALLBACK ClipboardListener::WindowProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
+    {
+        if (uMsg == WM_NCCREATE)
+        {
+            auto createStruct = reinterpret_cast<CREATESTRUCT*>(lParam);
+            SetWindowLongPtr(hWnd, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(createStruct->lpCreateParams));
+        }
+
+        auto listener = reinterpret_cast<ClipboardListener*>(GetWindowLongPtr(hWnd, GWLP_USERDATA));
+        if (!listener)
+        {
+            return DefWindowProc(hWnd, uMsg, wParam, lParam);
+        }
+
+        switch (uMsg)
+        {
+        case WM_CLIPBOARDUPDATE:
+            listener->m_monitor->OnClipboardUpdate(hWnd);
+            return 0;
+
+        case WM_TIMER:
+            listener->m_monitor->OnTimerElapsed(hWnd, wParam);
+            return 0;
+
+        case WM_COMMIT_STAGED_CAPTURE:
+            listener->m_monitor->OnCommitStagedCapture(hWnd);
+            return 0;
+
+        case WM_CLOSE:
+            DestroyWindow(hWnd);
+            return 0;
+
+        case WM_DESTROY:
+            RemoveClipboardFormatListener(hWnd);
+            SetWindowLongPtr(hWnd, GWLP_USERDATA, 0);
+            PostQuitMessage(0);
+            return 0;
+        }
+
+        return DefWindowProc(hWnd, uMsg, wParam, lParam);
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "pch.h"
+#include <future>
+#include <thread>
+
+namespace winrt::Rememory::Core::implementation
+{
+    struct ClipboardMonitor;
+
+    // Receives clipboard notifications on a message-only window that runs its own message loop,
+    // so the debounce and the capture never wait behind layout and rendering on the UI thread.
+    // The window keeps a pointer to its listener, so every message is dispatched without a lookup.
+    class ClipboardListener
+    {
+    public:
+        // Starts the listener thread and waits until its window is registered for clipboard updates
+        explicit ClipboardListener(ClipboardMonitor* monitor);
+        ~ClipboardListener();
+
+        ClipboardListener(const ClipboardListener&) = delete;
+        ClipboardListener& operator=(const ClipboardListener&) = delete;
+
+        HWND WindowHandle() const { return m_hWnd; }
+
+        // Posted to save the staged capture on the listener thread
+        static constexpr UINT WM_COMMIT_STAGED_CAPTURE = WM_APP + 1;
+
+    private:
+        static constexpr wchar_t WINDOW_CLASS_NAME[] = L"Rememory.Core.ClipboardListener";
+
+        ClipboardMonitor* m_monitor = nullptr;
+        HWND m_hWnd = nullptr;
+        std::thread m_thread;
+
+        void Run(std::promise<bool> started);
+
+        static void RegisterWindowClass();
+        static LRESULT CALLBACK WindowProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
+    };
+}
@@ -1,5 +1,9 @@
 #include "pch.h"
+#include <algorithm>
 #include <filesystem>
+#include <span>
+#include <appmodel.h>
+#include <ShlObj.h>
 #include <gdiplus.h>
 #include "ClipboardMonitor.h"
 #include "ClipboardMonitor.g.cpp"
@@ -7,22 +11,34 @@
 #include "ClipboardSnapshot.h"
 #include "FormatManager.h"
 #include "ProcessInfo.h"
+#include "ImageHash.h"
+#include "Thumbnail.h"
+#include "BlobWriter.h"
+#include "TextTransformer.h"
+#include "ContentClassifier.h"
+#include "Metrics.h"
+#include "PasteCache.h"
 #pragma comment(lib, "gdiplus.lib")
 
 namespace {
     const UINT_PTR TIMER_ID = 1;
     const DWORD TIMER_DELAY = 100;   // 100ms debounce delay
+    const UINT_PTR STAGING_TIMER_ID = 2;
+    const DWORD STAGING_DELAY = 400;            // A capture is saved once the clipboard stays unchanged this long
+    const ULONGLONG MAX_STAGING_TIME = 2000;    // Longest a clipboard that keeps changing goes without a save
     const UINT OPEN_CLIPBOARD_ATTEMPTS = 5;
     const UINT OPEN_CLIPBOARD_DELAY = 50;   // 50ms wait between attempts
+    const std::chrono::milliseconds FILES_SCAN_TIME_BUDGET{ 200 };   // Longest a file list capture waits for its sizes
 }
 
 namespace winrt::Rememory::Core::implementation
 {
     ClipboardMonitor::ClipboardMonitor()
     {
-        auto appDataLocalFolderPath = std::filesystem::path{ winrt::Microsoft::Windows::Storage::ApplicationData::GetDefault().LocalPath().c_str() };
-        auto historyFolderPath = appDataLocalFolderPath / FormatManager::RootHistoryFolderName().c_str();
+        auto historyFolderPath = GetLocalDataFolderPath() / FormatManager::RootHistoryFolderName().c_str();
         HistoryFolderPath({ historyFolderPath.c_str() });
+        BlobWriter::RemoveIncompleteFiles(historyFolderPath);
+        BlobCipher::Initialize(historyFolderPath);
 
         // Gdiplus used to work with Bitmap
         Gdiplus::GdiplusStartupInput input;
@@ -31,7 +47,9 @@ namespace winrt::Rememory::Core::implementation
 
     ClipboardMonitor::~ClipboardMonitor()
     {
-        StopMonitoring();
+        // Nothing can be saved for an object that is going away, a staged capture is dropped with the listener
+        m_listener.reset();
+        PasteCache::Shutdown();
 
         if (m_gdiplusToken != 0)
         {
@@ -40,70 +58,49 @@ namespace winrt::Rememory::Core::implementation
         }
     }
 
-    void ClipboardMonitor::StartMonitoring(UINT_PTR windowHandle)
+    void ClipboardMonitor::StartMonitoring()
     {
-        // Convert the generic LPVOID back to HWND
-        HWND new_hWnd = reinterpret_cast<HWND>(windowHandle);
-
-        if (!new_hWnd)
-        {
-            throw winrt::hresult_invalid_argument(L"Invalid window handle provided.");
-        }
-
-        if (m_message_hook)
+        if (m_listener)
         {
-            // If monitoring is already active, check if it's the same handle.
-            if (m_hWnd == new_hWnd)
-            {
-                return;
-            }
-
-            StopMonitoring();
+            return;
         }
 
-        // Set the new handle
-        m_hWnd = new_hWnd;
+        m_eventContext = winrt::apartment_context{};
+        m_timerId = 0;
 
         try
         {
-            m_message_hook = std::make_unique<WindowMessageHook>(m_hWnd, this);
+            m_listener = std::make_unique<ClipboardListener>(this);
         }
-        catch (const std::exception& e)
+        catch (const std::exception&)
         {
-            m_hWnd = nullptr;
-            throw winrt::hresult_error{ E_FAIL, L"Failed to establish Win32 window hook." };
+            throw winrt::hresult_error{ E_FAIL, L"Failed to start the clipboard listener." };
         }
     }
 
     void ClipboardMonitor::StopMonitoring()
     {
-        if (m_timerId) {
-            KillTimer(m_hWnd, m_timerId);
-            m_timerId = 0;
-        }
+        // Destroying the listener window also kills pending timers, and the staged capture is this thread's once the listener is gone
+        m_listener.reset();
+        m_stagingTimerId = 0;
 
-        if (m_message_hook)
+        // A copy made just before monitoring stopped is saved rather than lost
+        if (m_stagedCapture)
         {
-            m_message_hook.reset();
-            m_hWnd = nullptr;
+            SaveCapture(std::move(m_stagedCapture));
         }
     }
 
-    // Timer callback that runs after the debounce delay
-    void CALLBACK ClipboardMonitor::MonitorTimerProc(HWND hWnd, UINT uMsg, UINT_PTR idEvent, DWORD dwTime)
+    void ClipboardMonitor::CommitStagedCapture()
     {
-        KillTimer(hWnd, idEvent);
-
-        ClipboardMonitor* monitor = WindowMessageHook::GetMonitorInstance(hWnd);
-
-        // Clear the timer ID on the instance
-        if (monitor) {
-            monitor->m_timerId = 0;
-            monitor->HandleClipboardData();
+        // The staged capture belongs to the listener thread
+        if (m_listener)
+        {
+            PostMessage(m_listener->WindowHandle(), ClipboardListener::WM_COMMIT_STAGED_CAPTURE, 0, 0);
         }
     }
 
-    void ClipboardMonitor::OnClipboardUpdate()
+    void ClipboardMonitor::OnClipboardUpdate(HWND hWnd)
     {
         HWND ownerWindow = GetClipboardOwner();
         m_lastOwnerPath = ProcessInfo::GetProcessPath(reinterpret_cast<UINT_PTR>(ownerWindow));
@@ -123,19 +120,80 @@ namespace winrt::Rememory::Core::implementation
         if (!m_timerId)
         {
             // Start timer to debounce multiple rapid updates
-            m_timerId = SetTimer(m_hWnd, TIMER_ID, TIMER_DELAY, MonitorTimerProc);
+            m_debounceStart = Metrics::Now();
+            m_timerId = SetTimer(hWnd, TIMER_ID, TIMER_DELAY, nullptr);
         }
     }
 
-    void ClipboardMonitor::OnWindowDestroy()
+    // Timer message that arrives after the debounce or the staging delay
+    void ClipboardMonitor::OnTimerElapsed(HWND hWnd, UINT_PTR timerId)
     {
-        StopMonitoring();
+        if (timerId == STAGING_TIMER_ID)
+        {
+            OnCommitStagedCapture(hWnd);
+            return;
+        }
+
+        KillTimer(hWnd, timerId);
+        m_timerId = 0;
+
+        Metrics::Record(MetricId::Debounce, m_debounceStart, Metrics::Now());
+        HandleClipboardData(hWnd);
     }
 
+    void ClipboardMonitor::OnCommitStagedCapture(HWND hWnd)
+    {
+        if (m_stagingTimerId)
+        {
+            KillTimer(hWnd, m_stagingTimerId);
+            m_stagingTimerId = 0;
+        }
+
+        if (m_stagedCapture)
+        {
+            SaveCapture(std::move(m_stagedCapture));
+        }
+    }
 
-    bool ClipboardMonitor::SetClipboardData(winrt::Windows::Foundation::Collections::IMapView<ClipboardFormat, winrt::hstring> const& dataMap)
+    void ClipboardMonitor::StageCapture(HWND hWnd, std::unique_ptr<StagedCapture> capture)
     {
-        if (dataMap.Size() == 0 || !TryOpenClipboard())
+        ULONGLONG now = GetTickCount64();
+
+        if (m_stagedCapture)
+        {
+            // Replaced before anything of it reached the disk or the database
+            Metrics::Increment(CounterId::SupersededCaptures);
+            auto fileCount = std::count_if(m_stagedCapture->copiedDataMap.begin(), m_stagedCapture->copiedDataMap.end(), [](const auto& item)
+                {
+                    return FormatManager::GetRule(item.first)->saveToFileFunction != nullptr;
+                });
+            Metrics::Increment(CounterId::SkippedFileWrites, static_cast<uint64_t>(fileCount));
+        }
+        else
+        {
+            m_stagingStart = now;
+        }
+
+        m_stagedCapture = std::move(capture);
+
+        if (now - m_stagingStart >= MAX_STAGING_TIME)
+        {
+            OnCommitStagedCapture(hWnd);
+            return;
+        }
+
+        // Setting the timer again restarts the delay
+        m_stagingTimerId = SetTimer(hWnd, STAGING_TIMER_ID, STAGING_DELAY, nullptr);
+    }
+
+    bool ClipboardMonitor::SetClipboardData(winrt::Windows::Foundation::Collections::IMapView<ClipboardFormat, winrt::hstring> const& dataMap, TextTransform textTransform)
+    {
+        int64_t pasteStart = Metrics::Now();
+        bool isPrefetched = false;
+
+        // The listener window owns the clipboard content while the app pastes
+        HWND hWnd = m_listener ? m_listener->WindowHandle() : nullptr;
+        if (dataMap.Size() == 0 || !TryOpenClipboard(hWnd))
         {
             return false;
         }
@@ -146,19 +204,65 @@ namespace winrt::Rememory::Core::implementation
         {
             if (auto data = dataMap.TryLookup(format))
             {
-                rule.loadToClipboardFunction(rule.clipboardIds.front(), *data);
+                // Text is transformed on its way into the clipboard memory, other formats are loaded as they are
+                if (format == ClipboardFormat::Text && textTransform != TextTransform::None)
+                {
+                    TextTransformer::LoadToClipboard(rule.clipboardIds.front(), *data, textTransform);
+                }
+                else if (rule.saveToFileFunction && PasteCache::TryLoadToClipboard(format, std::wstring{ *data }))
+                {
+                    isPrefetched = true;
+                }
+                else
+                {
+                    rule.loadToClipboardFunction(rule.clipboardIds.front(), *data);
+                }
             }
         }
 
         m_isMyChanges = true;
-        return CloseClipboard();
+        bool isClosed = CloseClipboard();
+
+        Metrics::Record(isPrefetched ? MetricId::PrefetchedPaste : MetricId::Paste, pasteStart, Metrics::Now());
+        return isClosed;
     }
 
-    winrt::Windows::Foundation::IAsyncAction ClipboardMonitor::HandleClipboardData()
+    void ClipboardMonitor::SetPasteCandidates(winrt::Windows::Foundation::Collections::IVectorView<winrt::Windows::Foundation::Collections::IKeyValuePair<ClipboardFormat, winrt::hstring>> const& files)
     {
-        if (!TryOpenClipboard())
+        std::vector<std::pair<ClipboardFormat, std::wstring>> candidates;
+        candidates.reserve(files.Size());
+
+        for (const auto& file : files)
         {
-            co_return;
+            candidates.emplace_back(file.Key(), std::wstring{ file.Value() });
+        }
+
+        PasteCache::SetCandidates(std::move(candidates));
+    }
+
+    void ClipboardMonitor::AddToDuplicateIndex(int32_t clipId, ClipboardFormat format, winrt::Windows::Storage::Streams::IBuffer const& hash)
+    {
+        if (hash)
+        {
+            m_duplicateIndex.Add(clipId, format, hash.data(), hash.Length());
+        }
+    }
+
+    void ClipboardMonitor::RemoveFromDuplicateIndex(int32_t clipId)
+    {
+        m_duplicateIndex.Remove(clipId);
+    }
+
+    void ClipboardMonitor::ClearDuplicateIndex()
+    {
+        m_duplicateIndex.Clear();
+    }
+
+    void ClipboardMonitor::HandleClipboardData(HWND hWnd)
+    {
+        if (!TryOpenClipboard(hWnd))
+        {
+            return;
         }
 
         std::unordered_map<ClipboardFormat, std::unique_ptr<ClipboardData>> copiedDataMap;
@@ -186,41 +290,203 @@ namespace winrt::Rememory::Core::implementation
 
                 auto copiedData = std::make_unique<ClipboardData>();
 
-                if (!rule.copyFromClipboardFunction(hData, MaxDataSize(), copiedData.get()))
+                int64_t copyStart = Metrics::Now();
+                bool isCopied = rule.copyFromClipboardFunction(hData, MaxDataSize(), copiedData.get());
+                Metrics::Record(MetricId::CopyFormat, copyStart, Metrics::Now());
+
+                if (!isCopied)
                 {
                     continue;
                 }
 
+                Metrics::Increment(CounterId::CopiedBytes, copiedData->size);
+
                 copiedDataMap.insert_or_assign(format, std::move(copiedData));
                 break;   // stop after first successful candidate
             }
         }
 
+        // Raw pixels of an image capture, used for hashing and thumbnails.
+        // A PNG capture reads them from the bitmap format while the clipboard is still open.
+        std::unique_ptr<ClipboardData> pngPixels;
+        const ClipboardData* imagePixels = nullptr;
+
+        if (auto it = copiedDataMap.find(ClipboardFormat::Bitmap); it != copiedDataMap.end())
+        {
+            imagePixels = it->second.get();
+        }
+        else if (copiedDataMap.contains(ClipboardFormat::Png))
+        {
+            pngPixels = CopyBitmapPixels();
+            imagePixels = pngPixels.get();
+        }
+
         CloseClipboard();
 
         for (const auto& [_, copiedData] : copiedDataMap)
         {
-            copiedData->hash = ComputeSha256Hash(copiedData->data, copiedData->size);
+            Metrics::Scope scope{ MetricId::Hash };
+            copiedData->hash = ComputeSha256Hash(copiedData.get());
         }
 
         if (CompareClipboardHashes(copiedDataMap, m_previousClipboardDataHashes))
         {
-            co_return;
+            Metrics::Increment(CounterId::RepeatedCaptures);
+            return;
+        }
+
+        m_previousClipboardDataHashes.clear();
+        for (const auto& [format, copiedData] : copiedDataMap)
+        {
+            m_previousClipboardDataHashes.emplace(format, copiedData->hash);
+        }
+
+        // Nothing is written until the clipboard settles, a newer capture replaces this one
+        auto capture = std::make_unique<StagedCapture>();
+        capture->copiedDataMap = std::move(copiedDataMap);
+        capture->pngPixels = std::move(pngPixels);
+        capture->imagePixels = imagePixels;
+        capture->ownerPath = m_lastOwnerPath;
+        StageCapture(hWnd, std::move(capture));
+    }
+
+    winrt::Windows::Foundation::IAsyncAction ClipboardMonitor::FlushAsync()
+    {
+        std::shared_ptr<winrt::handle> lastSaveDone;
+        {
+            std::lock_guard lock(m_saveMutex);
+            lastSaveDone = m_lastSaveDone;
+        }
+
+        if (lastSaveDone)
+        {
+            co_await winrt::resume_on_signal(lastSaveDone->get());
+        }
+    }
+
+    bool ClipboardMonitor::Flush(uint32_t timeoutMs)
+    {
+        std::shared_ptr<winrt::handle> lastSaveDone;
+        {
+            std::lock_guard lock(m_saveMutex);
+            lastSaveDone = m_lastSaveDone;
+        }
+
+        if (!lastSaveDone)
+        {
+            return true;
+        }
+
+        // A save ends by raising ContentDetected on the event thread, which is usually this one, so it has to keep dispatching while it waits
+        HANDLE handles[] = { lastSaveDone->get() };
+        DWORD index = 0;
+        return SUCCEEDED(CoWaitForMultipleHandles(COWAIT_DISPATCH_CALLS | COWAIT_DISPATCH_WINDOW_MESSAGES, timeoutMs, 1, handles, &index));
+    }
+
+    void ClipboardMonitor::SaveCapture(std::unique_ptr<StagedCapture> capture)
+    {
+        auto done = std::make_shared<winrt::handle>(winrt::check_pointer(CreateEventW(nullptr, TRUE, FALSE, nullptr)));
+
+        std::shared_ptr<winrt::handle> previousDone;
+        {
+            std::lock_guard lock(m_saveMutex);
+            previousDone = std::exchange(m_lastSaveDone, done);
+        }
+
+        // Taken now, monitoring may be started again on another thread before the save gets to raise the event
+        SaveCaptureAfter(std::move(previousDone), std::move(done), std::move(capture), m_eventContext);
+    }
+
+    winrt::fire_and_forget ClipboardMonitor::SaveCaptureAfter(std::shared_ptr<winrt::handle> previousDone, std::shared_ptr<winrt::handle> done, std::unique_ptr<StagedCapture> capture, winrt::apartment_context eventContext)
+    {
+        // The monitor outlives every save, and the listener thread goes back to its messages right away
+        auto strongThis = get_strong();
+
+        if (previousDone)
+        {
+            co_await winrt::resume_on_signal(previousDone->get());
+        }
+        else
+        {
+            co_await winrt::resume_background();
+        }
+
+        // A failed save doesn't hold up the ones after it
+        try
+        {
+            co_await SaveCaptureAsync(std::move(capture), std::move(eventContext));
+        }
+        catch (...) {}
+
+        SetEvent(done->get());
+    }
+
+    winrt::Windows::Foundation::IAsyncAction ClipboardMonitor::SaveCaptureAsync(std::unique_ptr<StagedCapture> capture, winrt::apartment_context eventContext)
+    {
+        const auto& copiedDataMap = capture->copiedDataMap;
+        const ClipboardData* imagePixels = capture->imagePixels;
+
+        std::optional<uint64_t> imageHash;
+        if (imagePixels && IsSimilarImageDetectionEnabled())
+        {
+            imageHash = ComputeImageHash(imagePixels);
         }
 
         auto historyFolderPath = std::filesystem::path{ HistoryFolderPath().c_str() };
         auto records = winrt::single_threaded_vector<Rememory::Core::FormatRecord>();
 
-        m_previousClipboardDataHashes.clear();
+        std::unordered_map<ClipboardFormat, std::vector<BYTE>> currentHashes;
+        for (const auto& [format, copiedData] : copiedDataMap)
+        {
+            currentHashes.emplace(format, copiedData->hash);
+        }
+        int32_t existingClipId = m_duplicateIndex.Find(currentHashes);
+        int32_t similarClipId = 0;
+
+        if (imageHash)
+        {
+            // A near-identical image is still a new capture, it replaces the older clip instead of collapsing into it
+            if (existingClipId == 0)
+            {
+                similarClipId = m_duplicateIndex.FindSimilarImage(*imageHash, SimilarImageThreshold());
+            }
+
+            // An exact repeat resolves to the clip that is already known
+            if (existingClipId == 0)
+            {
+                ClipboardFormat imageFormat = copiedDataMap.contains(ClipboardFormat::Png) ? ClipboardFormat::Png : ClipboardFormat::Bitmap;
+                m_duplicateIndex.AddRecentImage(*imageHash, imageFormat, currentHashes[imageFormat]);
+            }
+        }
 
         for (const auto& [format, copiedData] : copiedDataMap)
         {
             auto formatRule = FormatManager::GetRule(format);
             winrt::hstring dataStr;
+            winrt::hstring plainText;
+
+            // Rich formats get a plain-text copy for search, unless the clipboard already offers one
+            if (formatRule->extractTextFunction && !copiedDataMap.contains(ClipboardFormat::Text))
+            {
+                plainText = formatRule->extractTextFunction(copiedData.get());
+            }
 
             if (formatRule->saveToFileFunction)
             {
+                int64_t saveStart = Metrics::Now();
                 dataStr = co_await formatRule->saveToFileFunction(historyFolderPath, format, copiedData.get());
+                Metrics::Record(MetricId::SaveToFile, saveStart, Metrics::Now());
+
+                // Duplicates are dropped by the app, so only new images get thumbnails
+                bool isImage = format == ClipboardFormat::Png || format == ClipboardFormat::Bitmap;
+                if (isImage && imagePixels && existingClipId == 0 && !dataStr.empty())
+                {
+                    co_await Thumbnail::SaveThumbnailsAsync(std::filesystem::path{ dataStr.c_str() }, imagePixels);
+                }
+            }
+            else if (!copiedData->text.empty())
+            {
+                dataStr = std::move(copiedData->text);
             }
             else if (copiedData->data && copiedData->size > 0)
             {
@@ -242,45 +508,138 @@ namespace winrt::Rememory::Core::implementation
                 record.Format(format);
                 record.Data(std::move(dataStr));
                 record.Hash(std::move(hashBuffer));
+                record.PlainText(std::move(plainText));
+
+                if (format == ClipboardFormat::Text)
+                {
+                    record.Content(ContentClassifier::Classify(record.Data()));
+                }
+
+                // Duplicates keep the metadata of the existing clip
+                if (format == ClipboardFormat::Files && existingClipId == 0)
+                {
+                    record.FilesInfo(co_await FormatManager::ScanFilesAsync(record.Data(), FILES_SCAN_TIME_BUDGET));
+                }
+
                 records.Append(std::move(record));
             }
-
-            m_previousClipboardDataHashes[format] = std::move(copiedData->hash);
         }
 
         auto snapshot = winrt::make<implementation::ClipboardSnapshot>();
         snapshot.Records(std::move(records));
+        snapshot.ExistingClipId(existingClipId);
+        snapshot.SimilarClipId(similarClipId);
 
-        if (!m_lastOwnerPath.empty())
+        if (!capture->ownerPath.empty())
         {
-            snapshot.OwnerPath(m_lastOwnerPath);
+            snapshot.OwnerPath(capture->ownerPath);
 
-            auto ownerIcon = ProcessInfo::GetProcessIcon(m_lastOwnerPath);
+            auto ownerIcon = ProcessInfo::GetProcessIcon(capture->ownerPath);
             if (ownerIcon != nullptr && ownerIcon.Length() > 0)
             {
                 snapshot.OwnerIcon(ownerIcon);
             }
         }
 
+        Metrics::Increment(CounterId::Captures);
+
+        // Handlers run on the thread that started monitoring
+        co_await eventContext;
+
+        Metrics::Scope scope{ MetricId::Dispatch };
         RaiseContentDetected(std::move(snapshot));
     }
 
-    bool ClipboardMonitor::TryOpenClipboard()
+    std::unique_ptr<ClipboardData> ClipboardMonitor::CopyBitmapPixels()
+    {
+        if (!IsClipboardFormatAvailable(CF_BITMAP))
+        {
+            return nullptr;
+        }
+
+        HANDLE hData = GetClipboardData(CF_BITMAP);
+        auto bitmapData = std::make_unique<ClipboardData>();
+
+        if (!hData || !FormatManager::GetRule(ClipboardFormat::Bitmap)->copyFromClipboardFunction(hData, MaxDataSize(), bitmapData.get()))
+        {
+            return nullptr;
+        }
+
+        return bitmapData;
+    }
+
+    std::filesystem::path ClipboardMonitor::GetLocalDataFolderPath()
+    {
+        UINT32 length = 0;
+        if (GetCurrentPackageFullName(&length, nullptr) != APPMODEL_ERROR_NO_PACKAGE)
+        {
+            return std::filesystem::path{ winrt::Microsoft::Windows::Storage::ApplicationData::GetDefault().LocalPath().c_str() };
+        }
+
+        // Without package identity, e.g. in the benchmarks, the data goes to a folder of its own
+        PWSTR localAppDataPath = nullptr;
+        winrt::check_hresult(SHGetKnownFolderPath(FOLDERID_LocalAppData, KF_FLAG_CREATE, nullptr, &localAppDataPath));
+        std::filesystem::path path{ localAppDataPath };
+        CoTaskMemFree(localAppDataPath);
+
+        return path / L"Rememory";
+    }
+
+    std::optional<uint64_t> ClipboardMonitor::ComputeImageHash(const ClipboardData* bitmapData)
+    {
+        Metrics::Scope scope{ MetricId::ImageHash };
+
+        if (!bitmapData->data || !bitmapData->header)
+        {
+            return std::nullopt;
+        }
+
+        auto* pBitmapHeader = static_cast<const BITMAPINFOHEADER*>(bitmapData->header);
+        if (pBitmapHeader->biWidth <= 0 || pBitmapHeader->biHeight == 0)
+        {
+            return std::nullopt;
+        }
+
+        uint32_t width = static_cast<uint32_t>(pBitmapHeader->biWidth);
+        uint32_t height = static_cast<uint32_t>(abs(pBitmapHeader->biHeight));
+        size_t stride = static_cast<size_t>(width) * 4;   // GetBitmapDataCopy stores top-down 32bpp rows
+
+        if (bitmapData->size < stride * height)
+        {
+            return std::nullopt;
+        }
+
+        return ImageHash::ComputeDHash(static_cast<const BYTE*>(bitmapData->data), width, height, stride);
+    }
+
+    bool ClipboardMonitor::TryOpenClipboard(HWND hWnd)
     {
+        Metrics::Scope scope{ MetricId::OpenClipboard };
+
         for (int i = 0; i < OPEN_CLIPBOARD_ATTEMPTS; i++)
         {
-            if (OpenClipboard(m_hWnd))
+            if (OpenClipboard(hWnd))
             {
                 return true;
             }
+            Metrics::Increment(CounterId::OpenClipboardRetries);
             Sleep(OPEN_CLIPBOARD_DELAY);
         }
+
+        Metrics::Increment(CounterId::OpenClipboardFailures);
         return false;
     }
 
-    std::vector<BYTE> ClipboardMonitor::ComputeSha256Hash(LPVOID data, size_t dataLength)
+    std::vector<BYTE> ClipboardMonitor::ComputeSha256Hash(const ClipboardData* clipboardData)
     {
-        if (data == nullptr || dataLength == 0)
+        std::span<const BYTE> parts[]
+        {
+            { static_cast<const BYTE*>(clipboardData->data), clipboardData->data ? clipboardData->size : 0 },
+            { reinterpret_cast<const BYTE*>(clipboardData->text.data()), clipboardData->text.size() * sizeof(wchar_t) },
+            { clipboardData->textTail.data(), clipboardData->textTail.size() }
+        };
+
+        if (std::all_of(std::begin(parts), std::end(parts), [](const auto& part) { return part.empty(); }))
         {
             return {};
         }
@@ -299,11 +658,14 @@ namespace winrt::Rememory::Core::implementation
             return {};
         }
 
-        if (!CryptHashData(hHash, static_cast<LPBYTE>(data), dataLength, 0))
+        for (const auto& part : parts)
         {
-            CryptDestroyHash(hHash);
-            CryptReleaseContext(hProv, 0);
-            return {};
+            if (!part.empty() && !CryptHashData(hHash, part.data(), static_cast<DWORD>(part.size()), 0))
+            {
+                CryptDestroyHash(hHash);
+                CryptReleaseContext(hProv, 0);
+                return {};
+            }
         }
 
         DWORD hashLen = 0;
@@ -1,7 +1,13 @@
 #pragma once
 #include "pch.h"
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include "ClipboardMonitor.g.h"
-#include "WindowMessageHook.h"
+#include "ClipboardListener.h"
+#include "DuplicateIndex.h"
+#include "BlobCipher.h"
 
 namespace winrt::Rememory::Core::implementation
 {
@@ -12,6 +18,9 @@ namespace winrt::Rememory::Core::implementation
         size_t size = 0;
         std::vector<BYTE> hash;
 
+        winrt::hstring text;            // Unicode text, copied straight into a string buffer without its terminators
+        std::vector<BYTE> textTail;     // Rest of the clipboard block after the text, so the hash still covers the whole block
+
         ClipboardData(const ClipboardData&) = delete;
         ClipboardData& operator=(const ClipboardData&) = delete;
 
@@ -30,6 +39,15 @@ namespace winrt::Rememory::Core::implementation
         }
     };
 
+    // Copied and hashed capture that waits for the clipboard to settle before anything of it is saved
+    struct StagedCapture
+    {
+        std::unordered_map<ClipboardFormat, std::unique_ptr<ClipboardData>> copiedDataMap;
+        std::unique_ptr<ClipboardData> pngPixels;
+        const ClipboardData* imagePixels = nullptr;   // Raw pixels of an image, owned by copiedDataMap or pngPixels
+        winrt::hstring ownerPath;
+    };
+
     struct ClipboardMonitor : ClipboardMonitorT<ClipboardMonitor>
     {
         ClipboardMonitor();
@@ -44,22 +62,60 @@ namespace winrt::Rememory::Core::implementation
             m_historyFolderPath = value;
         }
 
+        // Settings are read by the listener thread while the app may change them
         size_t MaxDataSize() const
         {
-            return m_maxDataSize;
+            return m_maxDataSize.load(std::memory_order_relaxed);
         }
         void MaxDataSize(size_t const& value)
         {
-            m_maxDataSize = value;
+            m_maxDataSize.store(value, std::memory_order_relaxed);
         }
 
-        void StartMonitoring(UINT_PTR windowHandle);
-        void StopMonitoring();
-        bool SetClipboardData(winrt::Windows::Foundation::Collections::IMapView<ClipboardFormat, winrt::hstring> const& dataMap);
+        bool IsSimilarImageDetectionEnabled() const
+        {
+            return m_isSimilarImageDetectionEnabled.load(std::memory_order_relaxed);
+        }
+        void IsSimilarImageDetectionEnabled(bool value)
+        {
+            m_isSimilarImageDetectionEnabled.store(value, std::memory_order_relaxed);
+        }
+
+        int32_t SimilarImageThreshold() const
+        {
+            return m_similarImageThreshold.load(std::memory_order_relaxed);
+        }
+        void SimilarImageThreshold(int32_t value)
+        {
+            m_similarImageThreshold.store(value, std::memory_order_relaxed);
+        }
 
-        void OnClipboardUpdate();
-        void OnWindowDestroy();
-        winrt::Windows::Foundation::IAsyncAction HandleClipboardData();
+        bool IsHistoryEncryptionEnabled() const
+        {
+            return BlobCipher::IsEnabled();
+        }
+        void IsHistoryEncryptionEnabled(bool value)
+        {
+            BlobCipher::SetEnabled(value);
+        }
+
+        void StartMonitoring();
+        void StopMonitoring();
+        void CommitStagedCapture();
+        winrt::Windows::Foundation::IAsyncAction FlushAsync();
+        bool Flush(uint32_t timeoutMs);
+        bool SetClipboardData(winrt::Windows::Foundation::Collections::IMapView<ClipboardFormat, winrt::hstring> const& dataMap, TextTransform textTransform);
+        void SetPasteCandidates(winrt::Windows::Foundation::Collections::IVectorView<winrt::Windows::Foundation::Collections::IKeyValuePair<ClipboardFormat, winrt::hstring>> const& files);
+
+        void AddToDuplicateIndex(int32_t clipId, ClipboardFormat format, winrt::Windows::Storage::Streams::IBuffer const& hash);
+        void RemoveFromDuplicateIndex(int32_t clipId);
+        void ClearDuplicateIndex();
+
+        // Called on the listener thread
+        void OnClipboardUpdate(HWND hWnd);
+        void OnTimerElapsed(HWND hWnd, UINT_PTR timerId);
+        void OnCommitStagedCapture(HWND hWnd);
+        void HandleClipboardData(HWND hWnd);
 
         winrt::event_token ContentDetected(winrt::Windows::Foundation::TypedEventHandler<Rememory::Core::ClipboardMonitor, Rememory::Core::ClipboardSnapshot> const& handler)
         {
@@ -72,23 +128,41 @@ namespace winrt::Rememory::Core::implementation
         }
 
     private:
-        HWND m_hWnd = nullptr;
         DWORD m_oldClipboardSequenceNumber = 0;
         UINT_PTR m_timerId = 0;
+        int64_t m_debounceStart = 0;
+        UINT_PTR m_stagingTimerId = 0;
+        ULONGLONG m_stagingStart = 0;   // When the staged capture or the ones it replaced were first staged
+        std::unique_ptr<StagedCapture> m_stagedCapture = nullptr;
+        std::mutex m_saveMutex;
+        std::shared_ptr<winrt::handle> m_lastSaveDone;   // Set once the most recent save raised ContentDetected, guarded by m_saveMutex
         ULONG_PTR m_gdiplusToken = 0;
         std::atomic<bool> m_isMyChanges = false;
-        std::unique_ptr<WindowMessageHook> m_message_hook = nullptr;
+        std::unique_ptr<ClipboardListener> m_listener = nullptr;
+        winrt::apartment_context m_eventContext{};   // Thread that started monitoring, ContentDetected is raised there
         std::unordered_map<ClipboardFormat, std::vector<BYTE>> m_previousClipboardDataHashes{};
+        DuplicateIndex m_duplicateIndex{};
         winrt::hstring m_lastOwnerPath{};
         winrt::hstring m_historyFolderPath{};
-        size_t m_maxDataSize = (size_t)-1;
+        std::atomic<size_t> m_maxDataSize = (size_t)-1;
+        std::atomic<bool> m_isSimilarImageDetectionEnabled = false;
+        std::atomic<int32_t> m_similarImageThreshold = 0;
         winrt::event<winrt::Windows::Foundation::TypedEventHandler<Rememory::Core::ClipboardMonitor, Rememory::Core::ClipboardSnapshot>> m_contentDetectedEvent;
 
-        static void CALLBACK MonitorTimerProc(HWND hWnd, UINT uMsg, UINT_PTR idEvent, DWORD dwTime);
         static bool CompareClipboardHashes(const std::unordered_map<ClipboardFormat, std::unique_ptr<ClipboardData>>& copiedDataMap, const std::unordered_map<ClipboardFormat, std::vector<BYTE>>& previousHashesMap);
 
-        std::vector<BYTE> ComputeSha256Hash(LPVOID data, size_t dataLength);
-        bool TryOpenClipboard();
+        std::vector<BYTE> ComputeSha256Hash(const ClipboardData* clipboardData);
+        std::unique_ptr<ClipboardData> CopyBitmapPixels();
+        static std::filesystem::path GetLocalDataFolderPath();
+        static std::optional<uint64_t> ComputeImageHash(const ClipboardData* bitmapData);
+        static bool TryOpenClipboard(HWND hWnd);
+
+        void StageCapture(HWND hWnd, std::unique_ptr<StagedCapture> capture);
+
+        // Saves run one after another, so ContentDetected keeps the order of the copies
+        void SaveCapture(std::unique_ptr<StagedCapture> capture);
+        winrt::fire_and_forget SaveCaptureAfter(std::shared_ptr<winrt::handle> previousDone, std::shared_ptr<winrt::handle> done, std::unique_ptr<StagedCapture> capture, winrt::apartment_context eventContext);
+        winrt::Windows::Foundation::IAsyncAction SaveCaptureAsync(std::unique_ptr<StagedCapture> capture, winrt::apartment_context eventContext);
 
         void RaiseContentDetected(Rememory::Core::ClipboardSnapshot const& snapshot)
         {
@@ -17,10 +17,18 @@ namespace winrt::Rememory::Core::implementation
         winrt::Windows::Foundation::Collections::IVector<Rememory::Core::FormatRecord> Records() const { return m_records; }
         void Records(winrt::Windows::Foundation::Collections::IVector<Rememory::Core::FormatRecord> const& value) { m_records = value; }
 
+        int32_t ExistingClipId() const { return m_existingClipId; }
+        void ExistingClipId(int32_t value) { m_existingClipId = value; }
+
+        int32_t SimilarClipId() const { return m_similarClipId; }
+        void SimilarClipId(int32_t value) { m_similarClipId = value; }
+
     private:
         winrt::hstring m_ownerPath{};
         winrt::Windows::Storage::Streams::IBuffer m_ownerIcon{ nullptr };
         winrt::Windows::Foundation::Collections::IVector<Rememory::Core::FormatRecord> m_records{ nullptr };
+        int32_t m_existingClipId = 0;
+        int32_t m_similarClipId = 0;
     };
 }
 
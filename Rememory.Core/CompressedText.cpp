@@ -0,0 +1,199 @@
+#include "pch.h"
+#include "CompressedText.h"
+#include "CompressedText.g.cpp"
+#include "FuzzyMatcher.h"
+#include "Metrics.h"
+#include <compressapi.h>
+
+#pragma comment(lib, "cabinet.lib")
+
+namespace {
+    constexpr uint32_t MIN_LENGTH = 512;           // Shorter texts barely shrink and the handle outweighs the saving
+    constexpr size_t MAX_COMPRESSED_PERCENT = 75;
+
+    // Compression API handles are not thread-safe, each thread keeps its own
+    struct CompressorHandle
+    {
+        COMPRESSOR_HANDLE handle = nullptr;
+        ~CompressorHandle() { if (handle) CloseCompressor(handle); }
+    };
+
+    struct DecompressorHandle
+    {
+        DECOMPRESSOR_HANDLE handle = nullptr;
+        ~DecompressorHandle() { if (handle) CloseDecompressor(handle); }
+    };
+
+    COMPRESSOR_HANDLE GetCompressor()
+    {
+        thread_local CompressorHandle compressor;
+        if (!compressor.handle)
+        {
+            CreateCompressor(COMPRESS_ALGORITHM_XPRESS, nullptr, &compressor.handle);
+        }
+        return compressor.handle;
+    }
+
+    DECOMPRESSOR_HANDLE GetDecompressor()
+    {
+        thread_local DecompressorHandle decompressor;
+        if (!decompressor.handle)
+        {
+            CreateDecompressor(COMPRESS_ALGORITHM_XPRESS, nullptr, &decompressor.handle);
+        }
+        return decompressor.handle;
+    }
+}
+
+namespace winrt::Rememory::Core::implementation
+{
+    CompressedText::CompressedText(std::vector<BYTE>&& data, uint32_t length, uint64_t characterMask)
+        : m_data(std::move(data)), m_length(length), m_characterMask(characterMask)
+    {
+        Metrics::Add(GaugeId::CompressedTexts, 1);
+        Metrics::Add(GaugeId::CompressedTextBytes, static_cast<int64_t>(m_data.size()));
+        Metrics::Add(GaugeId::CompressedTextSavedBytes, GetSavedBytes());
+    }
+
+    std::mutex CompressedText::s_cacheMutex;
+    size_t CompressedText::s_cacheSize = 0;
+    std::list<const CompressedText*> CompressedText::s_cacheOrder;
+
+    CompressedText::~CompressedText()
+    {
+        {
+            std::lock_guard lock(s_cacheMutex);
+            if (!m_cachedText.empty())
+            {
+                RemoveFromCache();
+            }
+        }
+
+        Metrics::Add(GaugeId::CompressedTexts, -1);
+        Metrics::Add(GaugeId::CompressedTextBytes, -static_cast<int64_t>(m_data.size()));
+        Metrics::Add(GaugeId::CompressedTextSavedBytes, -GetSavedBytes());
+    }
+
+    Rememory::Core::CompressedText CompressedText::TryCompress(winrt::hstring const& text)
+    {
+        if (text.size() < MIN_LENGTH)
+        {
+            return nullptr;
+        }
+
+        Metrics::Scope scope{ MetricId::CompressText };
+
+        COMPRESSOR_HANDLE compressor = GetCompressor();
+        if (!compressor)
+        {
+            return nullptr;
+        }
+
+        // Anything that doesn't fit the limit isn't worth keeping compressed
+        size_t textSize = text.size() * sizeof(wchar_t);
+        std::vector<BYTE> data(textSize * MAX_COMPRESSED_PERCENT / 100);
+        SIZE_T compressedSize = 0;
+
+        if (!Compress(compressor, text.data(), textSize, data.data(), data.size(), &compressedSize))
+        {
+            return nullptr;
+        }
+
+        data.resize(compressedSize);
+        data.shrink_to_fit();
+        return winrt::make<CompressedText>(std::move(data), static_cast<uint32_t>(text.size()), FuzzyScorer::GetCharacterMask(text));
+    }
+
+    winrt::hstring CompressedText::Decompress() const
+    {
+        {
+            std::lock_guard lock(s_cacheMutex);
+            if (!m_cachedText.empty())
+            {
+                s_cacheOrder.splice(s_cacheOrder.begin(), s_cacheOrder, m_cachePosition);
+                return m_cachedText;
+            }
+        }
+
+        auto text = DecompressData();
+        AddToCache(text);
+        return text;
+    }
+
+    bool CompressedText::CanMatch(Rememory::Core::FuzzyMatcher const& matcher) const
+    {
+        return winrt::get_self<FuzzyMatcher>(matcher)->CanMatch(m_characterMask, m_length);
+    }
+
+    winrt::hstring CompressedText::DecompressData() const
+    {
+        Metrics::Scope scope{ MetricId::DecompressText };
+
+        DECOMPRESSOR_HANDLE decompressor = GetDecompressor();
+        if (!decompressor)
+        {
+            throw winrt::hresult_error(E_OUTOFMEMORY, L"The text couldn't be decompressed");
+        }
+
+        // Decompressed straight into the buffer of the returned string
+        PWSTR textBuffer = nullptr;
+        HSTRING_BUFFER hBuffer = nullptr;
+        winrt::check_hresult(WindowsPreallocateStringBuffer(m_length, &textBuffer, &hBuffer));
+
+        size_t textSize = static_cast<size_t>(m_length) * sizeof(wchar_t);
+        SIZE_T decompressedSize = 0;
+        HSTRING hString = nullptr;
+
+        if (!::Decompress(decompressor, m_data.data(), m_data.size(), textBuffer, textSize, &decompressedSize)
+            || decompressedSize != textSize
+            || FAILED(WindowsPromoteStringBuffer(hBuffer, &hString)))
+        {
+            WindowsDeleteStringBuffer(hBuffer);
+            throw winrt::hresult_error(E_FAIL, L"The text couldn't be decompressed");
+        }
+
+        winrt::hstring text;
+        winrt::attach_abi(text, hString);
+        return text;
+    }
+
+    void CompressedText::AddToCache(winrt::hstring const& text) const
+    {
+        size_t size = text.size() * sizeof(wchar_t);
+        if (size > CACHE_BUDGET)
+        {
+            return;
+        }
+
+        std::lock_guard lock(s_cacheMutex);
+        // Another thread may have cached it meanwhile
+        if (!m_cachedText.empty())
+        {
+            return;
+        }
+
+        while (s_cacheSize + size > CACHE_BUDGET)
+        {
+            s_cacheOrder.back()->RemoveFromCache();
+        }
+
+        m_cachedText = text;
+        m_cachePosition = s_cacheOrder.insert(s_cacheOrder.begin(), this);
+        s_cacheSize += size;
+        Metrics::Add(GaugeId::DecompressedTextCacheBytes, static_cast<int64_t>(size));
+    }
+
+    void CompressedText::RemoveFromCache() const
+    {
+        size_t size = m_cachedText.size() * sizeof(wchar_t);
+        s_cacheOrder.erase(m_cachePosition);
+        m_cachedText = {};
+        s_cacheSize -= size;
+        Metrics::Add(GaugeId::DecompressedTextCacheBytes, -static_cast<int64_t>(size));
+    }
+
+    int64_t CompressedText::GetSavedBytes() const
+    {
+        return static_cast<int64_t>(m_length) * sizeof(wchar_t) - static_cast<int64_t>(m_data.size());
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "pch.h"
+#include "CompressedText.g.h"
+#include <list>
+#include <mutex>
+#include <vector>
+
+namespace winrt::Rememory::Core::implementation
+{
+    // XPRESS through the Windows compression API, which favors speed over ratio.
+    // The most recently read texts are kept decompressed up to CACHE_BUDGET in total, the least recently read are evicted first.
+    // Search checks the character mask taken at compression first, so texts that can't match are never decompressed.
+    struct CompressedText : CompressedTextT<CompressedText>
+    {
+        CompressedText(std::vector<BYTE>&& data, uint32_t length, uint64_t characterMask);
+        ~CompressedText();
+
+        static Rememory::Core::CompressedText TryCompress(winrt::hstring const& text);
+
+        // Returns the cached text if there is one
+        winrt::hstring Decompress() const;
+        bool CanMatch(Rememory::Core::FuzzyMatcher const& matcher) const;
+        uint32_t Length() const { return m_length; }
+        uint32_t CompressedSize() const { return static_cast<uint32_t>(m_data.size()); }
+
+    private:
+        static constexpr size_t CACHE_BUDGET = 16 * 1024 * 1024;   // Bytes of decompressed text across all instances
+
+        static std::mutex s_cacheMutex;
+        static size_t s_cacheSize;
+        static std::list<const CompressedText*> s_cacheOrder;   // Most recently read first
+
+        std::vector<BYTE> m_data;
+        uint32_t m_length;
+        uint64_t m_characterMask;
+
+        // Guarded by s_cacheMutex, the position is valid while the text is cached
+        mutable winrt::hstring m_cachedText;
+        mutable std::list<const CompressedText*>::iterator m_cachePosition;
+
+        winrt::hstring DecompressData() const;
+        void AddToCache(winrt::hstring const& text) const;
+        void RemoveFromCache() const;   // With s_cacheMutex held
+
+        int64_t GetSavedBytes() const;
+    };
+}
+
+namespace winrt::Rememory::Core::factory_implementation
+{
+    struct CompressedText : CompressedTextT<CompressedText, implementation::CompressedText> {};
+}
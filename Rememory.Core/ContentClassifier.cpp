@@ -0,0 +1,347 @@
+#include "pch.h"
+#include <algorithm>
+#include "ContentClassifier.h"
+
+namespace winrt::Rememory::Core::implementation
+{
+    TextContent ContentClassifier::Classify(std::wstring_view text)
+    {
+        std::wstring_view token = Trim(text);
+        if (token.empty())
+        {
+            return TextContent::None;
+        }
+
+        TextContent content = TextContent::None;
+
+        if (token.size() <= MAX_COLOR_LENGTH)
+        {
+            content |= ClassifyHexColor(token);
+
+            if (IsFunctionalColor(token))
+            {
+                content |= TextContent::Color;
+            }
+        }
+
+        if (IsLink(token))
+        {
+            content |= TextContent::Link;
+        }
+        else if (IsEmail(token))
+        {
+            content |= TextContent::Email;
+        }
+        else if (IsFilePath(token))
+        {
+            content |= TextContent::FilePath;
+        }
+
+        return content;
+    }
+
+    bool ContentClassifier::Cursor::Skip(wchar_t c)
+    {
+        if (Peek() != c)
+        {
+            return false;
+        }
+
+        m_position++;
+        return true;
+    }
+
+    bool ContentClassifier::Cursor::SkipIgnoreCase(std::wstring_view word)
+    {
+        if (m_text.size() - m_position < word.size())
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < word.size(); i++)
+        {
+            wchar_t c = m_text[m_position + i];
+            wchar_t lower = (c >= L'A' && c <= L'Z') ? static_cast<wchar_t>(c + (L'a' - L'A')) : c;
+
+            if (lower != word[i])
+            {
+                return false;
+            }
+        }
+
+        m_position += word.size();
+        return true;
+    }
+
+    void ContentClassifier::Cursor::SkipSpaces()
+    {
+        while (!AtEnd() && IsSpace(Peek()))
+        {
+            m_position++;
+        }
+    }
+
+    size_t ContentClassifier::Cursor::SkipDigits()
+    {
+        size_t start = m_position;
+        while (!AtEnd() && IsAsciiDigit(Peek()))
+        {
+            m_position++;
+        }
+        return m_position - start;
+    }
+
+    void ContentClassifier::Cursor::Reset(size_t position)
+    {
+        m_position = position;
+    }
+
+    bool ContentClassifier::IsSpace(wchar_t c)
+    {
+        if (c < 0x80)
+        {
+            return c == L' ' || (c >= L'\t' && c <= L'\r');
+        }
+
+        WORD type = 0;
+        return GetStringTypeW(CT_CTYPE1, &c, 1, &type) && (type & C1_SPACE);
+    }
+
+    std::wstring_view ContentClassifier::Trim(std::wstring_view text)
+    {
+        size_t start = 0;
+        size_t end = text.size();
+
+        while (start < end && IsSpace(text[start]))
+        {
+            start++;
+        }
+
+        while (end > start && IsSpace(text[end - 1]))
+        {
+            end--;
+        }
+
+        return text.substr(start, end - start);
+    }
+
+    TextContent ContentClassifier::ClassifyHexColor(std::wstring_view text)
+    {
+        // #RGB, #RGBA, #RRGGBB or #RRGGBBAA, the prefix is optional depending on the app settings
+        bool hasPrefix = text.front() == L'#';
+        std::wstring_view digits = hasPrefix ? text.substr(1) : text;
+
+        bool isValidLength = digits.size() == 3 || digits.size() == 4 || digits.size() == 6 || digits.size() == 8;
+        if (!isValidLength || !std::all_of(digits.begin(), digits.end(), IsHexDigit))
+        {
+            return TextContent::None;
+        }
+
+        return hasPrefix ? TextContent::Color : TextContent::UnprefixedColor;
+    }
+
+    bool ContentClassifier::IsFunctionalColor(std::wstring_view text)
+    {
+        // rgb(r, g, b), rgba(r g b / a), hsl(h, s%, l%) or hsla(h s% l% / a), with the separators CSS allows
+        Cursor cursor{ text };
+
+        bool isHsl = false;
+        if (cursor.SkipIgnoreCase(L"hsl"))
+        {
+            isHsl = true;
+        }
+        else if (!cursor.SkipIgnoreCase(L"rgb"))
+        {
+            return false;
+        }
+
+        cursor.SkipIgnoreCase(L"a");
+        if (!cursor.Skip(L'('))
+        {
+            return false;
+        }
+
+        cursor.SkipSpaces();
+
+        for (int channel = 0; channel < 3; channel++)
+        {
+            if (channel > 0 && !ReadSeparator(cursor))
+            {
+                return false;
+            }
+
+            if (!ReadNumber(cursor, !isHsl))
+            {
+                return false;
+            }
+
+            if (isHsl && channel == 0)
+            {
+                // The hue unit is optional
+                if (!cursor.SkipIgnoreCase(L"deg") && !cursor.SkipIgnoreCase(L"rad"))
+                {
+                    cursor.SkipIgnoreCase(L"turn");
+                }
+            }
+            else if (isHsl && !cursor.Skip(L'%'))
+            {
+                return false;
+            }
+        }
+
+        // Optional alpha channel
+        size_t alphaStart = cursor.Position();
+        if (!ReadAlphaSeparator(cursor) || !ReadNumber(cursor, true))
+        {
+            cursor.Reset(alphaStart);
+        }
+
+        cursor.SkipSpaces();
+        return cursor.Skip(L')') && cursor.AtEnd();
+    }
+
+    bool ContentClassifier::ReadNumber(Cursor& cursor, bool allowPercent)
+    {
+        if (cursor.SkipDigits() == 0)
+        {
+            return false;
+        }
+
+        size_t fractionStart = cursor.Position();
+        if (cursor.Skip(L'.') && cursor.SkipDigits() == 0)
+        {
+            cursor.Reset(fractionStart);
+        }
+
+        if (allowPercent)
+        {
+            cursor.Skip(L'%');
+        }
+
+        return true;
+    }
+
+    bool ContentClassifier::ReadSeparator(Cursor& cursor)
+    {
+        // Any run of spaces and commas
+        size_t start = cursor.Position();
+        while (!cursor.AtEnd() && (IsSpace(cursor.Peek()) || cursor.Peek() == L','))
+        {
+            cursor.Skip(cursor.Peek());
+        }
+        return cursor.Position() > start;
+    }
+
+    bool ContentClassifier::ReadAlphaSeparator(Cursor& cursor)
+    {
+        // Spaces with at most one comma or slash among them
+        size_t start = cursor.Position();
+        bool hasDelimiter = false;
+
+        while (!cursor.AtEnd())
+        {
+            wchar_t c = cursor.Peek();
+            if (!hasDelimiter && (c == L',' || c == L'/'))
+            {
+                hasDelimiter = true;
+            }
+            else if (!IsSpace(c))
+            {
+                break;
+            }
+            cursor.Skip(c);
+        }
+
+        return cursor.Position() > start;
+    }
+
+    bool ContentClassifier::IsLink(std::wstring_view text)
+    {
+        Cursor cursor{ text };
+        if (!cursor.SkipIgnoreCase(L"http://") && !cursor.SkipIgnoreCase(L"https://"))
+        {
+            return false;
+        }
+
+        // The host must not be empty, the shape is all that is checked here
+        wchar_t hostStart = cursor.Peek();
+        if (cursor.AtEnd() || hostStart == L'/' || hostStart == L'?' || hostStart == L'#')
+        {
+            return false;
+        }
+
+        return std::none_of(text.begin() + cursor.Position(), text.end(), [](wchar_t c)
+            {
+                return c <= L' ' || c == 0x7F || c == L'<' || c == L'>' || c == L'"' || IsSpace(c);
+            });
+    }
+
+    bool ContentClassifier::IsEmail(std::wstring_view text)
+    {
+        size_t at = 0;
+        while (at < text.size() && text[at] != L'@')
+        {
+            wchar_t c = text[at];
+            bool isLocalChar = IsAsciiLetter(c) || IsAsciiDigit(c) || c == L'.' || c == L'_' || c == L'%' || c == L'+' || c == L'-';
+            if (!isLocalChar)
+            {
+                return false;
+            }
+            at++;
+        }
+
+        if (at == 0 || at == text.size())
+        {
+            return false;
+        }
+
+        // Domain labels separated by single dots, ending with a top-level domain of at least two letters
+        std::wstring_view domain = text.substr(at + 1);
+        size_t labelCount = 0;
+        size_t labelStart = 0;
+
+        for (size_t i = 0; i <= domain.size(); i++)
+        {
+            if (i == domain.size() || domain[i] == L'.')
+            {
+                if (i == labelStart)
+                {
+                    return false;
+                }
+
+                labelCount++;
+                labelStart = i + 1;
+            }
+            else if (!IsAsciiLetter(domain[i]) && !IsAsciiDigit(domain[i]) && domain[i] != L'-')
+            {
+                return false;
+            }
+        }
+
+        std::wstring_view topLevelDomain = domain.substr(domain.rfind(L'.') + 1);
+        return labelCount >= 2 && topLevelDomain.size() >= 2 && std::all_of(topLevelDomain.begin(), topLevelDomain.end(), IsAsciiLetter);
+    }
+
+    bool ContentClassifier::IsFilePath(std::wstring_view text)
+    {
+        // C:\..., C:/... or \\server\share
+        size_t rootLength = 0;
+        if (text.size() >= 3 && IsAsciiLetter(text[0]) && text[1] == L':' && (text[2] == L'\\' || text[2] == L'/'))
+        {
+            rootLength = 3;
+        }
+        else if (text.size() >= 3 && text[0] == L'\\' && text[1] == L'\\' && text[2] != L'\\')
+        {
+            rootLength = 2;
+        }
+        else
+        {
+            return false;
+        }
+
+        return std::none_of(text.begin() + rootLength, text.end(), [](wchar_t c)
+            {
+                return c < L' ' || c == L'<' || c == L'>' || c == L'"' || c == L'|' || c == L'?' || c == L'*' || c == L':';
+            });
+    }
+}
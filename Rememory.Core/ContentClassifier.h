@@ -0,0 +1,55 @@
+#pragma once
+#include "pch.h"
+#include <string_view>
+#include "winrt/Rememory.Core.h"
+
+namespace winrt::Rememory::Core::implementation
+{
+    // Recognizes text clips that as a whole are a link, a color, an email address or a file path.
+    // Every kind is a short single-token shape, so the scan of a large text stops at the first character that rules them out.
+    class ContentClassifier
+    {
+    public:
+        static TextContent Classify(std::wstring_view text);
+
+    private:
+        class Cursor
+        {
+        public:
+            explicit Cursor(std::wstring_view text) : m_text(text) {}
+
+            bool AtEnd() const { return m_position >= m_text.size(); }
+            wchar_t Peek() const { return AtEnd() ? L'\0' : m_text[m_position]; }
+            size_t Position() const { return m_position; }
+
+            bool Skip(wchar_t c);
+            bool SkipIgnoreCase(std::wstring_view word);
+            void SkipSpaces();
+            size_t SkipDigits();
+            void Reset(size_t position);
+
+        private:
+            std::wstring_view m_text;
+            size_t m_position = 0;
+        };
+
+        static constexpr size_t MAX_COLOR_LENGTH = 128;
+
+        static bool IsSpace(wchar_t c);
+        static bool IsAsciiDigit(wchar_t c) { return c >= L'0' && c <= L'9'; }
+        static bool IsAsciiLetter(wchar_t c) { return (c >= L'a' && c <= L'z') || (c >= L'A' && c <= L'Z'); }
+        static bool IsHexDigit(wchar_t c) { return IsAsciiDigit(c) || (c >= L'a' && c <= L'f') || (c >= L'A' && c <= L'F'); }
+
+        static std::wstring_view Trim(std::wstring_view text);
+
+        static TextContent ClassifyHexColor(std::wstring_view text);
+        static bool IsFunctionalColor(std::wstring_view text);
+        static bool ReadNumber(Cursor& cursor, bool allowPercent);
+        static bool ReadSeparator(Cursor& cursor);
+        static bool ReadAlphaSeparator(Cursor& cursor);
+
+        static bool IsLink(std::wstring_view text);
+        static bool IsEmail(std::wstring_view text);
+        static bool IsFilePath(std::wstring_view text);
+    };
+}
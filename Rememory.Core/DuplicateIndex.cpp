@@ -0,0 +1,151 @@
+#include "pch.h"
+#include <algorithm>
+#include <cstring>
+#include "DuplicateIndex.h"
+#include "ImageHash.h"
+
+namespace {
+    using winrt::Rememory::Core::ClipboardFormat;
+
+    // Same precedence as the managed EqualDataTo comparison
+    const ClipboardFormat IDENTITY_FORMATS[] = {
+        ClipboardFormat::Text,
+        ClipboardFormat::Bitmap,
+        ClipboardFormat::Png,
+        ClipboardFormat::Files
+    };
+}
+
+namespace winrt::Rememory::Core::implementation
+{
+    bool DuplicateIndex::IsIdentityFormat(ClipboardFormat format)
+    {
+        return std::find(std::begin(IDENTITY_FORMATS), std::end(IDENTITY_FORMATS), format) != std::end(IDENTITY_FORMATS);
+    }
+
+    void DuplicateIndex::Add(int32_t clipId, ClipboardFormat format, const BYTE* hash, size_t hashSize)
+    {
+        Key key;
+        if (clipId <= 0 || !TryMakeKey(format, hash, hashSize, key))
+        {
+            return;
+        }
+
+        std::unique_lock lock(m_mutex);
+
+        // The newest clip owns the hash; the older owner keeps its other keys
+        auto [it, inserted] = m_clipIds.try_emplace(key, clipId);
+        if (!inserted)
+        {
+            if (it->second == clipId)
+            {
+                return;
+            }
+            it->second = clipId;
+        }
+        m_keysByClip.emplace(clipId, key);
+    }
+
+    void DuplicateIndex::Remove(int32_t clipId)
+    {
+        std::unique_lock lock(m_mutex);
+
+        auto [first, last] = m_keysByClip.equal_range(clipId);
+        for (auto it = first; it != last; ++it)
+        {
+            auto indexed = m_clipIds.find(it->second);
+            if (indexed != m_clipIds.end() && indexed->second == clipId)
+            {
+                m_clipIds.erase(indexed);
+            }
+        }
+        m_keysByClip.erase(first, last);
+    }
+
+    void DuplicateIndex::Clear()
+    {
+        std::unique_lock lock(m_mutex);
+        m_clipIds.clear();
+        m_keysByClip.clear();
+    }
+
+    int32_t DuplicateIndex::Find(const std::unordered_map<ClipboardFormat, std::vector<BYTE>>& hashes) const
+    {
+        std::shared_lock lock(m_mutex);
+
+        for (ClipboardFormat format : IDENTITY_FORMATS)
+        {
+            auto hashIt = hashes.find(format);
+            Key key;
+            if (hashIt == hashes.end() || !TryMakeKey(format, hashIt->second.data(), hashIt->second.size(), key))
+            {
+                continue;
+            }
+
+            if (auto it = m_clipIds.find(key); it != m_clipIds.end())
+            {
+                return it->second;
+            }
+        }
+
+        return 0;
+    }
+
+    void DuplicateIndex::AddRecentImage(uint64_t perceptualHash, ClipboardFormat format, const std::vector<BYTE>& hash)
+    {
+        Key key;
+        if (!TryMakeKey(format, hash.data(), hash.size(), key))
+        {
+            return;
+        }
+
+        std::unique_lock lock(m_mutex);
+
+        m_recentImages.push_front({ perceptualHash, key });
+        if (m_recentImages.size() > MAX_RECENT_IMAGES)
+        {
+            m_recentImages.pop_back();
+        }
+    }
+
+    int32_t DuplicateIndex::FindSimilarImage(uint64_t perceptualHash, int maxDistance) const
+    {
+        std::shared_lock lock(m_mutex);
+
+        // Newest first; images whose clip is gone no longer resolve through the index
+        for (const auto& image : m_recentImages)
+        {
+            if (ImageHash::Distance(image.perceptualHash, perceptualHash) > maxDistance)
+            {
+                continue;
+            }
+
+            if (auto it = m_clipIds.find(image.key); it != m_clipIds.end())
+            {
+                return it->second;
+            }
+        }
+
+        return 0;
+    }
+
+    size_t DuplicateIndex::KeyHasher::operator()(const Key& key) const noexcept
+    {
+        // SHA-256 output is uniformly distributed, so its leading bytes are already a good hash
+        size_t value = 0;
+        std::memcpy(&value, key.hash.data(), sizeof(value));
+        return value ^ static_cast<size_t>(key.format);
+    }
+
+    bool DuplicateIndex::TryMakeKey(ClipboardFormat format, const BYTE* hash, size_t hashSize, Key& key)
+    {
+        if (!hash || hashSize != HASH_SIZE || !IsIdentityFormat(format))
+        {
+            return false;
+        }
+
+        key.format = format;
+        std::memcpy(key.hash.data(), hash, HASH_SIZE);
+        return true;
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include "pch.h"
+#include <array>
+#include <deque>
+#include <shared_mutex>
+#include <unordered_map>
+#include "winrt/Rememory.Core.h"
+
+namespace winrt::Rememory::Core::implementation
+{
+    // Maps the SHA-256 hash of identity formats (text, images, files) to the id of the clip that holds them.
+    // Lets the monitor tell whether a new capture repeats an existing clip without scanning the history.
+    class DuplicateIndex
+    {
+    public:
+        static constexpr size_t HASH_SIZE = 32;   // SHA-256
+
+        // Formats that define clip identity, in lookup priority
+        static bool IsIdentityFormat(ClipboardFormat format);
+
+        void Add(int32_t clipId, ClipboardFormat format, const BYTE* hash, size_t hashSize);
+        void Remove(int32_t clipId);
+        void Clear();
+
+        // Returns the id of an indexed clip sharing any identity hash, or 0 if none
+        int32_t Find(const std::unordered_map<ClipboardFormat, std::vector<BYTE>>& hashes) const;
+
+        // Remembers the perceptual hash of a captured image next to its content hash
+        void AddRecentImage(uint64_t perceptualHash, ClipboardFormat format, const std::vector<BYTE>& hash);
+
+        // Returns the id of a clip holding a recent image within maxDistance bits, or 0 if none
+        int32_t FindSimilarImage(uint64_t perceptualHash, int maxDistance) const;
+
+    private:
+        struct Key
+        {
+            ClipboardFormat format;
+            std::array<BYTE, HASH_SIZE> hash;
+
+            bool operator==(const Key&) const = default;
+        };
+
+        struct KeyHasher
+        {
+            size_t operator()(const Key& key) const noexcept;
+        };
+
+        struct RecentImage
+        {
+            uint64_t perceptualHash;
+            Key key;
+        };
+
+        static constexpr size_t MAX_RECENT_IMAGES = 64;
+
+        mutable std::shared_mutex m_mutex;
+        std::unordered_map<Key, int32_t, KeyHasher> m_clipIds;
+        std::unordered_multimap<int32_t, Key> m_keysByClip;
+        std::deque<RecentImage> m_recentImages;
+
+        static bool TryMakeKey(ClipboardFormat format, const BYTE* hash, size_t hashSize, Key& key);
+    };
+}
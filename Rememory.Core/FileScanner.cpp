@@ -0,0 +1,99 @@
+#include "pch.h"
+#include <algorithm>
+#include <execution>
+#include "FileScanner.h"
+
+namespace {
+    uint64_t ToUInt64(DWORD high, DWORD low)
+    {
+        return (static_cast<uint64_t>(high) << 32) | low;
+    }
+}
+
+namespace winrt::Rememory::Core::implementation
+{
+    FileScanner::Result FileScanner::Scan(const std::vector<std::wstring>& paths, std::chrono::steady_clock::time_point deadline, const std::atomic<bool>& isCanceled)
+    {
+        std::vector<Entry> entries(paths.size());
+        std::transform(std::execution::par, paths.begin(), paths.end(), entries.begin(),
+            [&](const std::wstring& path) { return ScanPath(path, deadline, isCanceled); });
+
+        Result result;
+        for (const auto& entry : entries)
+        {
+            (entry.isDirectory ? result.foldersCount : result.filesCount)++;
+            result.totalSize += entry.size;
+            result.isTotalSizeComplete &= entry.isSizeComplete;
+        }
+
+        return result;
+    }
+
+    FileScanner::Entry FileScanner::ScanPath(const std::wstring& path, std::chrono::steady_clock::time_point deadline, const std::atomic<bool>& isCanceled)
+    {
+        Entry entry;
+        WIN32_FILE_ATTRIBUTE_DATA attributes;
+
+        // Missing files are still listed in the clip, they just count as empty files
+        if (!GetFileAttributesExW(path.c_str(), GetFileExInfoStandard, &attributes))
+        {
+            return entry;
+        }
+
+        if ((attributes.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+        {
+            entry.size = ToUInt64(attributes.nFileSizeHigh, attributes.nFileSizeLow);
+            return entry;
+        }
+
+        entry.isDirectory = true;
+        entry.isSizeComplete = GetDirectorySize(path, deadline, isCanceled, entry.size);
+        return entry;
+    }
+
+    bool FileScanner::GetDirectorySize(const std::wstring& path, std::chrono::steady_clock::time_point deadline, const std::atomic<bool>& isCanceled, uint64_t& size)
+    {
+        std::vector<std::wstring> pendingDirectories{ path };
+        uint32_t visitedCount = 0;
+        size = 0;
+
+        while (!pendingDirectories.empty())
+        {
+            std::wstring directory = std::move(pendingDirectories.back());
+            pendingDirectories.pop_back();
+
+            WIN32_FIND_DATAW findData;
+            HANDLE hFind = FindFirstFileExW((directory + L"\\*").c_str(), FindExInfoBasic, &findData, FindExSearchNameMatch, nullptr, FIND_FIRST_EX_LARGE_FETCH);
+            if (hFind == INVALID_HANDLE_VALUE)
+            {
+                continue;
+            }
+
+            do
+            {
+                if (++visitedCount % DEADLINE_CHECK_INTERVAL == 0
+                    && (isCanceled.load(std::memory_order_relaxed) || std::chrono::steady_clock::now() > deadline))
+                {
+                    FindClose(hFind);
+                    return false;
+                }
+
+                if ((findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+                {
+                    size += ToUInt64(findData.nFileSizeHigh, findData.nFileSizeLow);
+                }
+                // Links and junctions are not followed, they can point back up the tree
+                else if ((findData.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) == 0
+                    && wcscmp(findData.cFileName, L".") != 0
+                    && wcscmp(findData.cFileName, L"..") != 0)
+                {
+                    pendingDirectories.push_back(directory + L"\\" + findData.cFileName);
+                }
+            } while (FindNextFileW(hFind, &findData));
+
+            FindClose(hFind);
+        }
+
+        return true;
+    }
+}
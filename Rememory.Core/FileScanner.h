@@ -0,0 +1,41 @@
+#pragma once
+#include "pch.h"
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace winrt::Rememory::Core::implementation
+{
+    // Counts and sizes the entries of a copied file list off the UI thread.
+    // Top-level paths are checked in parallel; directory sizes are summed until the deadline or cancellation.
+    // Sizes are not cached, a folder's last write time doesn't change when files deeper in it do.
+    class FileScanner
+    {
+    public:
+        struct Result
+        {
+            int32_t filesCount = 0;
+            int32_t foldersCount = 0;
+            uint64_t totalSize = 0;
+            bool isTotalSizeComplete = true;
+        };
+
+        static Result Scan(const std::vector<std::wstring>& paths, std::chrono::steady_clock::time_point deadline, const std::atomic<bool>& isCanceled);
+
+    private:
+        struct Entry
+        {
+            bool isDirectory = false;
+            uint64_t size = 0;
+            bool isSizeComplete = true;
+        };
+
+        static constexpr uint32_t DEADLINE_CHECK_INTERVAL = 64;   // Entries between clock reads
+
+        static Entry ScanPath(const std::wstring& path, std::chrono::steady_clock::time_point deadline, const std::atomic<bool>& isCanceled);
+
+        // Returns false if the walk was interrupted, size then holds the bytes counted so far
+        static bool GetDirectorySize(const std::wstring& path, std::chrono::steady_clock::time_point deadline, const std::atomic<bool>& isCanceled, uint64_t& size);
+    };
+}
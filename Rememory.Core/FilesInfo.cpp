@@ -0,0 +1,8 @@
+#include "pch.h"
+#include "FilesInfo.h"
+#include "FilesInfo.g.cpp"
+
+namespace winrt::Rememory::Core::implementation
+{
+
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include "pch.h"
+#include "FilesInfo.g.h"
+
+namespace winrt::Rememory::Core::implementation
+{
+    struct FilesInfo : FilesInfoT<FilesInfo>
+    {
+        FilesInfo() = default;
+
+        int32_t FilesCount() const { return m_filesCount; }
+        void FilesCount(int32_t value) { m_filesCount = value; }
+
+        int32_t FoldersCount() const { return m_foldersCount; }
+        void FoldersCount(int32_t value) { m_foldersCount = value; }
+
+        uint64_t TotalSize() const { return m_totalSize; }
+        void TotalSize(uint64_t value) { m_totalSize = value; }
+
+        bool IsTotalSizeComplete() const { return m_isTotalSizeComplete; }
+        void IsTotalSizeComplete(bool value) { m_isTotalSizeComplete = value; }
+
+    private:
+        int32_t m_filesCount {};
+        int32_t m_foldersCount {};
+        uint64_t m_totalSize {};
+        bool m_isTotalSizeComplete {};
+    };
+}
+
+namespace winrt::Rememory::Core::factory_implementation
+{
+    struct FilesInfo : FilesInfoT<FilesInfo, implementation::FilesInfo> {};
+}
@@ -1,10 +1,18 @@
 #include "pch.h"
-#include <numeric>
-#include <fstream>
+#include <algorithm>
 #include <ShlObj.h>
+#include <winstring.h>
 #include <gdiplus.h>
 #include "FormatManager.h"
 #include "FormatManager.g.cpp"
+#include "TextExtractor.h"
+#include "Thumbnail.h"
+#include "BlobWriter.h"
+#include "FileScanner.h"
+#include "FilesInfo.h"
+#include "ContentClassifier.h"
+#include "BlobCipher.h"
+#include "Metrics.h"
 #pragma comment(lib, "gdiplus.lib")
 #pragma comment(lib, "gdi32.lib")
 
@@ -75,6 +83,140 @@ namespace winrt::Rememory::Core::implementation
         return it->second;
     }
 
+    winrt::hstring FormatManager::GetThumbnailPath(winrt::hstring const& dataPath, uint32_t size)
+    {
+        if (dataPath.empty())
+        {
+            return {};
+        }
+
+        return winrt::hstring{ Thumbnail::GetThumbnailPath(std::filesystem::path{ dataPath.c_str() }, size).wstring() };
+    }
+
+    TextContent FormatManager::ClassifyText(winrt::hstring const& text)
+    {
+        return ContentClassifier::Classify(text);
+    }
+
+    winrt::Windows::Storage::Streams::IBuffer FormatManager::ReadHistoryFile(winrt::hstring const& path)
+    {
+        if (path.empty())
+        {
+            return nullptr;
+        }
+
+        winrt::Windows::Storage::Streams::Buffer buffer{ nullptr };
+        bool isRead = BlobCipher::ReadFile(std::filesystem::path{ path.c_str() }, [&buffer](size_t size) -> BYTE*
+            {
+                if (size > UINT32_MAX)
+                {
+                    return nullptr;
+                }
+
+                buffer = winrt::Windows::Storage::Streams::Buffer{ static_cast<uint32_t>(size) };
+                buffer.Length(static_cast<uint32_t>(size));
+                return buffer.data();
+            });
+
+        return isRead ? buffer : nullptr;
+    }
+
+    bool FormatManager::IsHistoryFileSealed(winrt::hstring const& path)
+    {
+        return !path.empty() && BlobCipher::IsFileSealed(std::filesystem::path{ path.c_str() });
+    }
+
+    winrt::Windows::Storage::Streams::IBuffer FormatManager::SealText(winrt::hstring const& text)
+    {
+        if (!BlobCipher::IsEnabled())
+        {
+            return nullptr;
+        }
+
+        std::span<const BYTE> bytes{ reinterpret_cast<const BYTE*>(text.data()), text.size() * sizeof(wchar_t) };
+        size_t sealedSize = BlobCipher::GetSealedSize(bytes.size());
+
+        winrt::Windows::Storage::Streams::Buffer buffer{ static_cast<uint32_t>(sealedSize) };
+        if (!BlobCipher::Seal(bytes, buffer.data()))
+        {
+            throw winrt::hresult_error(E_FAIL, L"The text couldn't be sealed");
+        }
+
+        buffer.Length(static_cast<uint32_t>(sealedSize));
+        return buffer;
+    }
+
+    winrt::hstring FormatManager::OpenSealedText(winrt::Windows::Storage::Streams::IBuffer const& data)
+    {
+        if (!data)
+        {
+            return {};
+        }
+
+        std::span<const BYTE> sealed{ data.data(), data.Length() };
+        auto openedSize = BlobCipher::GetOpenedSize(sealed.size());
+        if (!BlobCipher::IsSealed(sealed) || !openedSize || *openedSize == 0 || *openedSize % sizeof(wchar_t) != 0)
+        {
+            Metrics::Increment(CounterId::UnreadableSealedTexts);
+            return {};
+        }
+
+        // Opened straight into the buffer of the returned string
+        PWSTR textBuffer = nullptr;
+        HSTRING_BUFFER hBuffer = nullptr;
+        if (FAILED(WindowsPreallocateStringBuffer(static_cast<UINT32>(*openedSize / sizeof(wchar_t)), &textBuffer, &hBuffer)))
+        {
+            return {};
+        }
+
+        HSTRING hString = nullptr;
+        if (!BlobCipher::Open(sealed, reinterpret_cast<BYTE*>(textBuffer)) || FAILED(WindowsPromoteStringBuffer(hBuffer, &hString)))
+        {
+            WindowsDeleteStringBuffer(hBuffer);
+            Metrics::Increment(CounterId::UnreadableSealedTexts);
+            return {};
+        }
+
+        winrt::hstring text;
+        winrt::attach_abi(text, hString);
+        return text;
+    }
+
+    winrt::Windows::Foundation::IAsyncOperation<Rememory::Core::FilesInfo> FormatManager::ScanFilesAsync(winrt::hstring filesPaths, winrt::Windows::Foundation::TimeSpan timeBudget)
+    {
+        auto cancellation = co_await winrt::get_cancellation_token();
+        auto isCanceled = std::make_shared<std::atomic<bool>>(false);
+        cancellation.callback([isCanceled] { isCanceled->store(true); });
+
+        co_await winrt::resume_background();
+
+        auto deadline = std::chrono::steady_clock::now() + timeBudget;
+
+        std::vector<std::wstring> paths;
+        std::wstring_view pathsView{ filesPaths };
+        wchar_t separator = FilePathsSeparator()[0];
+        size_t start = 0;
+
+        while (start <= pathsView.size())
+        {
+            size_t end = std::min(pathsView.find(separator, start), pathsView.size());
+            if (end > start)
+            {
+                paths.emplace_back(pathsView.substr(start, end - start));
+            }
+            start = end + 1;
+        }
+
+        auto result = FileScanner::Scan(paths, deadline, *isCanceled);
+
+        auto filesInfo = winrt::make<implementation::FilesInfo>();
+        filesInfo.FilesCount(result.filesCount);
+        filesInfo.FoldersCount(result.foldersCount);
+        filesInfo.TotalSize(result.totalSize);
+        filesInfo.IsTotalSizeComplete(result.isTotalSizeComplete);
+        co_return filesInfo;
+    }
+
 
     bool FormatManager::GetGeneralDataCopy(HANDLE hData, size_t maxDataSize, ClipboardData* clipboardData)
     {
@@ -106,6 +248,63 @@ namespace winrt::Rememory::Core::implementation
         return true;
     }
 
+    bool FormatManager::GetUnicodeDataCopy(HANDLE hData, size_t maxDataSize, ClipboardData* clipboardData)
+    {
+        size_t dataSize = GlobalSize(hData);
+        if (dataSize == 0 || dataSize > maxDataSize)
+        {
+            return false;
+        }
+
+        auto pSource = static_cast<const BYTE*>(GlobalLock(hData));
+        if (!pSource)
+        {
+            return false;
+        }
+
+        auto chars = reinterpret_cast<const wchar_t*>(pSource);
+        size_t charCount = dataSize / sizeof(wchar_t);
+
+        while (charCount > 0 && chars[charCount - 1] == L'\0')
+        {
+            charCount--;
+        }
+
+        // The text is copied once, straight into the buffer of the string handed to the app
+        bool isCopied = charCount <= UINT32_MAX;
+        if (isCopied && charCount > 0)
+        {
+            PWSTR buffer = nullptr;
+            HSTRING_BUFFER hBuffer = nullptr;
+            HSTRING hString = nullptr;
+
+            isCopied = SUCCEEDED(WindowsPreallocateStringBuffer(static_cast<UINT32>(charCount), &buffer, &hBuffer));
+            if (isCopied)
+            {
+                memcpy(buffer, chars, charCount * sizeof(wchar_t));
+
+                isCopied = SUCCEEDED(WindowsPromoteStringBuffer(hBuffer, &hString));
+                if (isCopied)
+                {
+                    winrt::attach_abi(clipboardData->text, hString);
+                }
+                else
+                {
+                    WindowsDeleteStringBuffer(hBuffer);
+                }
+            }
+        }
+
+        if (isCopied)
+        {
+            clipboardData->textTail.assign(pSource + charCount * sizeof(wchar_t), pSource + dataSize);
+            clipboardData->size = dataSize;
+        }
+
+        GlobalUnlock(hData);
+        return isCopied;
+    }
+
     bool FormatManager::GetFilesDataCopy(HANDLE hData, size_t maxDataSize, ClipboardData* clipboardData)
     {
         HANDLE hDropEffect = GetClipboardData(CF_PREFERREDDROPEFFECT);
@@ -122,60 +321,81 @@ namespace winrt::Rememory::Core::implementation
             GlobalUnlock(hDropEffect);
         }
 
-        HDROP hDrop = (HDROP)GlobalLock(hData);
-        if (!hDrop)
+        size_t dropSize = GlobalSize(hData);
+        auto* pDropFiles = static_cast<const DROPFILES*>(GlobalLock(hData));
+        if (!pDropFiles)
         {
             return false;
         }
 
-        UINT fileCount = DragQueryFile(hDrop, 0xFFFFFFFF, nullptr, 0);
-        std::vector<std::wstring> paths;
-
-        for (UINT i = 0; i < fileCount; ++i)
+        if (pDropFiles->pFiles >= dropSize)
         {
-            UINT requiredLength = DragQueryFile(hDrop, i, nullptr, 0);
-            std::wstring filePath;
-            filePath.resize(requiredLength);
-
-            DragQueryFile(hDrop, i, filePath.data(), requiredLength + 1);
-            paths.push_back(filePath);
+            GlobalUnlock(hData);
+            return false;
         }
 
-        size_t totalLength = std::accumulate(paths.begin(), paths.end(), 0ULL,
-            [](size_t sum, const std::wstring& s) { return sum + s.length(); });
+        // The paths are a double-null terminated list right after the header
+        const BYTE* pList = reinterpret_cast<const BYTE*>(pDropFiles) + pDropFiles->pFiles;
+        size_t listSize = dropSize - pDropFiles->pFiles;
+        std::wstring convertedList;
+        std::wstring_view list;
 
-        // Add space for separators
-        totalLength += ((paths.size() > 0) ? paths.size() - 1 : 0);
+        if (pDropFiles->fWide)
+        {
+            list = { reinterpret_cast<const wchar_t*>(pList), listSize / sizeof(wchar_t) };
+        }
+        else
+        {
+            int convertedLength = MultiByteToWideChar(CP_ACP, 0, reinterpret_cast<LPCCH>(pList), static_cast<int>(listSize), nullptr, 0);
+            convertedList.resize(convertedLength);
+            MultiByteToWideChar(CP_ACP, 0, reinterpret_cast<LPCCH>(pList), static_cast<int>(listSize), convertedList.data(), convertedLength);
+            list = convertedList;
+        }
 
-        if (totalLength > maxDataSize)
+        // The joined string is never longer than the list itself
+        auto* pCopy = static_cast<wchar_t*>(malloc(list.size() * sizeof(wchar_t)));
+        if (!pCopy)
         {
             GlobalUnlock(hData);
             return false;
         }
 
-        std::wstring joined;
-        joined.reserve(totalLength);
-        for (size_t i = 0; i < paths.size(); ++i)
+        // One pass over the list, the terminators between paths become separators
+        wchar_t separator = FilePathsSeparator()[0];
+        size_t length = 0;
+        bool isPathStart = true;
+
+        for (wchar_t c : list)
         {
-            joined.append(paths[i]);
-            if (i < paths.size() - 1)
+            if (c == L'\0')
+            {
+                if (isPathStart)
+                {
+                    break;   // An empty path ends the list
+                }
+
+                isPathStart = true;
+                continue;
+            }
+
+            if (isPathStart && length > 0)
             {
-                joined.append(FilePathsSeparator());
+                pCopy[length++] = separator;
             }
+
+            isPathStart = false;
+            pCopy[length++] = c;
         }
 
-        size_t dataSize = joined.size() * sizeof(wchar_t);
+        GlobalUnlock(hData);
 
-        LPVOID pCopy = malloc(dataSize);
-        if (!pCopy)
+        size_t dataSize = length * sizeof(wchar_t);
+        if (dataSize == 0 || dataSize > maxDataSize)
         {
-            GlobalUnlock(hData);
+            free(pCopy);
             return false;
         }
 
-        memcpy(pCopy, joined.c_str(), dataSize);
-        GlobalUnlock(hData);
-
         clipboardData->data = pCopy;
         clipboardData->size = dataSize;
 
@@ -278,19 +498,12 @@ namespace winrt::Rememory::Core::implementation
             co_return {};
         }
 
-        auto formatFolderName = GetFormatFolderName(format).c_str();
-        auto fileName = GenerateFileName(format).c_str();
-        std::filesystem::path fullPath{ rootHistoryFolder / formatFolderName / fileName };
-
-        // Ensure folder exists
-        std::filesystem::create_directories(fullPath.parent_path());
+        auto formatFolderName = GetFormatFolderName(format);
+        auto fileName = GenerateFileName(format);
+        std::filesystem::path fullPath{ rootHistoryFolder / formatFolderName.c_str() / fileName.c_str() };
 
-        std::ofstream file{ fullPath, std::ios::binary | std::ios::trunc };
-        if (file.is_open())
+        if (co_await BlobWriter::WriteAsync(fullPath, clipboardData->data, clipboardData->size))
         {
-            file.write(reinterpret_cast<const char*>(clipboardData->data), clipboardData->size);
-            file.close();
-
             co_return winrt::hstring{ fullPath.wstring() };
         }
 
@@ -304,41 +517,24 @@ namespace winrt::Rememory::Core::implementation
             co_return {};
         }
 
-        auto formatFolderName = GetFormatFolderName(format).c_str();
-        auto fileName = GenerateFileName(format).c_str();
-        std::filesystem::path fullPath{ rootHistoryFolder / formatFolderName / fileName };
+        auto* pBitmapHeader = reinterpret_cast<BITMAPINFOHEADER*>(clipboardData->header);
+        if (pBitmapHeader->biWidth <= 0 || pBitmapHeader->biHeight == 0)
+        {
+            co_return {};
+        }
+
+        auto formatFolderName = GetFormatFolderName(format);
+        auto fileName = GenerateFileName(format);
+        std::filesystem::path fullPath{ rootHistoryFolder / formatFolderName.c_str() / fileName.c_str() };
 
-        // Ensure folder exists
-        std::filesystem::create_directories(fullPath.parent_path());
+        winrt::array_view<const uint8_t> pixels(reinterpret_cast<const uint8_t*>(clipboardData->data), clipboardData->size);
 
         try
         {
-            auto folder = co_await winrt::Windows::Storage::StorageFolder::GetFolderFromPathAsync(winrt::hstring(fullPath.parent_path().wstring()));
-            auto file = co_await folder.CreateFileAsync(fileName, winrt::Windows::Storage::CreationCollisionOption::ReplaceExisting);
-            auto stream = co_await file.OpenAsync(winrt::Windows::Storage::FileAccessMode::ReadWrite);
-            auto encoder = co_await winrt::Windows::Graphics::Imaging::BitmapEncoder::CreateAsync(winrt::Windows::Graphics::Imaging::BitmapEncoder::PngEncoderId(), stream);
-
-            auto* pBitmapHeader = reinterpret_cast<BITMAPINFOHEADER*>(clipboardData->header);
-            if (pBitmapHeader->biWidth <= 0 || pBitmapHeader->biHeight == 0)
+            if (co_await BlobWriter::WritePngAsync(fullPath, pixels, pBitmapHeader->biWidth, abs(pBitmapHeader->biHeight)))
             {
-                co_return {};
+                co_return winrt::hstring{ fullPath.wstring() };
             }
-
-            winrt::array_view<const uint8_t> pixels(reinterpret_cast<const uint8_t*>(clipboardData->data), clipboardData->size);
-
-            encoder.SetPixelData(
-                winrt::Windows::Graphics::Imaging::BitmapPixelFormat::Bgra8,
-                winrt::Windows::Graphics::Imaging::BitmapAlphaMode::Ignore,
-                pBitmapHeader->biWidth,
-                abs(pBitmapHeader->biHeight),
-                96.0, 96.0,
-                pixels
-            );
-
-            co_await encoder.FlushAsync();
-            stream.Close();
-
-            co_return file.Path();
         }
         catch (const hresult_error& err) {}
 
@@ -346,48 +542,45 @@ namespace winrt::Rememory::Core::implementation
     }
 
 
-    bool FormatManager::LoadGeneralDataToClipboard(UINT formatId, const winrt::hstring& data)
+    HGLOBAL FormatManager::ReadHistoryFileToGlobal(const std::filesystem::path& path)
     {
-        if (data.empty())
-        {
-            return false;
-        }
+        HGLOBAL hGlobal = nullptr;
+        BYTE* pData = nullptr;
 
-        std::filesystem::path filePath{ data.c_str()};
-        if (!std::filesystem::exists(filePath) || !std::filesystem::is_regular_file(filePath))
-        {
-            return false;
-        }
+        bool isRead = BlobCipher::ReadFile(path, [&hGlobal, &pData](size_t size) -> BYTE*
+            {
+                hGlobal = GlobalAlloc(GMEM_MOVEABLE, size);
+                pData = hGlobal ? static_cast<BYTE*>(GlobalLock(hGlobal)) : nullptr;
+                return pData;
+            });
 
-        uintmax_t fileSize = std::filesystem::file_size(filePath);
-        if (fileSize == 0 || fileSize > static_cast<uintmax_t>((SIZE_T)-1))
+        if (pData)
         {
-            return false;
+            GlobalUnlock(hGlobal);
         }
 
-        HGLOBAL hGlobal = GlobalAlloc(GMEM_MOVEABLE, static_cast<SIZE_T>(fileSize));
-        if (!hGlobal)
+        if (!isRead && hGlobal)
         {
-            return false;
+            GlobalFree(hGlobal);
+            hGlobal = nullptr;
         }
 
-        void* pData = GlobalLock(hGlobal);
-        if (!pData)
+        return hGlobal;
+    }
+
+    bool FormatManager::LoadGeneralDataToClipboard(UINT formatId, const winrt::hstring& data)
+    {
+        if (data.empty())
         {
-            GlobalFree(hGlobal);
             return false;
         }
 
-        std::ifstream file{ filePath, std::ios::binary };
-        if (!file.read(static_cast<char*>(pData), fileSize))
+        HGLOBAL hGlobal = ReadHistoryFileToGlobal(std::filesystem::path{ data.c_str() });
+        if (!hGlobal)
         {
-            GlobalUnlock(hGlobal);
-            GlobalFree(hGlobal);
             return false;
         }
 
-        GlobalUnlock(hGlobal);
-
         if (!SetClipboardData(formatId, hGlobal))
         {
             GlobalFree(hGlobal);
@@ -445,27 +638,8 @@ namespace winrt::Rememory::Core::implementation
             return false;
         }
 
-        std::vector<std::wstring> paths;
-        std::wstring_view separator{ FilePathsSeparator() };
-
-        size_t start = 0;
-        size_t end = dataView.find(separator);
-        while (end != std::wstring_view::npos)
-        {
-            paths.emplace_back(dataView.substr(start, end - start));
-            start = end + separator.length();
-            end = dataView.find(separator, start);
-        }
-        paths.emplace_back(dataView.substr(start));
-
-        size_t pathsTotalChars = 0;
-        for (const auto& path : paths)
-        {
-            pathsTotalChars += (path.length() + 1); // +1 for null terminator
-        }
-        pathsTotalChars += 1; // Final double-null terminator
-
-        size_t totalSize = sizeof(DROPFILES) + (pathsTotalChars * sizeof(wchar_t));
+        // Each separator turns into a path terminator, plus the final double-null terminator
+        size_t totalSize = sizeof(DROPFILES) + ((dataView.size() + 2) * sizeof(wchar_t));
 
         HGLOBAL hGlobal = GlobalAlloc(GMEM_MOVEABLE | GMEM_ZEROINIT, totalSize);
         if (!hGlobal)
@@ -483,13 +657,9 @@ namespace winrt::Rememory::Core::implementation
         pDrop->pFiles = sizeof(DROPFILES); // Offset to where files start
         pDrop->fWide = TRUE;
 
+        // The buffer is zeroed, so the list is terminated once the paths are copied
         wchar_t* pPathBuffer = reinterpret_cast<wchar_t*>(reinterpret_cast<BYTE*>(pDrop) + sizeof(DROPFILES));
-        size_t currentOffset = 0;
-        for (const auto& path : paths)
-        {
-            wcscpy_s(pPathBuffer + currentOffset, path.length() + 1, path.c_str());
-            currentOffset += (path.length() + 1);
-        }
+        std::replace_copy(dataView.begin(), dataView.end(), pPathBuffer, FilePathsSeparator()[0], L'\0');
 
         GlobalUnlock(hGlobal);
 
@@ -539,12 +709,42 @@ namespace winrt::Rememory::Core::implementation
             return false;
         }
 
-        Gdiplus::Bitmap bitmap(data.c_str());
-        if (bitmap.GetLastStatus() != Gdiplus::Ok)
+        HGLOBAL hGlobal = ReadImageFileToDib(std::filesystem::path{ data.c_str() });
+        if (!hGlobal)
         {
             return false;
         }
 
+        if (!SetClipboardData(CF_DIB, hGlobal))
+        {
+            GlobalFree(hGlobal);
+            return false;
+        }
+
+        return true;
+    }
+
+    HGLOBAL FormatManager::ReadImageFileToDib(const std::filesystem::path& path)
+    {
+        // Sealed images are opened in memory, the stream owns the file data
+        HGLOBAL hFileData = ReadHistoryFileToGlobal(path);
+        winrt::com_ptr<IStream> fileStream;
+
+        if (!hFileData || FAILED(CreateStreamOnHGlobal(hFileData, TRUE, fileStream.put())))
+        {
+            if (hFileData)
+            {
+                GlobalFree(hFileData);
+            }
+            return nullptr;
+        }
+
+        Gdiplus::Bitmap bitmap(fileStream.get());
+        if (bitmap.GetLastStatus() != Gdiplus::Ok)
+        {
+            return nullptr;
+        }
+
         UINT width = bitmap.GetWidth();
         UINT height = bitmap.GetHeight();
 
@@ -557,17 +757,17 @@ namespace winrt::Rememory::Core::implementation
         bi.biCompression = BI_RGB;
 
         DWORD dwSize = sizeof(BITMAPINFOHEADER) + (width * height * 4);
-        HANDLE hGlobal = GlobalAlloc(GMEM_MOVEABLE, dwSize);
+        HGLOBAL hGlobal = GlobalAlloc(GMEM_MOVEABLE, dwSize);
         if (!hGlobal)
         {
-            return false;
+            return nullptr;
         }
 
         void* pData = GlobalLock(hGlobal);
         if (!pData)
         {
             GlobalFree(hGlobal);
-            return false;
+            return nullptr;
         }
 
         memcpy(pData, &bi, sizeof(bi));
@@ -588,12 +788,29 @@ namespace winrt::Rememory::Core::implementation
         bitmap.UnlockBits(&bmpData);
         GlobalUnlock(hGlobal);
 
-        if (!SetClipboardData(CF_DIB, hGlobal))
+        return hGlobal;
+    }
+
+
+    winrt::hstring FormatManager::ExtractHtmlText(const ClipboardData* clipboardData)
+    {
+        if (!clipboardData->data || clipboardData->size == 0)
         {
-            GlobalFree(hGlobal);
-            return false;
+            return {};
         }
 
-        return true;
+        std::string_view html{ static_cast<const char*>(clipboardData->data), clipboardData->size };
+        return winrt::hstring{ TextExtractor::ExtractFromHtml(html) };
+    }
+
+    winrt::hstring FormatManager::ExtractRtfText(const ClipboardData* clipboardData)
+    {
+        if (!clipboardData->data || clipboardData->size == 0)
+        {
+            return {};
+        }
+
+        std::string_view rtf{ static_cast<const char*>(clipboardData->data), clipboardData->size };
+        return winrt::hstring{ TextExtractor::ExtractFromRtf(rtf) };
     }
 }
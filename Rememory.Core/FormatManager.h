@@ -20,6 +20,7 @@ namespace winrt::Rememory::Core::implementation
             std::function<bool(HANDLE, size_t, ClipboardData*)> copyFromClipboardFunction;
             std::function<winrt::Windows::Foundation::IAsyncOperation<winrt::hstring>(std::filesystem::path, ClipboardFormat, const ClipboardData*)> saveToFileFunction;
             std::function<bool(UINT, const winrt::hstring&)> loadToClipboardFunction;
+            std::function<winrt::hstring(const ClipboardData*)> extractTextFunction;
         };
 
         static inline const std::unordered_map<ClipboardFormat, winrt::hstring> formatNames
@@ -33,6 +34,7 @@ namespace winrt::Rememory::Core::implementation
         };
 
         static bool GetGeneralDataCopy(HANDLE hData, size_t maxDataSize, ClipboardData* clipboardData);
+        static bool GetUnicodeDataCopy(HANDLE hData, size_t maxDataSize, ClipboardData* clipboardData);
         static bool GetFilesDataCopy(HANDLE hData, size_t maxDataSize, ClipboardData* clipboardData);
         static bool GetBitmapDataCopy(HANDLE hData, size_t maxDataSize, ClipboardData* clipboardData);
 
@@ -45,15 +47,18 @@ namespace winrt::Rememory::Core::implementation
         static bool LoadImageToClipboard(UINT formatId, const winrt::hstring& data);
         static bool LoadBitmapToClipboard(UINT formatId, const winrt::hstring& data);
 
+        static winrt::hstring ExtractHtmlText(const ClipboardData* clipboardData);
+        static winrt::hstring ExtractRtfText(const ClipboardData* clipboardData);
+
     public:
         static inline const std::vector<std::pair<ClipboardFormat, FormatRule>> ClipboardFormatRules
         {
-            { ClipboardFormat::Files,  { { CF_HDROP },             GetFilesDataCopy,     nullptr,                  LoadFilesToClipboard       } },
-            { ClipboardFormat::Png,    { { CF_PNG, CF_IMAGEPNG },  GetGeneralDataCopy,   SaveGeneralDataToFile,    LoadImageToClipboard       } },
-            { ClipboardFormat::Html,   { { CF_HTML },              GetGeneralDataCopy,   SaveGeneralDataToFile,    LoadGeneralDataToClipboard } },
-            { ClipboardFormat::Rtf,    { { CF_RTF },               GetGeneralDataCopy,   SaveGeneralDataToFile,    LoadGeneralDataToClipboard } },
-            { ClipboardFormat::Bitmap, { { CF_BITMAP },            GetBitmapDataCopy,    SaveBitmapToFile,         LoadBitmapToClipboard      } },
-            { ClipboardFormat::Text,   { { CF_UNICODETEXT },       GetGeneralDataCopy,   nullptr,                  LoadUnicodeToClipboard     } }
+            { ClipboardFormat::Files,  { { CF_HDROP },             GetFilesDataCopy,     nullptr,                  LoadFilesToClipboard,       nullptr         } },
+            { ClipboardFormat::Png,    { { CF_PNG, CF_IMAGEPNG },  GetGeneralDataCopy,   SaveGeneralDataToFile,    LoadImageToClipboard,       nullptr         } },
+            { ClipboardFormat::Html,   { { CF_HTML },              GetGeneralDataCopy,   SaveGeneralDataToFile,    LoadGeneralDataToClipboard, ExtractHtmlText } },
+            { ClipboardFormat::Rtf,    { { CF_RTF },               GetGeneralDataCopy,   SaveGeneralDataToFile,    LoadGeneralDataToClipboard, ExtractRtfText  } },
+            { ClipboardFormat::Bitmap, { { CF_BITMAP },            GetBitmapDataCopy,    SaveBitmapToFile,         LoadBitmapToClipboard,      nullptr         } },
+            { ClipboardFormat::Text,   { { CF_UNICODETEXT },       GetUnicodeDataCopy,   nullptr,                  LoadUnicodeToClipboard,     nullptr         } }
         };
 
         static const FormatRule* GetRule(ClipboardFormat format)
@@ -98,16 +103,40 @@ namespace winrt::Rememory::Core::implementation
             return name;
         }
 
+        // The subfolder name within the history root for storing pre-scaled previews of image clips.
+        static const winrt::hstring& ThumbnailsFolderName() {
+            static winrt::hstring name{ L"Thumbnails" };
+            return name;
+        }
+
+        // The subfolder name within the history root for files that are still being written.
+        static const winrt::hstring& TempFolderName() {
+            static winrt::hstring name{ L"Temp" };
+            return name;
+        }
+
         // The delimiter used to join multiple file paths into a single string for storage or transport.
         static const winrt::hstring& FilePathsSeparator() {
             static winrt::hstring separator{ L"|" };
             return separator;
         }
 
+        // History file contents in a movable global block, opened if the file is sealed
+        static HGLOBAL ReadHistoryFileToGlobal(const std::filesystem::path& path);
+        // Image history file decoded into a CF_DIB block
+        static HGLOBAL ReadImageFileToDib(const std::filesystem::path& path);
+
         static winrt::hstring FormatToName(ClipboardFormat format);
         static ClipboardFormat FormatFromName(winrt::hstring formatName);
         static winrt::hstring GenerateFileName(ClipboardFormat format);
         static winrt::hstring GetFormatFolderName(ClipboardFormat format);
+        static winrt::hstring GetThumbnailPath(winrt::hstring const& dataPath, uint32_t size);
+        static TextContent ClassifyText(winrt::hstring const& text);
+        static winrt::Windows::Storage::Streams::IBuffer ReadHistoryFile(winrt::hstring const& path);
+        static bool IsHistoryFileSealed(winrt::hstring const& path);
+        static winrt::Windows::Storage::Streams::IBuffer SealText(winrt::hstring const& text);
+        static winrt::hstring OpenSealedText(winrt::Windows::Storage::Streams::IBuffer const& data);
+        static winrt::Windows::Foundation::IAsyncOperation<Rememory::Core::FilesInfo> ScanFilesAsync(winrt::hstring filesPaths, winrt::Windows::Foundation::TimeSpan timeBudget);
     };
 }
 
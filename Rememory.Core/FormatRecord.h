@@ -18,10 +18,22 @@ namespace winrt::Rememory::Core::implementation
         winrt::Windows::Storage::Streams::IBuffer Hash() const { return m_hash; }
         void Hash(winrt::Windows::Storage::Streams::IBuffer const& value) { m_hash = value; }
 
+        winrt::hstring PlainText() const { return m_plainText; }
+        void PlainText(winrt::hstring const& value) { m_plainText = value; }
+
+        Rememory::Core::FilesInfo FilesInfo() const { return m_filesInfo; }
+        void FilesInfo(Rememory::Core::FilesInfo const& value) { m_filesInfo = value; }
+
+        TextContent Content() const { return m_content; }
+        void Content(TextContent value) { m_content = value; }
+
     private:
         ClipboardFormat m_format {};
         winrt::hstring m_data {};
         winrt::Windows::Storage::Streams::IBuffer m_hash { nullptr };
+        winrt::hstring m_plainText {};
+        Rememory::Core::FilesInfo m_filesInfo { nullptr };
+        TextContent m_content { TextContent::None };
     };
 }
 
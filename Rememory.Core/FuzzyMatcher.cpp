@@ -0,0 +1,136 @@
+#include "pch.h"
+#include "FuzzyMatcher.h"
+#include "FuzzyMatcher.g.cpp"
+#include "Metrics.h"
+#include <algorithm>
+#include <execution>
+#include <thread>
+
+namespace {
+    struct Result
+    {
+        int32_t score;
+        int32_t index;
+    };
+
+    // Higher score first, earlier index among equal scores, so the ranking is stable
+    bool IsBetter(const Result& left, const Result& right)
+    {
+        return left.score != right.score ? left.score > right.score : left.index < right.index;
+    }
+}
+
+namespace winrt::Rememory::Core::implementation
+{
+    FuzzyMatcher::FuzzyMatcher(winrt::hstring const& query) : m_scorer(query) {}
+
+    winrt::Windows::Foundation::Collections::IVectorView<int32_t> FuzzyMatcher::FindBest(winrt::Windows::Foundation::Collections::IVectorView<winrt::hstring> const& texts, uint32_t maxCount) const
+    {
+        std::vector<winrt::hstring> items(texts.Size());
+        texts.GetMany(0, items);
+
+        return winrt::single_threaded_vector(Rank(items, maxCount, nullptr)).GetView();
+    }
+
+    winrt::Windows::Foundation::IAsyncOperation<winrt::Windows::Foundation::Collections::IVectorView<int32_t>> FuzzyMatcher::FindBestAsync(winrt::Windows::Foundation::Collections::IVectorView<winrt::hstring> texts, uint32_t maxCount)
+    {
+        auto strongThis = get_strong();
+        auto cancellation = co_await winrt::get_cancellation_token();
+        auto isCanceled = std::make_shared<std::atomic<bool>>(false);
+        cancellation.callback([isCanceled] { isCanceled->store(true); });
+
+        std::vector<winrt::hstring> items(texts.Size());
+        texts.GetMany(0, items);
+
+        co_await winrt::resume_background();
+
+        co_return winrt::single_threaded_vector(Rank(items, maxCount, isCanceled.get())).GetView();
+    }
+
+    std::vector<int32_t> FuzzyMatcher::Rank(std::vector<winrt::hstring> const& items, uint32_t maxCount, std::atomic<bool> const* isCanceled) const
+    {
+        Metrics::Scope scope(MetricId::FuzzySearch);
+
+        if (maxCount == 0 || items.empty())
+        {
+            return {};
+        }
+
+        if (m_scorer.IsEmpty())
+        {
+            std::vector<int32_t> indices(std::min<size_t>(items.size(), maxCount));
+            for (size_t i = 0; i < indices.size(); i++)
+            {
+                indices[i] = static_cast<int32_t>(i);
+            }
+            return indices;
+        }
+
+        size_t chunkCount = std::clamp<size_t>(items.size() / MIN_CHUNK_SIZE, 1, std::max(std::thread::hardware_concurrency(), 1u));
+        size_t chunkSize = (items.size() + chunkCount - 1) / chunkCount;
+        std::vector<std::vector<Result>> heaps(chunkCount);
+
+        std::for_each(std::execution::par, heaps.begin(), heaps.end(), [&](std::vector<Result>& heap)
+            {
+                size_t start = (&heap - heaps.data()) * chunkSize;
+                size_t end = std::min(start + chunkSize, items.size());
+                heap.reserve(std::min<size_t>(end - start, maxCount));
+
+                // The front of the heap is the worst result kept so far
+                for (size_t i = start; i < end; i++)
+                {
+                    if (isCanceled && (i - start) % CANCELLATION_CHECK_INTERVAL == 0 && isCanceled->load(std::memory_order_relaxed))
+                    {
+                        break;
+                    }
+
+                    auto score = m_scorer.Score(items[i]);
+                    if (!score)
+                    {
+                        continue;
+                    }
+
+                    Result result{ *score, static_cast<int32_t>(i) };
+                    if (heap.size() < maxCount)
+                    {
+                        heap.push_back(result);
+                        std::push_heap(heap.begin(), heap.end(), IsBetter);
+                    }
+                    else if (IsBetter(result, heap.front()))
+                    {
+                        std::pop_heap(heap.begin(), heap.end(), IsBetter);
+                        heap.back() = result;
+                        std::push_heap(heap.begin(), heap.end(), IsBetter);
+                    }
+                }
+            });
+
+        std::vector<Result> results;
+        for (const auto& heap : heaps)
+        {
+            results.insert(results.end(), heap.begin(), heap.end());
+        }
+
+        size_t count = std::min<size_t>(results.size(), maxCount);
+        std::partial_sort(results.begin(), results.begin() + count, results.end(), IsBetter);
+
+        std::vector<int32_t> indices(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            indices[i] = results[i].index;
+        }
+
+        return indices;
+    }
+
+    winrt::Windows::Foundation::Collections::IVectorView<Rememory::Core::MatchSpan> FuzzyMatcher::GetMatchSpans(winrt::hstring const& text) const
+    {
+        std::vector<Rememory::Core::MatchSpan> spans;
+        for (const auto& [start, length] : m_scorer.GetSpans(text))
+        {
+            spans.push_back({ static_cast<int32_t>(start), static_cast<int32_t>(length) });
+        }
+
+        return winrt::single_threaded_vector(std::move(spans)).GetView();
+    }
+}
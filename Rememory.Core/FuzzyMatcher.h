@@ -0,0 +1,34 @@
+#pragma once
+#include "pch.h"
+#include "FuzzyMatcher.g.h"
+#include "FuzzyScorer.h"
+#include <atomic>
+
+namespace winrt::Rememory::Core::implementation
+{
+    // Texts are scored in parallel chunks, each keeping its best results in a bounded heap,
+    // so ranking stays linear in the number of texts and only the results are sorted. Canceling is checked inside the chunks.
+    struct FuzzyMatcher : FuzzyMatcherT<FuzzyMatcher>
+    {
+        FuzzyMatcher(winrt::hstring const& query);
+
+        winrt::Windows::Foundation::Collections::IVectorView<int32_t> FindBest(winrt::Windows::Foundation::Collections::IVectorView<winrt::hstring> const& texts, uint32_t maxCount) const;
+        winrt::Windows::Foundation::IAsyncOperation<winrt::Windows::Foundation::Collections::IVectorView<int32_t>> FindBestAsync(winrt::Windows::Foundation::Collections::IVectorView<winrt::hstring> texts, uint32_t maxCount);
+        winrt::Windows::Foundation::Collections::IVectorView<Rememory::Core::MatchSpan> GetMatchSpans(winrt::hstring const& text) const;
+
+        bool CanMatch(uint64_t characterMask, size_t length) const { return m_scorer.CanMatch(characterMask, length); }
+
+    private:
+        static constexpr size_t MIN_CHUNK_SIZE = 1024;   // Smaller chunks cost more to schedule than to score
+        static constexpr size_t CANCELLATION_CHECK_INTERVAL = 64;   // Texts between checks
+
+        FuzzyScorer m_scorer;
+
+        std::vector<int32_t> Rank(std::vector<winrt::hstring> const& items, uint32_t maxCount, std::atomic<bool> const* isCanceled) const;
+    };
+}
+
+namespace winrt::Rememory::Core::factory_implementation
+{
+    struct FuzzyMatcher : FuzzyMatcherT<FuzzyMatcher, implementation::FuzzyMatcher> {};
+}
@@ -0,0 +1,442 @@
+#include "pch.h"
+#include <algorithm>
+#include <bit>
+#include <memory>
+#include "FuzzyScorer.h"
+
+#if defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(_M_ARM64)
+#include <arm_neon.h>
+#endif
+
+namespace {
+    constexpr std::wstring_view DELIMITERS = L"/\\,:;|";
+}
+
+namespace winrt::Rememory::Core::implementation
+{
+    FuzzyScorer::FuzzyScorer(std::wstring_view query)
+    {
+        size_t position = 0;
+        while (position < query.size())
+        {
+            while (position < query.size() && GetClass(query[position]) == CharClass::White)
+            {
+                position++;
+            }
+
+            std::wstring term;
+            while (position < query.size() && GetClass(query[position]) != CharClass::White)
+            {
+                term.push_back(Fold(query[position++]));
+            }
+
+            if (!term.empty())
+            {
+                for (wchar_t c : term)
+                {
+                    m_requiredMask |= GetCharacterBit(c);
+                }
+                m_minLength = std::max(m_minLength, term.size());
+                m_terms.push_back(std::move(term));
+            }
+        }
+    }
+
+    std::optional<int32_t> FuzzyScorer::Score(std::wstring_view text) const
+    {
+        int32_t score = 0;
+
+        for (const auto& term : m_terms)
+        {
+            auto window = Match(text, term);
+            if (!window)
+            {
+                return std::nullopt;
+            }
+
+            score += ScoreWindow(text, term, *window, nullptr);
+        }
+
+        return score;
+    }
+
+    std::vector<std::pair<size_t, size_t>> FuzzyScorer::GetSpans(std::wstring_view text) const
+    {
+        std::vector<std::pair<size_t, size_t>> spans;
+
+        for (const auto& term : m_terms)
+        {
+            size_t position = FindExact(text, 0, term);
+            if (position != std::wstring_view::npos)
+            {
+                for (; position != std::wstring_view::npos; position = FindExact(text, position + term.size(), term))
+                {
+                    spans.emplace_back(position, term.size());
+                }
+                continue;
+            }
+
+            auto window = Match(text, term);
+            if (!window)
+            {
+                return {};
+            }
+
+            std::vector<size_t> positions;
+            ScoreWindow(text, term, *window, &positions);
+
+            for (size_t matched : positions)
+            {
+                spans.emplace_back(matched, 1);
+            }
+        }
+
+        std::sort(spans.begin(), spans.end());
+
+        // Overlapping and adjacent ranges become one
+        std::vector<std::pair<size_t, size_t>> merged;
+        for (const auto& [start, length] : spans)
+        {
+            if (!merged.empty() && start <= merged.back().first + merged.back().second)
+            {
+                merged.back().second = std::max(merged.back().second, start + length - merged.back().first);
+            }
+            else
+            {
+                merged.emplace_back(start, length);
+            }
+        }
+
+        return merged;
+    }
+
+    uint64_t FuzzyScorer::GetCharacterMask(std::wstring_view text)
+    {
+        uint64_t mask = 0;
+        for (wchar_t c : text)
+        {
+            mask |= GetCharacterBit(Fold(c));
+        }
+        return mask;
+    }
+
+    uint64_t FuzzyScorer::GetCharacterBit(wchar_t folded)
+    {
+        if (folded >= L'a' && folded <= L'z')
+        {
+            return 1ull << (folded - L'a');
+        }
+        if (folded >= L'0' && folded <= L'9')
+        {
+            return 1ull << (26 + folded - L'0');
+        }
+        return 1ull << (36 + folded % 28);
+    }
+
+    const FuzzyScorer::Tables& FuzzyScorer::GetTables()
+    {
+        static const std::unique_ptr<Tables> tables = []()
+            {
+                auto tables = std::make_unique<Tables>();
+
+                std::array<wchar_t, 0x10000> chars;
+                for (size_t i = 0; i < chars.size(); i++)
+                {
+                    chars[i] = static_cast<wchar_t>(i);
+                }
+
+                // Invariant lowercase, so matching doesn't depend on the user's locale
+                if (LCMapStringEx(LOCALE_NAME_INVARIANT, LCMAP_LOWERCASE, chars.data(), static_cast<int>(chars.size()),
+                    tables->fold.data(), static_cast<int>(tables->fold.size()), nullptr, nullptr, 0) != static_cast<int>(chars.size()))
+                {
+                    for (size_t i = 0; i < chars.size(); i++)
+                    {
+                        tables->fold[i] = (i >= L'A' && i <= L'Z') ? static_cast<wchar_t>(i + (L'a' - L'A')) : chars[i];
+                    }
+                }
+
+                tables->foldedFromNonAscii.fill(false);
+                for (size_t i = 0x80; i < chars.size(); i++)
+                {
+                    if (tables->fold[i] < 0x80)
+                    {
+                        tables->foldedFromNonAscii[tables->fold[i]] = true;
+                    }
+                }
+
+                std::array<WORD, 0x10000> types{};
+                GetStringTypeW(CT_CTYPE1, chars.data(), static_cast<int>(chars.size()), types.data());
+
+                for (size_t i = 0; i < chars.size(); i++)
+                {
+                    WORD type = types[i];
+                    CharClass& charClass = tables->classes[i];
+
+                    if (DELIMITERS.find(chars[i]) != std::wstring_view::npos)
+                    {
+                        charClass = CharClass::Delimiter;
+                    }
+                    else if (type & C1_SPACE)
+                    {
+                        charClass = CharClass::White;
+                    }
+                    else if (type & C1_DIGIT)
+                    {
+                        charClass = CharClass::Number;
+                    }
+                    else if (type & C1_UPPER)
+                    {
+                        charClass = CharClass::Upper;
+                    }
+                    else if (type & C1_LOWER)
+                    {
+                        charClass = CharClass::Lower;
+                    }
+                    else if (type & C1_ALPHA)
+                    {
+                        charClass = CharClass::Letter;
+                    }
+                    else
+                    {
+                        charClass = CharClass::NonWord;
+                    }
+                }
+
+                return tables;
+            }();
+
+        return *tables;
+    }
+
+    int32_t FuzzyScorer::GetBonus(CharClass previous, CharClass current)
+    {
+        bool isWord = current >= CharClass::Lower;
+
+        if (isWord)
+        {
+            switch (previous)
+            {
+            case CharClass::White:
+                return BONUS_BOUNDARY_WHITE;
+            case CharClass::Delimiter:
+                return BONUS_BOUNDARY_DELIMITER;
+            case CharClass::NonWord:
+                return BONUS_BOUNDARY;
+            default:
+                break;
+            }
+        }
+
+        if ((previous == CharClass::Lower && current == CharClass::Upper) || (previous != CharClass::Number && current == CharClass::Number))
+        {
+            return BONUS_CAMEL;
+        }
+
+        switch (current)
+        {
+        case CharClass::NonWord:
+        case CharClass::Delimiter:
+            return BONUS_NON_WORD;
+        case CharClass::White:
+            return BONUS_BOUNDARY_WHITE;
+        default:
+            return 0;
+        }
+    }
+
+    size_t FuzzyScorer::Find(std::wstring_view text, size_t start, wchar_t c)
+    {
+        size_t i = start;
+
+        if (c >= 0x80)
+        {
+            for (; i < text.size(); i++)
+            {
+                if (Fold(text[i]) == c)
+                {
+                    return i;
+                }
+            }
+            return std::wstring_view::npos;
+        }
+
+        // Setting the case bit folds ASCII letters with one compare, other ASCII characters are compared exactly.
+        // A few non-ASCII code units fold to ASCII as well, like the Kelvin sign to 'k', those are checked with Fold
+        wchar_t caseBit = (c >= L'a' && c <= L'z') ? 0x20 : 0;
+        bool isFoldedFromNonAscii = GetTables().foldedFromNonAscii[c];
+        auto isMatch = [&](wchar_t textChar)
+            {
+                return textChar < 0x80 ? (textChar | caseBit) == c : isFoldedFromNonAscii && Fold(textChar) == c;
+            };
+
+#if defined(_M_X64)
+        const __m128i target = _mm_set1_epi16(static_cast<short>(c));
+        const __m128i mask = _mm_set1_epi16(static_cast<short>(caseBit));
+        const __m128i nonAsciiMask = _mm_set1_epi16(static_cast<short>(isFoldedFromNonAscii ? 0xFF80 : 0));
+        const __m128i zero = _mm_setzero_si128();
+
+        for (; i + 8 <= text.size(); i += 8)
+        {
+            __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + i));
+            __m128i matches = _mm_cmpeq_epi16(_mm_or_si128(chars, mask), target);
+            __m128i asciiChars = _mm_cmpeq_epi16(_mm_and_si128(chars, nonAsciiMask), zero);
+            uint32_t bits = static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(matches, _mm_xor_si128(asciiChars, _mm_cmpeq_epi16(zero, zero)))));
+
+            // Two bits per lane
+            for (; bits != 0; bits &= bits - 1, bits &= bits - 1)
+            {
+                size_t position = i + std::countr_zero(bits) / 2;
+                if (isMatch(text[position]))
+                {
+                    return position;
+                }
+            }
+        }
+#elif defined(_M_ARM64)
+        const uint16x8_t target = vdupq_n_u16(c);
+        const uint16x8_t mask = vdupq_n_u16(caseBit);
+        const uint16x8_t nonAsciiMask = vdupq_n_u16(isFoldedFromNonAscii ? 0xFF80 : 0);
+
+        for (; i + 8 <= text.size(); i += 8)
+        {
+            uint16x8_t chars = vld1q_u16(reinterpret_cast<const uint16_t*>(text.data() + i));
+            if (vmaxvq_u16(vorrq_u16(vceqq_u16(vorrq_u16(chars, mask), target), vtstq_u16(chars, nonAsciiMask))) != 0)
+            {
+                for (size_t lane = 0; lane < 8; lane++)
+                {
+                    if (isMatch(text[i + lane]))
+                    {
+                        return i + lane;
+                    }
+                }
+            }
+        }
+#endif
+
+        for (; i < text.size(); i++)
+        {
+            if (isMatch(text[i]))
+            {
+                return i;
+            }
+        }
+
+        return std::wstring_view::npos;
+    }
+
+    size_t FuzzyScorer::FindExact(std::wstring_view text, size_t start, std::wstring_view term)
+    {
+        for (size_t position = Find(text, start, term.front()); position != std::wstring_view::npos; position = Find(text, position + 1, term.front()))
+        {
+            if (text.size() - position < term.size())
+            {
+                break;
+            }
+
+            size_t k = 1;
+            while (k < term.size() && Fold(text[position + k]) == term[k])
+            {
+                k++;
+            }
+
+            if (k == term.size())
+            {
+                return position;
+            }
+        }
+
+        return std::wstring_view::npos;
+    }
+
+    std::optional<FuzzyScorer::Window> FuzzyScorer::Match(std::wstring_view text, std::wstring_view term)
+    {
+        // Earliest end of a match. Most texts fail here, before the search for an exact occurrence reads them again
+        size_t first = std::wstring_view::npos;
+        size_t end = 0;
+        for (wchar_t c : term)
+        {
+            size_t position = Find(text, end, c);
+            if (position == std::wstring_view::npos)
+            {
+                return std::nullopt;
+            }
+            first = std::min(first, position);
+            end = position + 1;
+        }
+
+        // No occurrence of the term starts before its first character does
+        if (size_t position = FindExact(text, first, term); position != std::wstring_view::npos)
+        {
+            return Window{ position, position + term.size() };
+        }
+
+        // Going back from there finds the shortest window
+        size_t start = end;
+        for (size_t k = term.size(); k > 0;)
+        {
+            if (Fold(text[--start]) == term[k - 1])
+            {
+                k--;
+            }
+        }
+
+        return Window{ start, end };
+    }
+
+    int32_t FuzzyScorer::ScoreWindow(std::wstring_view text, std::wstring_view term, Window window, std::vector<size_t>* positions)
+    {
+        int32_t score = 0;
+        int32_t firstBonus = 0;
+        size_t consecutive = 0;
+        size_t k = 0;
+        bool isInGap = false;
+        CharClass previousClass = window.start > 0 ? GetClass(text[window.start - 1]) : CharClass::White;
+
+        for (size_t i = window.start; i < window.end; i++)
+        {
+            CharClass charClass = GetClass(text[i]);
+
+            if (k < term.size() && Fold(text[i]) == term[k])
+            {
+                int32_t bonus = GetBonus(previousClass, charClass);
+
+                // A run keeps the bonus of the boundary it started at
+                if (consecutive == 0)
+                {
+                    firstBonus = bonus;
+                }
+                else
+                {
+                    if (bonus >= BONUS_BOUNDARY && bonus > firstBonus)
+                    {
+                        firstBonus = bonus;
+                    }
+                    bonus = std::max({ bonus, firstBonus, BONUS_CONSECUTIVE });
+                }
+
+                score += SCORE_MATCH + (k == 0 ? bonus * BONUS_FIRST_CHAR_MULTIPLIER : bonus);
+                isInGap = false;
+                consecutive++;
+                k++;
+
+                if (positions)
+                {
+                    positions->push_back(i);
+                }
+            }
+            else
+            {
+                score += isInGap ? SCORE_GAP_EXTENSION : SCORE_GAP_START;
+                isInGap = true;
+                consecutive = 0;
+                firstBonus = 0;
+            }
+
+            previousClass = charClass;
+        }
+
+        return score;
+    }
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include "pch.h"
+#include <array>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace winrt::Rememory::Core::implementation
+{
+    // fzf-style fuzzy matching. Every whitespace-separated term of the query has to appear in the text in order, ignoring case.
+    // Matches that are contiguous or start words score higher, so "cfgprod" ranks "config-production.yaml" above "config-backup-prod".
+    // An exact occurrence of a term is preferred over a scattered match. Other matches use the shortest window that ends
+    // at the earliest match, as fzf's v1 algorithm does, so the cost stays linear in the length of the text.
+    class FuzzyScorer
+    {
+    public:
+        explicit FuzzyScorer(std::wstring_view query);
+
+        bool IsEmpty() const { return m_terms.empty(); }
+
+        // False if a text with these characters and length can't match, so it doesn't have to be read
+        bool CanMatch(uint64_t characterMask, size_t length) const
+        {
+            return (characterMask & m_requiredMask) == m_requiredMask && length >= m_minLength;
+        }
+
+        // One bit per folded character, ASCII letters and digits have their own bits and other characters share the rest
+        static uint64_t GetCharacterMask(std::wstring_view text);
+
+        // Sum of the term scores, nullopt if a term doesn't match
+        std::optional<int32_t> Score(std::wstring_view text) const;
+
+        // Matched ranges as start and length, sorted and merged. Every occurrence of a term that matches exactly is included
+        std::vector<std::pair<size_t, size_t>> GetSpans(std::wstring_view text) const;
+
+        // Invariant lowercase of a UTF-16 code unit, also used by the regex search
+        static wchar_t Fold(wchar_t c) { return GetTables().fold[c]; }
+
+    private:
+        enum class CharClass : uint8_t
+        {
+            White,
+            NonWord,
+            Delimiter,
+            Lower,
+            Upper,
+            Letter,
+            Number
+        };
+
+        struct Tables
+        {
+            std::array<wchar_t, 0x10000> fold;
+            std::array<CharClass, 0x10000> classes;
+            std::array<bool, 0x80> foldedFromNonAscii;   // ASCII characters that some non-ASCII code unit folds to, like the Kelvin sign to 'k'
+        };
+
+        struct Window
+        {
+            size_t start;
+            size_t end;
+        };
+
+        static constexpr int32_t SCORE_MATCH = 16;
+        static constexpr int32_t SCORE_GAP_START = -3;
+        static constexpr int32_t SCORE_GAP_EXTENSION = -1;
+        static constexpr int32_t BONUS_BOUNDARY = SCORE_MATCH / 2;
+        static constexpr int32_t BONUS_BOUNDARY_WHITE = BONUS_BOUNDARY + 2;
+        static constexpr int32_t BONUS_BOUNDARY_DELIMITER = BONUS_BOUNDARY + 1;
+        static constexpr int32_t BONUS_NON_WORD = SCORE_MATCH / 2;
+        static constexpr int32_t BONUS_CAMEL = BONUS_BOUNDARY + SCORE_GAP_EXTENSION;
+        static constexpr int32_t BONUS_CONSECUTIVE = -(SCORE_GAP_START + SCORE_GAP_EXTENSION);
+        static constexpr int32_t BONUS_FIRST_CHAR_MULTIPLIER = 2;
+
+        std::vector<std::wstring> m_terms;   // Folded
+        uint64_t m_requiredMask = 0;         // Characters of all terms
+        size_t m_minLength = 0;              // Length of the longest term
+
+        static uint64_t GetCharacterBit(wchar_t folded);
+
+        // Lowercase mapping and character class of every UTF-16 code unit, built once
+        static const Tables& GetTables();
+        static CharClass GetClass(wchar_t c) { return GetTables().classes[c]; }
+        static int32_t GetBonus(CharClass previous, CharClass current);
+
+        // Next position of a folded character, compared eight at a time with SIMD
+        static size_t Find(std::wstring_view text, size_t start, wchar_t c);
+        static size_t FindExact(std::wstring_view text, size_t start, std::wstring_view term);
+        static std::optional<Window> Match(std::wstring_view text, std::wstring_view term);
+        static int32_t ScoreWindow(std::wstring_view text, std::wstring_view term, Window window, std::vector<size_t>* positions);
+    };
+}
@@ -0,0 +1,76 @@
+#include "pch.h"
+#include <array>
+#include <bit>
+#include <vector>
+#include "ImageHash.h"
+
+namespace winrt::Rememory::Core::implementation
+{
+    std::optional<uint64_t> ImageHash::ComputeDHash(const BYTE* pixels, uint32_t width, uint32_t height, size_t stride)
+    {
+        if (!pixels || width < GRID_WIDTH || height < GRID_HEIGHT)
+        {
+            return std::nullopt;
+        }
+
+        // Grid column of every source column, computed once instead of per pixel
+        std::vector<uint8_t> cellColumns(width);
+        for (uint32_t x = 0; x < width; x++)
+        {
+            cellColumns[x] = static_cast<uint8_t>(static_cast<uint64_t>(x) * GRID_WIDTH / width);
+        }
+
+        std::array<uint64_t, GRID_WIDTH * GRID_HEIGHT> sums{};
+        std::array<uint64_t, GRID_WIDTH> columnCounts{};
+
+        for (uint32_t y = 0; y < height; y++)
+        {
+            const BYTE* row = pixels + y * stride;
+            size_t cellRow = static_cast<size_t>(static_cast<uint64_t>(y) * GRID_HEIGHT / height) * GRID_WIDTH;
+
+            // Accumulate a row per cell column first; the row loop stays free of divisions and branches
+            std::array<uint32_t, GRID_WIDTH> rowSums{};
+            for (uint32_t x = 0; x < width; x++)
+            {
+                const BYTE* pixel = row + x * 4;
+                rowSums[cellColumns[x]] += (pixel[2] * 77u + pixel[1] * 150u + pixel[0] * 29u) >> 8;   // BT.601 luma
+            }
+
+            for (uint32_t column = 0; column < GRID_WIDTH; column++)
+            {
+                sums[cellRow + column] += rowSums[column];
+            }
+        }
+
+        for (uint32_t x = 0; x < width; x++)
+        {
+            columnCounts[cellColumns[x]]++;
+        }
+
+        uint64_t hash = 0;
+        int bit = 0;
+
+        for (uint32_t cellY = 0; cellY < GRID_HEIGHT; cellY++)
+        {
+            // Every cell of a grid row spans the same source rows, so comparing averages reduces to comparing sum / columnCount
+            for (uint32_t cellX = 0; cellX < GRID_WIDTH - 1; cellX++)
+            {
+                uint64_t left = sums[cellY * GRID_WIDTH + cellX] * columnCounts[cellX + 1];
+                uint64_t right = sums[cellY * GRID_WIDTH + cellX + 1] * columnCounts[cellX];
+
+                if (left > right)
+                {
+                    hash |= 1ull << bit;
+                }
+                bit++;
+            }
+        }
+
+        return hash;
+    }
+
+    int ImageHash::Distance(uint64_t first, uint64_t second)
+    {
+        return std::popcount(first ^ second);
+    }
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include "pch.h"
+#include <optional>
+
+namespace winrt::Rememory::Core::implementation
+{
+    // Perceptual hashing of captured images, used to spot near-identical screenshots
+    class ImageHash
+    {
+    public:
+        // 64-bit difference hash (dHash) of a top-down 32bpp BGRA buffer.
+        // The image is box-averaged to a 9x8 grayscale grid and each bit records whether a cell is brighter than its right neighbour.
+        // Returns nothing for images smaller than the grid.
+        static std::optional<uint64_t> ComputeDHash(const BYTE* pixels, uint32_t width, uint32_t height, size_t stride);
+
+        static int Distance(uint64_t first, uint64_t second);
+
+    private:
+        static constexpr uint32_t GRID_WIDTH = 9;
+        static constexpr uint32_t GRID_HEIGHT = 8;
+    };
+}
@@ -0,0 +1,8 @@
+#include "pch.h"
+#include "MetricSummary.h"
+#include "MetricSummary.g.cpp"
+
+namespace winrt::Rememory::Core::implementation
+{
+
+}
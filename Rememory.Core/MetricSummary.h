@@ -0,0 +1,46 @@
+#pragma once
+#include "pch.h"
+#include "MetricSummary.g.h"
+
+namespace winrt::Rememory::Core::implementation
+{
+    struct MetricSummary : MetricSummaryT<MetricSummary>
+    {
+        MetricSummary() = default;
+
+        winrt::hstring Name() const { return m_name; }
+        void Name(winrt::hstring const& value) { m_name = value; }
+
+        uint64_t Count() const { return m_count; }
+        void Count(uint64_t value) { m_count = value; }
+
+        winrt::Windows::Foundation::TimeSpan Total() const { return m_total; }
+        void Total(winrt::Windows::Foundation::TimeSpan const& value) { m_total = value; }
+
+        winrt::Windows::Foundation::TimeSpan Median() const { return m_median; }
+        void Median(winrt::Windows::Foundation::TimeSpan const& value) { m_median = value; }
+
+        winrt::Windows::Foundation::TimeSpan P95() const { return m_p95; }
+        void P95(winrt::Windows::Foundation::TimeSpan const& value) { m_p95 = value; }
+
+        winrt::Windows::Foundation::TimeSpan P99() const { return m_p99; }
+        void P99(winrt::Windows::Foundation::TimeSpan const& value) { m_p99 = value; }
+
+        winrt::Windows::Foundation::TimeSpan Max() const { return m_max; }
+        void Max(winrt::Windows::Foundation::TimeSpan const& value) { m_max = value; }
+
+    private:
+        winrt::hstring m_name {};
+        uint64_t m_count {};
+        winrt::Windows::Foundation::TimeSpan m_total {};
+        winrt::Windows::Foundation::TimeSpan m_median {};
+        winrt::Windows::Foundation::TimeSpan m_p95 {};
+        winrt::Windows::Foundation::TimeSpan m_p99 {};
+        winrt::Windows::Foundation::TimeSpan m_max {};
+    };
+}
+
+namespace winrt::Rememory::Core::factory_implementation
+{
+    struct MetricSummary : MetricSummaryT<MetricSummary, implementation::MetricSummary> {};
+}
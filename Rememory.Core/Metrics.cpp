@@ -0,0 +1,232 @@
+#include "pch.h"
+#include <algorithm>
+#include <bit>
+#include <format>
+#include "Metrics.h"
+
+namespace {
+    const wchar_t* const METRIC_NAMES[] = { L"Debounce", L"OpenClipboard", L"CopyFormat", L"Hash", L"ImageHash", L"SaveToFile", L"Dispatch", L"Paste", L"PrefetchedPaste", L"PreparePaste", L"Encrypt", L"Decrypt", L"CompressText", L"DecompressText", L"FuzzySearch", L"RegexSearch", L"Query" };
+    const wchar_t* const COUNTER_NAMES[] = { L"Captures", L"RepeatedCaptures", L"OpenClipboardRetries", L"OpenClipboardFailures", L"CopiedBytes", L"SupersededCaptures", L"SkippedFileWrites", L"PasteCacheHits", L"PasteCacheMisses", L"SharedMemoryResponses", L"UnreadableSealedTexts" };
+    const wchar_t* const GAUGE_NAMES[] = { L"CompressedTexts", L"CompressedTextBytes", L"CompressedTextSavedBytes", L"PasteCacheBytes", L"DecompressedTextCacheBytes" };
+}
+
+namespace winrt::Rememory::Core::implementation
+{
+    std::array<Metrics::Timing, static_cast<size_t>(MetricId::Count)> Metrics::s_timings{};
+    std::array<std::atomic<uint64_t>, static_cast<size_t>(CounterId::Count)> Metrics::s_counters{};
+    std::array<std::atomic<int64_t>, static_cast<size_t>(GaugeId::Count)> Metrics::s_gauges{};
+    std::array<Metrics::TraceEvent, Metrics::TRACE_CAPACITY> Metrics::s_trace{};
+    std::atomic<uint64_t> Metrics::s_traceNext{};
+    std::atomic<uint64_t> Metrics::s_traceStart{};
+
+    int64_t Metrics::Now()
+    {
+        LARGE_INTEGER counter;
+        QueryPerformanceCounter(&counter);
+        return counter.QuadPart;
+    }
+
+    void Metrics::Record(MetricId id, int64_t start, int64_t end)
+    {
+        uint64_t microseconds = ToMicroseconds(std::max<int64_t>(end - start, 0));
+
+        Timing& timing = s_timings[static_cast<size_t>(id)];
+        timing.count.fetch_add(1, std::memory_order_relaxed);
+        timing.totalMicroseconds.fetch_add(microseconds, std::memory_order_relaxed);
+        timing.buckets[GetBucket(microseconds)].fetch_add(1, std::memory_order_relaxed);
+
+        uint64_t max = timing.maxMicroseconds.load(std::memory_order_relaxed);
+        while (microseconds > max && !timing.maxMicroseconds.compare_exchange_weak(max, microseconds, std::memory_order_relaxed))
+        {
+        }
+
+        uint64_t index = s_traceNext.fetch_add(1, std::memory_order_relaxed);
+        TraceEvent& event = s_trace[index % TRACE_CAPACITY];
+
+        event.sequence.store(index * 2 + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        event.id.store(static_cast<uint32_t>(id), std::memory_order_relaxed);
+        event.threadId.store(GetCurrentThreadId(), std::memory_order_relaxed);
+        event.start.store(start, std::memory_order_relaxed);
+        event.end.store(end, std::memory_order_relaxed);
+        event.sequence.store(index * 2 + 2, std::memory_order_release);
+    }
+
+    void Metrics::Increment(CounterId id, uint64_t value)
+    {
+        s_counters[static_cast<size_t>(id)].fetch_add(value, std::memory_order_relaxed);
+    }
+
+    void Metrics::Add(GaugeId id, int64_t value)
+    {
+        s_gauges[static_cast<size_t>(id)].fetch_add(value, std::memory_order_relaxed);
+    }
+
+    Metrics::Summary Metrics::GetSummary(MetricId id)
+    {
+        const Timing& timing = s_timings[static_cast<size_t>(id)];
+
+        Summary summary;
+        summary.count = timing.count.load(std::memory_order_relaxed);
+        summary.totalMicroseconds = timing.totalMicroseconds.load(std::memory_order_relaxed);
+        summary.maxMicroseconds = timing.maxMicroseconds.load(std::memory_order_relaxed);
+
+        if (summary.count > 0)
+        {
+            // Bucket bounds overestimate, the max is exact
+            summary.medianMicroseconds = std::min(GetPercentile(timing, summary.count, 0.5), summary.maxMicroseconds);
+            summary.p95Microseconds = std::min(GetPercentile(timing, summary.count, 0.95), summary.maxMicroseconds);
+            summary.p99Microseconds = std::min(GetPercentile(timing, summary.count, 0.99), summary.maxMicroseconds);
+        }
+
+        return summary;
+    }
+
+    uint64_t Metrics::GetCounter(CounterId id)
+    {
+        return s_counters[static_cast<size_t>(id)].load(std::memory_order_relaxed);
+    }
+
+    int64_t Metrics::GetGauge(GaugeId id)
+    {
+        return s_gauges[static_cast<size_t>(id)].load(std::memory_order_relaxed);
+    }
+
+    const wchar_t* Metrics::GetName(MetricId id)
+    {
+        return METRIC_NAMES[static_cast<size_t>(id)];
+    }
+
+    const wchar_t* Metrics::GetName(CounterId id)
+    {
+        return COUNTER_NAMES[static_cast<size_t>(id)];
+    }
+
+    const wchar_t* Metrics::GetName(GaugeId id)
+    {
+        return GAUGE_NAMES[static_cast<size_t>(id)];
+    }
+
+    std::wstring Metrics::ExportTrace()
+    {
+        uint64_t next = s_traceNext.load(std::memory_order_acquire);
+        uint64_t first = std::max(next > TRACE_CAPACITY ? next - TRACE_CAPACITY : 0, s_traceStart.load(std::memory_order_relaxed));
+        DWORD processId = GetCurrentProcessId();
+
+        std::wstring json = L"{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool isFirstEvent = true;
+
+        for (uint64_t index = first; index < next; index++)
+        {
+            const TraceEvent& event = s_trace[index % TRACE_CAPACITY];
+
+            // Skip events that are being written or were already overwritten
+            uint64_t sequence = event.sequence.load(std::memory_order_acquire);
+            uint32_t id = event.id.load(std::memory_order_relaxed);
+            uint32_t threadId = event.threadId.load(std::memory_order_relaxed);
+            int64_t start = event.start.load(std::memory_order_relaxed);
+            int64_t end = event.end.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (sequence != index * 2 + 2 || event.sequence.load(std::memory_order_relaxed) != sequence
+                || id >= static_cast<uint32_t>(MetricId::Count))
+            {
+                continue;
+            }
+
+            json += std::format(L"{}{{\"name\":\"{}\",\"cat\":\"Rememory.Core\",\"ph\":\"X\",\"ts\":{},\"dur\":{},\"pid\":{},\"tid\":{}}}",
+                isFirstEvent ? L"" : L",", METRIC_NAMES[id], ToMicroseconds(start), ToMicroseconds(std::max<int64_t>(end - start, 0)), processId, threadId);
+            isFirstEvent = false;
+        }
+
+        json += L"]}";
+        return json;
+    }
+
+    void Metrics::Reset()
+    {
+        for (Timing& timing : s_timings)
+        {
+            timing.count.store(0, std::memory_order_relaxed);
+            timing.totalMicroseconds.store(0, std::memory_order_relaxed);
+            timing.maxMicroseconds.store(0, std::memory_order_relaxed);
+
+            for (auto& bucket : timing.buckets)
+            {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        for (auto& counter : s_counters)
+        {
+            counter.store(0, std::memory_order_relaxed);
+        }
+
+        s_traceStart.store(s_traceNext.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    int64_t Metrics::Frequency()
+    {
+        static const int64_t frequency = []()
+            {
+                LARGE_INTEGER value;
+                QueryPerformanceFrequency(&value);
+                return value.QuadPart;
+            }();
+        return frequency;
+    }
+
+    uint64_t Metrics::ToMicroseconds(int64_t ticks)
+    {
+        // Split to keep ticks * 1'000'000 from overflowing on a long uptime
+        int64_t frequency = Frequency();
+        return static_cast<uint64_t>(ticks / frequency * 1'000'000 + ticks % frequency * 1'000'000 / frequency);
+    }
+
+    uint32_t Metrics::GetBucket(uint64_t microseconds)
+    {
+        if (microseconds < SUB_BUCKET_COUNT)
+        {
+            return static_cast<uint32_t>(microseconds);
+        }
+
+        uint32_t shift = static_cast<uint32_t>(std::bit_width(microseconds)) - 1 - SUB_BUCKET_BITS;
+        uint32_t subBucket = static_cast<uint32_t>(microseconds >> shift) & (SUB_BUCKET_COUNT - 1);
+        return (shift + 1) * SUB_BUCKET_COUNT + subBucket;
+    }
+
+    uint64_t Metrics::GetBucketUpperBound(uint32_t bucket)
+    {
+        if (bucket < SUB_BUCKET_COUNT)
+        {
+            return bucket;
+        }
+
+        uint32_t shift = bucket / SUB_BUCKET_COUNT - 1;
+        uint64_t subBucket = bucket % SUB_BUCKET_COUNT;
+
+        if (shift + SUB_BUCKET_BITS + 1 >= 64)
+        {
+            return UINT64_MAX;
+        }
+
+        return ((SUB_BUCKET_COUNT + subBucket + 1) << shift) - 1;
+    }
+
+    uint64_t Metrics::GetPercentile(const Timing& timing, uint64_t count, double percentile)
+    {
+        uint64_t target = std::max<uint64_t>(static_cast<uint64_t>(count * percentile + 0.5), 1);
+        uint64_t seen = 0;
+
+        for (uint32_t bucket = 0; bucket < BUCKET_COUNT; bucket++)
+        {
+            seen += timing.buckets[bucket].load(std::memory_order_relaxed);
+            if (seen >= target)
+            {
+                return GetBucketUpperBound(bucket);
+            }
+        }
+
+        return timing.maxMicroseconds.load(std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,146 @@
+#pragma once
+#include "pch.h"
+#include <array>
+#include <atomic>
+#include <string>
+
+namespace winrt::Rememory::Core::implementation
+{
+    // Timed steps of the capture and paste paths
+    enum class MetricId : uint32_t
+    {
+        Debounce,         // From the clipboard update to the start of the capture
+        OpenClipboard,    // Including retries while another app holds the clipboard
+        CopyFormat,       // Copy of one format out of the clipboard
+        Hash,
+        ImageHash,        // Perceptual hash for similar image detection
+        SaveToFile,
+        Dispatch,         // ContentDetected handlers
+        Paste,
+        PrefetchedPaste,  // Paste that only handed over blocks prepared ahead
+        PreparePaste,     // Reading and decoding one file ahead of a paste
+        Encrypt,          // One chunk of sealed history data
+        Decrypt,
+        CompressText,     // Moving cold clip text into compressed memory
+        DecompressText,   // Only reads the decompressed text cache couldn't answer
+        FuzzySearch,      // Ranking the clips for a search query
+        RegexSearch,
+        Query,            // Answering a query from the command line, including the history snapshot
+        Count
+    };
+
+    enum class CounterId : uint32_t
+    {
+        Captures,
+        RepeatedCaptures,         // Same content as the previous capture, dropped before saving
+        OpenClipboardRetries,
+        OpenClipboardFailures,
+        CopiedBytes,
+        SupersededCaptures,       // Replaced by a newer capture while staged, never saved
+        SkippedFileWrites,        // History files the superseded captures would have written
+        PasteCacheHits,
+        PasteCacheMisses,         // History files pasted without prepared blocks
+        SharedMemoryResponses,    // Query results handed over in a section instead of through the pipe
+        UnreadableSealedTexts,    // Sealed with a key that is no longer available, or damaged
+        Count
+    };
+
+    // Current values rather than totals, so they are not cleared by a reset
+    enum class GaugeId : uint32_t
+    {
+        CompressedTexts,
+        CompressedTextBytes,
+        CompressedTextSavedBytes,   // Size of the original texts minus their compressed size
+        PasteCacheBytes,
+        DecompressedTextCacheBytes,   // Decompressed cold texts kept for repeated reads
+        Count
+    };
+
+    // Low-overhead instrumentation of the core hot paths.
+    // Counters and log-linear latency histograms are relaxed atomics, and the most recent timings are kept in a ring
+    // that can be exported as Chrome trace JSON (chrome://tracing, Perfetto).
+    class Metrics
+    {
+    public:
+        // Times the enclosing block
+        class Scope
+        {
+        public:
+            explicit Scope(MetricId id) : m_id(id), m_start(Now()) {}
+            ~Scope() { Record(m_id, m_start, Now()); }
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            MetricId m_id;
+            int64_t m_start;
+        };
+
+        struct Summary
+        {
+            uint64_t count = 0;
+            uint64_t totalMicroseconds = 0;
+            uint64_t medianMicroseconds = 0;
+            uint64_t p95Microseconds = 0;
+            uint64_t p99Microseconds = 0;
+            uint64_t maxMicroseconds = 0;
+        };
+
+        // Performance counter ticks
+        static int64_t Now();
+
+        static void Record(MetricId id, int64_t start, int64_t end);
+        static void Increment(CounterId id, uint64_t value = 1);
+        static void Add(GaugeId id, int64_t value);
+
+        static Summary GetSummary(MetricId id);
+        static uint64_t GetCounter(CounterId id);
+        static int64_t GetGauge(GaugeId id);
+        static const wchar_t* GetName(MetricId id);
+        static const wchar_t* GetName(CounterId id);
+        static const wchar_t* GetName(GaugeId id);
+
+        static std::wstring ExportTrace();
+        static void Reset();
+
+    private:
+        // Values below 2^SUB_BUCKET_BITS microseconds get exact buckets,
+        // larger ones share 2^SUB_BUCKET_BITS buckets per power of two (under 13% error)
+        static constexpr uint32_t SUB_BUCKET_BITS = 3;
+        static constexpr uint32_t SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+        static constexpr uint32_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+        static constexpr size_t TRACE_CAPACITY = 4096;
+
+        struct Timing
+        {
+            std::atomic<uint64_t> count{};
+            std::atomic<uint64_t> totalMicroseconds{};
+            std::atomic<uint64_t> maxMicroseconds{};
+            std::array<std::atomic<uint32_t>, BUCKET_COUNT> buckets{};
+        };
+
+        // Fields are written between two updates of sequence, a reader skips entries whose sequence is odd or changed
+        struct TraceEvent
+        {
+            std::atomic<uint64_t> sequence{};
+            std::atomic<uint32_t> id{};
+            std::atomic<uint32_t> threadId{};
+            std::atomic<int64_t> start{};
+            std::atomic<int64_t> end{};
+        };
+
+        static std::array<Timing, static_cast<size_t>(MetricId::Count)> s_timings;
+        static std::array<std::atomic<uint64_t>, static_cast<size_t>(CounterId::Count)> s_counters;
+        static std::array<std::atomic<int64_t>, static_cast<size_t>(GaugeId::Count)> s_gauges;
+        static std::array<TraceEvent, TRACE_CAPACITY> s_trace;
+        static std::atomic<uint64_t> s_traceNext;
+        static std::atomic<uint64_t> s_traceStart;   // First event after the last reset
+
+        static int64_t Frequency();
+        static uint64_t ToMicroseconds(int64_t ticks);
+        static uint32_t GetBucket(uint64_t microseconds);
+        static uint64_t GetBucketUpperBound(uint32_t bucket);
+        static uint64_t GetPercentile(const Timing& timing, uint64_t count, double percentile);
+    };
+}
@@ -0,0 +1,280 @@
+#include "pch.h"
+#include <algorithm>
+#include "PasteCache.h"
+#include "FormatManager.h"
+#include "Metrics.h"
+
+namespace winrt::Rememory::Core::implementation
+{
+    void PasteCache::SetCandidates(std::vector<std::pair<ClipboardFormat, std::wstring>> candidates)
+    {
+        std::lock_guard lock{ s_mutex };
+
+        if (s_isShutDown)
+        {
+            return;
+        }
+
+        s_candidates = std::move(candidates);
+
+        // A file that failed is tried again once it left the candidates or changed format
+        std::erase_if(s_skipped, [](const auto& skipped)
+            {
+                return std::none_of(s_candidates.begin(), s_candidates.end(), [&skipped](const auto& candidate)
+                    {
+                        return candidate.second == skipped.first && candidate.first == skipped.second.format;
+                    });
+            });
+
+        for (auto it = s_entries.begin(); it != s_entries.end();)
+        {
+            bool isCandidate = std::any_of(s_candidates.begin(), s_candidates.end(), [&it](const auto& candidate)
+                {
+                    return candidate.second == it->first;
+                });
+
+            if (isCandidate)
+            {
+                ++it;
+            }
+            else
+            {
+                Release(it++);
+            }
+        }
+
+        StartPreparing();
+    }
+
+    bool PasteCache::TryLoadToClipboard(ClipboardFormat format, const std::wstring& path)
+    {
+        Entry entry;
+        {
+            std::lock_guard lock{ s_mutex };
+
+            auto it = s_entries.find(path);
+            if (it == s_entries.end() || it->second.format != format)
+            {
+                Metrics::Increment(CounterId::PasteCacheMisses);
+                return false;
+            }
+
+            entry = std::move(it->second);
+            s_size -= entry.size;
+            s_entries.erase(it);
+            Metrics::Add(GaugeId::PasteCacheBytes, -static_cast<int64_t>(entry.size));
+
+            StartPreparing();
+        }
+
+        Metrics::Increment(CounterId::PasteCacheHits);
+
+        bool isLoaded = false;
+        for (Block& block : entry.blocks)
+        {
+            if (SetClipboardData(block.formatId, block.hGlobal))
+            {
+                isLoaded = true;
+            }
+            else
+            {
+                GlobalFree(block.hGlobal);
+            }
+        }
+
+        return isLoaded;
+    }
+
+    void PasteCache::Shutdown()
+    {
+        std::unique_lock lock{ s_mutex };
+
+        s_isShutDown = true;
+        s_candidates.clear();
+        s_preparingDone.wait(lock, [] { return !s_isPreparing; });
+
+        while (!s_entries.empty())
+        {
+            Release(s_entries.begin());
+        }
+    }
+
+    void PasteCache::StartPreparing()
+    {
+        if (!s_isPreparing && !s_isShutDown)
+        {
+            s_isPreparing = true;
+            PrepareAsync();
+        }
+    }
+
+    void PasteCache::Release(std::unordered_map<std::wstring, Entry>::iterator it)
+    {
+        s_size -= it->second.size;
+        Metrics::Add(GaugeId::PasteCacheBytes, -static_cast<int64_t>(it->second.size));
+        Free(it->second);
+        s_entries.erase(it);
+    }
+
+    bool PasteCache::MakeRoom(size_t size, size_t priority)
+    {
+        if (size > MEMORY_BUDGET)
+        {
+            return false;
+        }
+
+        // Entries of lower priority give way, starting with the lowest
+        for (size_t i = s_candidates.size(); i > priority + 1 && s_size + size > MEMORY_BUDGET; i--)
+        {
+            if (auto it = s_entries.find(s_candidates[i - 1].second); it != s_entries.end())
+            {
+                Release(it);
+            }
+        }
+
+        return s_size + size <= MEMORY_BUDGET;
+    }
+
+    size_t PasteCache::GetRoom(size_t priority)
+    {
+        size_t lowerPrioritySize = 0;
+        for (size_t i = priority + 1; i < s_candidates.size(); i++)
+        {
+            if (auto it = s_entries.find(s_candidates[i].second); it != s_entries.end())
+            {
+                lowerPrioritySize += it->second.size;
+            }
+        }
+
+        return MEMORY_BUDGET - (s_size - lowerPrioritySize);
+    }
+
+    bool PasteCache::IsSkipped(const std::wstring& path, size_t priority)
+    {
+        auto it = s_skipped.find(path);
+        if (it == s_skipped.end())
+        {
+            return false;
+        }
+
+        // A file that didn't fit is tried again once pastes, evictions or a higher priority made room for it
+        return it->second.size == 0 || it->second.size > GetRoom(priority);
+    }
+
+    winrt::fire_and_forget PasteCache::PrepareAsync()
+    {
+        co_await winrt::resume_background();
+
+        while (true)
+        {
+            ClipboardFormat format{};
+            std::wstring path;
+            {
+                std::lock_guard lock{ s_mutex };
+
+                auto next = s_candidates.end();
+                for (size_t i = 0; i < s_candidates.size(); i++)
+                {
+                    if (!s_entries.contains(s_candidates[i].second) && !IsSkipped(s_candidates[i].second, i))
+                    {
+                        next = s_candidates.begin() + i;
+                        break;
+                    }
+                }
+
+                if (next == s_candidates.end())
+                {
+                    s_isPreparing = false;
+                    s_preparingDone.notify_all();
+                    co_return;
+                }
+
+                std::tie(format, path) = *next;
+            }
+
+            std::optional<Entry> entry;
+            {
+                Metrics::Scope scope{ MetricId::PreparePaste };
+                entry = Prepare(format, path);
+            }
+
+            std::lock_guard lock{ s_mutex };
+
+            // The candidates may have changed while the file was prepared
+            auto candidate = std::find_if(s_candidates.begin(), s_candidates.end(), [&path](const auto& candidate)
+                {
+                    return candidate.second == path;
+                });
+
+            bool isWanted = candidate != s_candidates.end() && candidate->first == format && !s_entries.contains(path);
+            size_t priority = static_cast<size_t>(candidate - s_candidates.begin());
+
+            if (entry && isWanted && MakeRoom(entry->size, priority))
+            {
+                s_size += entry->size;
+                Metrics::Add(GaugeId::PasteCacheBytes, static_cast<int64_t>(entry->size));
+                s_entries.emplace(path, std::move(*entry));
+            }
+            else
+            {
+                if (entry)
+                {
+                    Free(*entry);
+                }
+
+                if (isWanted)
+                {
+                    s_skipped.insert_or_assign(path, Skipped{ format, entry ? entry->size : 0 });
+                }
+            }
+        }
+    }
+
+    std::optional<PasteCache::Entry> PasteCache::Prepare(ClipboardFormat format, const std::wstring& path)
+    {
+        if (format != ClipboardFormat::Png && format != ClipboardFormat::Bitmap && format != ClipboardFormat::Html && format != ClipboardFormat::Rtf)
+        {
+            return std::nullopt;
+        }
+
+        // Same blocks as the format loaders of FormatManager set, images also get a CF_DIB
+        Entry entry{ format };
+
+        if (format != ClipboardFormat::Bitmap)
+        {
+            if (HGLOBAL hGlobal = FormatManager::ReadHistoryFileToGlobal(path))
+            {
+                entry.blocks.push_back({ FormatManager::GetRule(format)->clipboardIds.front(), hGlobal });
+            }
+        }
+
+        if (format == ClipboardFormat::Png || format == ClipboardFormat::Bitmap)
+        {
+            if (HGLOBAL hGlobal = FormatManager::ReadImageFileToDib(path))
+            {
+                entry.blocks.push_back({ CF_DIB, hGlobal });
+            }
+        }
+
+        if (entry.blocks.empty())
+        {
+            return std::nullopt;
+        }
+
+        for (const Block& block : entry.blocks)
+        {
+            entry.size += GlobalSize(block.hGlobal);
+        }
+
+        return entry;
+    }
+
+    void PasteCache::Free(Entry& entry)
+    {
+        for (const Block& block : entry.blocks)
+        {
+            GlobalFree(block.hGlobal);
+        }
+        entry.blocks.clear();
+    }
+}
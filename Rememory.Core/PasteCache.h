@@ -0,0 +1,70 @@
+#pragma once
+#include "pch.h"
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "winrt/Rememory.Core.h"
+
+namespace winrt::Rememory::Core::implementation
+{
+    // Clipboard blocks of the history files most likely to be pasted next, read and decoded in the background,
+    // so a paste only hands the prepared blocks over to the clipboard.
+    // The clipboard owns a block once it's pasted, so the file is prepared again for the next paste.
+    class PasteCache
+    {
+    public:
+        static constexpr size_t MEMORY_BUDGET = 64 * 1024 * 1024;
+
+        // Files in order of priority, prepared ones that are no longer listed are released
+        static void SetCandidates(std::vector<std::pair<ClipboardFormat, std::wstring>> candidates);
+
+        // Sets the prepared blocks of the file as clipboard data, false if they aren't ready
+        static bool TryLoadToClipboard(ClipboardFormat format, const std::wstring& path);
+
+        // Waits for the file being prepared and releases everything, images are decoded with GDI+ that is shut down next
+        static void Shutdown();
+
+    private:
+        struct Block
+        {
+            UINT formatId;
+            HGLOBAL hGlobal;
+        };
+
+        struct Entry
+        {
+            ClipboardFormat format{};
+            std::vector<Block> blocks;
+            size_t size = 0;
+        };
+
+        struct Skipped
+        {
+            ClipboardFormat format{};
+            size_t size = 0;   // What it needed when it didn't fit the budget, 0 if it couldn't be read
+        };
+
+        static inline std::mutex s_mutex{};
+        static inline std::condition_variable s_preparingDone{};
+        static inline std::vector<std::pair<ClipboardFormat, std::wstring>> s_candidates{};
+        static inline std::unordered_map<std::wstring, Entry> s_entries{};
+        static inline std::unordered_map<std::wstring, Skipped> s_skipped{};   // Until they stop being candidates, over the budget ones also until there's room
+        static inline size_t s_size = 0;
+        static inline bool s_isPreparing = false;
+        static inline bool s_isShutDown = false;
+
+        // Expects the mutex to be held
+        static void StartPreparing();
+        static void Release(std::unordered_map<std::wstring, Entry>::iterator it);
+        static bool MakeRoom(size_t size, size_t priority);
+        static size_t GetRoom(size_t priority);   // Bytes a candidate of this priority can have once lower ones give way
+        static bool IsSkipped(const std::wstring& path, size_t priority);
+
+        static winrt::fire_and_forget PrepareAsync();
+        static std::optional<Entry> Prepare(ClipboardFormat format, const std::wstring& path);
+        static void Free(Entry& entry);
+    };
+}
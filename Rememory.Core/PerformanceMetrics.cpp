@@ -0,0 +1,69 @@
+#include "pch.h"
+#include <algorithm>
+#include <map>
+#include "PerformanceMetrics.h"
+#include "PerformanceMetrics.g.cpp"
+#include "MetricSummary.h"
+#include "Metrics.h"
+
+namespace {
+    winrt::Windows::Foundation::TimeSpan FromMicroseconds(uint64_t microseconds)
+    {
+        return std::chrono::duration_cast<winrt::Windows::Foundation::TimeSpan>(std::chrono::microseconds{ microseconds });
+    }
+}
+
+namespace winrt::Rememory::Core::implementation
+{
+    winrt::Windows::Foundation::Collections::IVectorView<Rememory::Core::MetricSummary> PerformanceMetrics::GetTimings()
+    {
+        std::vector<Rememory::Core::MetricSummary> timings;
+
+        for (uint32_t i = 0; i < static_cast<uint32_t>(MetricId::Count); i++)
+        {
+            auto id = static_cast<MetricId>(i);
+            auto summary = Metrics::GetSummary(id);
+
+            auto timing = winrt::make<implementation::MetricSummary>();
+            timing.Name(Metrics::GetName(id));
+            timing.Count(summary.count);
+            timing.Total(FromMicroseconds(summary.totalMicroseconds));
+            timing.Median(FromMicroseconds(summary.medianMicroseconds));
+            timing.P95(FromMicroseconds(summary.p95Microseconds));
+            timing.P99(FromMicroseconds(summary.p99Microseconds));
+            timing.Max(FromMicroseconds(summary.maxMicroseconds));
+            timings.push_back(std::move(timing));
+        }
+
+        return winrt::single_threaded_vector(std::move(timings)).GetView();
+    }
+
+    winrt::Windows::Foundation::Collections::IMapView<winrt::hstring, uint64_t> PerformanceMetrics::GetCounters()
+    {
+        std::map<winrt::hstring, uint64_t> counters;
+
+        for (uint32_t i = 0; i < static_cast<uint32_t>(CounterId::Count); i++)
+        {
+            auto id = static_cast<CounterId>(i);
+            counters.emplace(Metrics::GetName(id), Metrics::GetCounter(id));
+        }
+
+        for (uint32_t i = 0; i < static_cast<uint32_t>(GaugeId::Count); i++)
+        {
+            auto id = static_cast<GaugeId>(i);
+            counters.emplace(Metrics::GetName(id), static_cast<uint64_t>(std::max<int64_t>(Metrics::GetGauge(id), 0)));
+        }
+
+        return winrt::single_threaded_map(std::move(counters)).GetView();
+    }
+
+    winrt::hstring PerformanceMetrics::ExportTrace()
+    {
+        return winrt::hstring{ Metrics::ExportTrace() };
+    }
+
+    void PerformanceMetrics::Reset()
+    {
+        Metrics::Reset();
+    }
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include "pch.h"
+#include "PerformanceMetrics.g.h"
+
+namespace winrt::Rememory::Core::implementation
+{
+    struct PerformanceMetrics : PerformanceMetricsT<PerformanceMetrics>
+    {
+        static winrt::Windows::Foundation::Collections::IVectorView<Rememory::Core::MetricSummary> GetTimings();
+        static winrt::Windows::Foundation::Collections::IMapView<winrt::hstring, uint64_t> GetCounters();
+        static winrt::hstring ExportTrace();
+        static void Reset();
+    };
+}
+
+namespace winrt::Rememory::Core::factory_implementation
+{
+    struct PerformanceMetrics : PerformanceMetricsT<PerformanceMetrics, implementation::PerformanceMetrics> {};
+}
@@ -0,0 +1,142 @@
+#include "pch.h"
+#include "QueryClient.h"
+#include "QueryClient.g.cpp"
+
+namespace {
+    [[noreturn]] void ThrowDisconnected()
+    {
+        winrt::throw_hresult(HRESULT_FROM_WIN32(ERROR_PIPE_NOT_CONNECTED));
+    }
+}
+
+namespace winrt::Rememory::Core::implementation
+{
+    winrt::Windows::Foundation::Collections::IVectorView<Rememory::Core::QueryItem> QueryClient::List(uint32_t count)
+    {
+        return Send(QueryProtocol::Command::List, QueryProtocol::Flags::None, count, {});
+    }
+
+    winrt::Windows::Foundation::Collections::IVectorView<Rememory::Core::QueryItem> QueryClient::Get(uint32_t index)
+    {
+        return Send(QueryProtocol::Command::Get, QueryProtocol::Flags::None, index, {});
+    }
+
+    winrt::Windows::Foundation::Collections::IVectorView<Rememory::Core::QueryItem> QueryClient::Search(winrt::hstring const& query, uint32_t maxCount)
+    {
+        return Send(QueryProtocol::Command::Search, QueryProtocol::Flags::None, maxCount, query);
+    }
+
+    winrt::Windows::Foundation::Collections::IVectorView<Rememory::Core::QueryItem> QueryClient::SearchRegex(winrt::hstring const& pattern, bool ignoreCase, uint32_t maxCount)
+    {
+        auto flags = ignoreCase ? QueryProtocol::Flags::IgnoreCase : QueryProtocol::Flags::None;
+        return Send(QueryProtocol::Command::SearchRegex, flags, maxCount, pattern);
+    }
+
+    winrt::Windows::Foundation::Collections::IVectorView<Rememory::Core::QueryItem> QueryClient::Send(QueryProtocol::Command command, QueryProtocol::Flags flags, uint32_t argument, std::wstring_view query)
+    {
+        if (query.size() > QueryProtocol::MAX_QUERY_LENGTH)
+        {
+            throw winrt::hresult_invalid_argument(L"The query is too long, at most " + winrt::to_hstring(QueryProtocol::MAX_QUERY_LENGTH) + L" characters are allowed.");
+        }
+
+        auto pipe = Connect();
+
+        QueryProtocol::RequestHeader request{ QueryProtocol::MAGIC, command, flags, 0, argument, static_cast<uint32_t>(query.size()) };
+        if (!QueryProtocol::Write(pipe.get(), &request, sizeof(request))
+            || (!query.empty() && !QueryProtocol::Write(pipe.get(), query.data(), query.size() * sizeof(wchar_t))))
+        {
+            ThrowDisconnected();
+        }
+
+        QueryProtocol::ResponseHeader response{};
+        if (!QueryProtocol::Read(pipe.get(), &response, sizeof(response)))
+        {
+            ThrowDisconnected();
+        }
+
+        if (response.magic != QueryProtocol::MAGIC || response.payloadSize > QueryProtocol::MAX_PAYLOAD_SIZE)
+        {
+            winrt::throw_hresult(HRESULT_FROM_WIN32(ERROR_INVALID_DATA));
+        }
+
+        switch (response.status)
+        {
+        case QueryProtocol::Status::Ok:
+            break;
+        case QueryProtocol::Status::InvalidPattern:
+            throw winrt::hresult_invalid_argument(L"The regular expression is invalid. Backreferences and lookarounds aren't supported.");
+        case QueryProtocol::Status::Unavailable:
+            winrt::throw_hresult(HRESULT_FROM_WIN32(ERROR_NOT_READY));
+        case QueryProtocol::Status::InvalidRequest:
+            throw winrt::hresult_invalid_argument(L"Rememory rejected the request. The running app may be a different version.");
+        default:
+            winrt::throw_hresult(HRESULT_FROM_WIN32(ERROR_INVALID_DATA));
+        }
+
+        std::vector<Rememory::Core::QueryItem> items;
+        auto onItem = [&](uint32_t index, std::wstring_view text)
+            {
+                items.push_back({ static_cast<int32_t>(index), winrt::hstring{ text } });
+            };
+
+        bool isValid = false;
+        if (response.transfer == QueryProtocol::Transfer::SharedMemory)
+        {
+            uint64_t sectionValue = 0;
+            if (!QueryProtocol::Read(pipe.get(), &sectionValue, sizeof(sectionValue)))
+            {
+                ThrowDisconnected();
+            }
+
+            // The server duplicated the section into this process, so the handle is ours to close
+            winrt::handle section(reinterpret_cast<HANDLE>(static_cast<uintptr_t>(sectionValue)));
+            const BYTE* view = static_cast<const BYTE*>(MapViewOfFile(section.get(), FILE_MAP_READ, 0, 0, static_cast<size_t>(response.payloadSize)));
+            if (!view)
+            {
+                winrt::throw_last_error();
+            }
+
+            isValid = QueryProtocol::ReadPayload({ view, static_cast<size_t>(response.payloadSize) }, response.itemCount, onItem);
+            UnmapViewOfFile(view);
+        }
+        else
+        {
+            std::vector<BYTE> payload(static_cast<size_t>(response.payloadSize));
+            if (!payload.empty() && !QueryProtocol::Read(pipe.get(), payload.data(), payload.size()))
+            {
+                ThrowDisconnected();
+            }
+
+            isValid = QueryProtocol::ReadPayload(payload, response.itemCount, onItem);
+        }
+
+        if (!isValid)
+        {
+            winrt::throw_hresult(HRESULT_FROM_WIN32(ERROR_INVALID_DATA));
+        }
+
+        return winrt::single_threaded_vector(std::move(items)).GetView();
+    }
+
+    winrt::file_handle QueryClient::Connect()
+    {
+        auto pipeName = QueryProtocol::GetPipeName();
+
+        while (true)
+        {
+            // Identification only, the server can't act as this process
+            winrt::file_handle pipe(CreateFileW(pipeName.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_EXISTING,
+                FILE_FLAG_OVERLAPPED | SECURITY_SQOS_PRESENT | SECURITY_IDENTIFICATION, nullptr));
+            if (pipe)
+            {
+                return pipe;
+            }
+
+            // Every instance is busy with another client
+            if (GetLastError() != ERROR_PIPE_BUSY || !WaitNamedPipeW(pipeName.c_str(), CONNECT_TIMEOUT))
+            {
+                winrt::throw_last_error();
+            }
+        }
+    }
+}
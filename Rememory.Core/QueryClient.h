@@ -0,0 +1,27 @@
+#pragma once
+#include "pch.h"
+#include "QueryClient.g.h"
+#include <string_view>
+#include "QueryProtocol.h"
+
+namespace winrt::Rememory::Core::implementation
+{
+    struct QueryClient : QueryClientT<QueryClient>
+    {
+        static winrt::Windows::Foundation::Collections::IVectorView<Rememory::Core::QueryItem> List(uint32_t count);
+        static winrt::Windows::Foundation::Collections::IVectorView<Rememory::Core::QueryItem> Get(uint32_t index);
+        static winrt::Windows::Foundation::Collections::IVectorView<Rememory::Core::QueryItem> Search(winrt::hstring const& query, uint32_t maxCount);
+        static winrt::Windows::Foundation::Collections::IVectorView<Rememory::Core::QueryItem> SearchRegex(winrt::hstring const& pattern, bool ignoreCase, uint32_t maxCount);
+
+    private:
+        static constexpr DWORD CONNECT_TIMEOUT = 2000;   // Milliseconds to wait while every pipe instance is busy
+
+        static winrt::Windows::Foundation::Collections::IVectorView<Rememory::Core::QueryItem> Send(QueryProtocol::Command command, QueryProtocol::Flags flags, uint32_t argument, std::wstring_view query);
+        static winrt::file_handle Connect();
+    };
+}
+
+namespace winrt::Rememory::Core::factory_implementation
+{
+    struct QueryClient : QueryClientT<QueryClient, implementation::QueryClient> {};
+}
@@ -0,0 +1,167 @@
+#include "pch.h"
+#include <algorithm>
+#include <sddl.h>
+#include "QueryProtocol.h"
+
+#pragma comment(lib, "advapi32.lib")
+
+namespace winrt::Rememory::Core::implementation
+{
+    std::wstring QueryProtocol::GetPipeName()
+    {
+        return L"\\\\.\\pipe\\Rememory.Query." + GetUserSid();
+    }
+
+    std::wstring QueryProtocol::GetSecurityDescriptor()
+    {
+        // Full access for the current user only, nothing inherited
+        return L"D:P(A;;GA;;;" + GetUserSid() + L")";
+    }
+
+    bool QueryProtocol::Read(HANDLE pipe, void* buffer, size_t size, HANDLE stopEvent)
+    {
+        return TransferBytes(pipe, buffer, size, false, stopEvent);
+    }
+
+    bool QueryProtocol::Write(HANDLE pipe, const void* data, size_t size, HANDLE stopEvent)
+    {
+        return TransferBytes(pipe, const_cast<void*>(data), size, true, stopEvent);
+    }
+
+    size_t QueryProtocol::GetPayloadSize(const std::vector<Item>& items)
+    {
+        size_t size = 0;
+        for (const auto& item : items)
+        {
+            size += sizeof(ItemHeader) + item.text.size() * sizeof(wchar_t);
+        }
+        return size;
+    }
+
+    void QueryProtocol::WritePayload(const std::vector<Item>& items, BYTE* destination)
+    {
+        for (const auto& item : items)
+        {
+            ItemHeader header{ item.index, static_cast<uint32_t>(item.text.size()) };
+            memcpy(destination, &header, sizeof(header));
+            destination += sizeof(header);
+
+            memcpy(destination, item.text.data(), item.text.size() * sizeof(wchar_t));
+            destination += item.text.size() * sizeof(wchar_t);
+        }
+    }
+
+    bool QueryProtocol::ReadPayload(std::span<const BYTE> payload, uint32_t itemCount, const std::function<void(uint32_t, std::wstring_view)>& onItem)
+    {
+        size_t offset = 0;
+
+        for (uint32_t i = 0; i < itemCount; i++)
+        {
+            if (payload.size() - offset < sizeof(ItemHeader))
+            {
+                return false;
+            }
+
+            ItemHeader header;
+            memcpy(&header, payload.data() + offset, sizeof(header));
+            offset += sizeof(header);
+
+            size_t textSize = static_cast<size_t>(header.length) * sizeof(wchar_t);
+            if (payload.size() - offset < textSize)
+            {
+                return false;
+            }
+
+            // The payload is only byte-aligned, so the text is copied out before it's read as UTF-16
+            std::wstring text(header.length, L'\0');
+            memcpy(text.data(), payload.data() + offset, textSize);
+            offset += textSize;
+
+            onItem(header.index, text);
+        }
+
+        return offset == payload.size();
+    }
+
+    bool QueryProtocol::TransferBytes(HANDLE pipe, void* buffer, size_t size, bool isWrite, HANDLE stopEvent)
+    {
+        winrt::handle ioEvent(CreateEventW(nullptr, TRUE, FALSE, nullptr));
+        if (!ioEvent)
+        {
+            return false;
+        }
+
+        BYTE* bytes = static_cast<BYTE*>(buffer);
+        size_t done = 0;
+
+        while (done < size)
+        {
+            OVERLAPPED overlapped{};
+            overlapped.hEvent = ioEvent.get();
+
+            DWORD chunkSize = static_cast<DWORD>(std::min<size_t>(size - done, MAXDWORD));
+            BOOL isCompleted = isWrite
+                ? WriteFile(pipe, bytes + done, chunkSize, nullptr, &overlapped)
+                : ReadFile(pipe, bytes + done, chunkSize, nullptr, &overlapped);
+
+            if (!isCompleted && GetLastError() != ERROR_IO_PENDING)
+            {
+                return false;
+            }
+
+            HANDLE events[] = { ioEvent.get(), stopEvent };
+            DWORD waitResult = WaitForMultipleObjects(stopEvent ? 2 : 1, events, FALSE, static_cast<DWORD>(IO_TIMEOUT.count()));
+
+            DWORD transferred = 0;
+            if (waitResult != WAIT_OBJECT_0)
+            {
+                // Timed out or stopping, the operation has to finish before the buffer can go away
+                CancelIoEx(pipe, &overlapped);
+                GetOverlappedResult(pipe, &overlapped, &transferred, TRUE);
+                return false;
+            }
+
+            if (!GetOverlappedResult(pipe, &overlapped, &transferred, FALSE) || transferred == 0)
+            {
+                return false;
+            }
+
+            done += transferred;
+        }
+
+        return true;
+    }
+
+    std::wstring QueryProtocol::GetUserSid()
+    {
+        static const std::wstring sid = []()
+            {
+                HANDLE token = nullptr;
+                if (!OpenProcessToken(GetCurrentProcess(), TOKEN_QUERY, &token))
+                {
+                    return std::wstring{};
+                }
+                winrt::handle tokenHandle(token);
+
+                DWORD size = 0;
+                GetTokenInformation(token, TokenUser, nullptr, 0, &size);
+                std::vector<BYTE> buffer(size);
+                if (size == 0 || !GetTokenInformation(token, TokenUser, buffer.data(), size, &size))
+                {
+                    return std::wstring{};
+                }
+
+                LPWSTR sidString = nullptr;
+                if (!ConvertSidToStringSidW(reinterpret_cast<TOKEN_USER*>(buffer.data())->User.Sid, &sidString))
+                {
+                    return std::wstring{};
+                }
+
+                std::wstring result(sidString);
+                LocalFree(sidString);
+                return result;
+            }();
+
+        return sid;
+    }
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include "pch.h"
+#include <chrono>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace winrt::Rememory::Core::implementation
+{
+    // Wire format of the local query pipe, shared by the server in the app and the command-line client.
+    // A request is a header and the query text, a response is a header and the matched clips.
+    // Payloads over SHARED_MEMORY_THRESHOLD are written to a section whose handle the server duplicates into the client,
+    // so large results are copied once instead of streamed through the pipe.
+    class QueryProtocol
+    {
+    public:
+        static constexpr uint32_t MAGIC = 0x31514D52;   // "RMQ1"
+        static constexpr uint32_t MAX_QUERY_LENGTH = 4096;
+        static constexpr uint32_t MAX_ITEM_COUNT = 10000;
+        static constexpr uint64_t MAX_PAYLOAD_SIZE = 256 * 1024 * 1024;
+        static constexpr size_t SHARED_MEMORY_THRESHOLD = 64 * 1024;
+        static constexpr std::chrono::milliseconds IO_TIMEOUT{ 5000 };
+
+        enum class Command : uint8_t
+        {
+            List,          // The most recent clips, argument is the count
+            Get,           // One clip, argument is its position with 1 being the most recent
+            Search,        // Fuzzy search, argument is the maximum count
+            SearchRegex
+        };
+
+        enum class Flags : uint8_t
+        {
+            None = 0,
+            IgnoreCase = 1
+        };
+
+        enum class Status : uint8_t
+        {
+            Ok,
+            InvalidRequest,
+            InvalidPattern,
+            Unavailable    // The history isn't loaded yet
+        };
+
+        enum class Transfer : uint8_t
+        {
+            Inline,        // The payload follows the header
+            SharedMemory   // A section handle valid in the client follows the header
+        };
+
+#pragma pack(push, 1)
+        struct RequestHeader
+        {
+            uint32_t magic;
+            Command command;
+            Flags flags;
+            uint16_t reserved;
+            uint32_t argument;
+            uint32_t queryLength;   // UTF-16 code units following the header
+        };
+
+        struct ResponseHeader
+        {
+            uint32_t magic;
+            Status status;
+            Transfer transfer;
+            uint16_t reserved;
+            uint32_t itemCount;
+            uint64_t payloadSize;
+        };
+
+        // Each item of the payload, followed by its text
+        struct ItemHeader
+        {
+            uint32_t index;
+            uint32_t length;
+        };
+#pragma pack(pop)
+
+        struct Item
+        {
+            uint32_t index;
+            std::wstring_view text;
+        };
+
+        // Per user, and the pipe only lets the same user in
+        static std::wstring GetPipeName();
+        static std::wstring GetSecurityDescriptor();
+
+        // Overlapped I/O that gives up after IO_TIMEOUT or once stopEvent is set
+        static bool Read(HANDLE pipe, void* buffer, size_t size, HANDLE stopEvent = nullptr);
+        static bool Write(HANDLE pipe, const void* data, size_t size, HANDLE stopEvent = nullptr);
+
+        static size_t GetPayloadSize(const std::vector<Item>& items);
+        static void WritePayload(const std::vector<Item>& items, BYTE* destination);
+        static bool ReadPayload(std::span<const BYTE> payload, uint32_t itemCount, const std::function<void(uint32_t, std::wstring_view)>& onItem);
+
+    private:
+        static bool TransferBytes(HANDLE pipe, void* buffer, size_t size, bool isWrite, HANDLE stopEvent);
+        static std::wstring GetUserSid();
+    };
+
+    DEFINE_ENUM_FLAG_OPERATORS(QueryProtocol::Flags);
+}
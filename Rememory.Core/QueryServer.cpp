@@ -0,0 +1,343 @@
+#include "pch.h"
+#include <algorithm>
+#include <sddl.h>
+#include "QueryServer.h"
+#include "QueryServer.g.cpp"
+#include "Metrics.h"
+#include "RegexMatcher.h"
+
+namespace winrt::Rememory::Core::implementation
+{
+    QueryServer::~QueryServer()
+    {
+        Stop();
+    }
+
+    void QueryServer::IsEnabled(bool value)
+    {
+        std::lock_guard lock(m_mutex);
+
+        if (value == m_isEnabled)
+        {
+            return;
+        }
+
+        if (value)
+        {
+            m_isEnabled = Start();
+        }
+        else
+        {
+            Stop();
+            m_isEnabled = false;
+        }
+    }
+
+    void QueryServer::SetHistoryProvider(Rememory::Core::QueryHistoryProvider const& provider)
+    {
+        std::lock_guard lock(m_providerMutex);
+        m_provider = provider;
+    }
+
+    void QueryServer::SetSearchProvider(Rememory::Core::QuerySearchProvider const& provider)
+    {
+        std::lock_guard lock(m_providerMutex);
+        m_searchProvider = provider;
+    }
+
+    bool QueryServer::Start()
+    {
+        // The listener may have stopped on its own after a failure
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+
+        // The first instance is created here, so the server stays off if the pipe is taken or can't be secured
+        auto pipe = CreatePipe(true);
+        if (!pipe)
+        {
+            return false;
+        }
+
+        m_stopEvent.attach(CreateEventW(nullptr, TRUE, FALSE, nullptr));
+        if (!m_stopEvent)
+        {
+            return false;
+        }
+
+        m_thread = std::thread{ &QueryServer::Listen, this, std::move(pipe) };
+        return true;
+    }
+
+    void QueryServer::Stop()
+    {
+        if (m_stopEvent)
+        {
+            SetEvent(m_stopEvent.get());
+        }
+
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+
+        m_stopEvent.close();
+    }
+
+    void QueryServer::Listen(winrt::file_handle pipe)
+    {
+        SetThreadDescription(GetCurrentThread(), L"Rememory query server");
+
+        winrt::handle connectEvent(CreateEventW(nullptr, TRUE, FALSE, nullptr));
+
+        while (pipe && connectEvent)
+        {
+            OVERLAPPED overlapped{};
+            overlapped.hEvent = connectEvent.get();
+            ResetEvent(connectEvent.get());
+
+            bool isConnected = false;
+            if (!ConnectNamedPipe(pipe.get(), &overlapped))
+            {
+                DWORD error = GetLastError();
+                if (error == ERROR_PIPE_CONNECTED)
+                {
+                    isConnected = true;
+                }
+                else if (error == ERROR_IO_PENDING)
+                {
+                    HANDLE events[] = { connectEvent.get(), m_stopEvent.get() };
+                    DWORD transferred = 0;
+
+                    if (WaitForMultipleObjects(2, events, FALSE, INFINITE) != WAIT_OBJECT_0)
+                    {
+                        CancelIoEx(pipe.get(), &overlapped);
+                        GetOverlappedResult(pipe.get(), &overlapped, &transferred, TRUE);
+                        return;
+                    }
+
+                    isConnected = GetOverlappedResult(pipe.get(), &overlapped, &transferred, FALSE);
+                }
+            }
+
+            // The next client gets a new instance, this one stays with the connected client
+            if (isConnected)
+            {
+                Rememory::Core::QueryHistoryProvider provider{ nullptr };
+                Rememory::Core::QuerySearchProvider searchProvider{ nullptr };
+                {
+                    std::lock_guard lock(m_providerMutex);
+                    provider = m_provider;
+                    searchProvider = m_searchProvider;
+                }
+
+                HandleConnection(std::move(pipe), std::move(provider), std::move(searchProvider));
+            }
+
+            pipe = CreatePipe(false);
+        }
+
+        m_isEnabled = false;
+    }
+
+    winrt::file_handle QueryServer::CreatePipe(bool isFirstInstance)
+    {
+        PSECURITY_DESCRIPTOR descriptor = nullptr;
+        if (!ConvertStringSecurityDescriptorToSecurityDescriptorW(QueryProtocol::GetSecurityDescriptor().c_str(), SDDL_REVISION_1, &descriptor, nullptr))
+        {
+            return {};
+        }
+
+        SECURITY_ATTRIBUTES attributes{ sizeof(attributes), descriptor, FALSE };
+        DWORD openMode = PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED | (isFirstInstance ? FILE_FLAG_FIRST_PIPE_INSTANCE : 0);
+
+        winrt::file_handle pipe(CreateNamedPipeW(QueryProtocol::GetPipeName().c_str(), openMode,
+            PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+            PIPE_UNLIMITED_INSTANCES, PIPE_BUFFER_SIZE, PIPE_BUFFER_SIZE, 0, &attributes));
+
+        LocalFree(descriptor);
+        return pipe;
+    }
+
+    winrt::fire_and_forget QueryServer::HandleConnection(winrt::file_handle pipe, Rememory::Core::QueryHistoryProvider provider, Rememory::Core::QuerySearchProvider searchProvider)
+    {
+        co_await winrt::resume_background();
+
+        QueryProtocol::RequestHeader request{};
+        if (!QueryProtocol::Read(pipe.get(), &request, sizeof(request)) || request.magic != QueryProtocol::MAGIC)
+        {
+            co_return;
+        }
+
+        if (request.queryLength > QueryProtocol::MAX_QUERY_LENGTH)
+        {
+            Respond(pipe.get(), QueryProtocol::Status::InvalidRequest, {});
+            co_return;
+        }
+
+        std::wstring query(request.queryLength, L'\0');
+        if (!query.empty() && !QueryProtocol::Read(pipe.get(), query.data(), query.size() * sizeof(wchar_t)))
+        {
+            co_return;
+        }
+
+        Metrics::Scope scope(MetricId::Query);
+
+        if (!provider || !searchProvider)
+        {
+            Respond(pipe.get(), QueryProtocol::Status::Unavailable, {});
+            co_return;
+        }
+
+        auto status = QueryProtocol::Status::Ok;
+        uint32_t count = std::min(request.argument, QueryProtocol::MAX_ITEM_COUNT);
+        std::vector<std::pair<uint32_t, winrt::hstring>> results;
+
+        try
+        {
+            switch (request.command)
+            {
+            case QueryProtocol::Command::List:
+            {
+                auto texts = co_await provider(count);
+                for (uint32_t i = 0; i < std::min(texts.Size(), count); i++)
+                {
+                    results.emplace_back(i + 1, texts.GetAt(i));
+                }
+                break;
+            }
+            case QueryProtocol::Command::Get:
+            {
+                if (request.argument == 0)
+                {
+                    status = QueryProtocol::Status::InvalidRequest;
+                    break;
+                }
+
+                // Only the texts up to the requested one are read
+                auto texts = co_await provider(request.argument);
+                if (texts.Size() >= request.argument)
+                {
+                    results.emplace_back(request.argument, texts.GetAt(request.argument - 1));
+                }
+                break;
+            }
+            case QueryProtocol::Command::Search:
+            case QueryProtocol::Command::SearchRegex:
+            {
+                bool isRegex = request.command == QueryProtocol::Command::SearchRegex;
+                bool ignoreCase = (request.flags & QueryProtocol::Flags::IgnoreCase) == QueryProtocol::Flags::IgnoreCase;
+                if (isRegex && !RegexProgram::Compile(query, ignoreCase))
+                {
+                    status = QueryProtocol::Status::InvalidPattern;
+                    break;
+                }
+
+                // The app searches its own clips, so only the matches cross over rather than the whole history
+                auto items = co_await searchProvider(winrt::hstring{ query }, isRegex, ignoreCase, count);
+                for (const auto& item : items)
+                {
+                    results.emplace_back(static_cast<uint32_t>(item.Index), item.Text);
+                }
+                break;
+            }
+            default:
+                status = QueryProtocol::Status::InvalidRequest;
+                break;
+            }
+        }
+        catch (...)
+        {
+            results.clear();
+            status = QueryProtocol::Status::Unavailable;
+        }
+
+        Respond(pipe.get(), status, results);
+        FlushFileBuffers(pipe.get());
+        DisconnectNamedPipe(pipe.get());
+    }
+
+    void QueryServer::Respond(HANDLE pipe, QueryProtocol::Status status, const std::vector<std::pair<uint32_t, winrt::hstring>>& results)
+    {
+        std::vector<QueryProtocol::Item> items;
+        for (const auto& [index, text] : results)
+        {
+            items.push_back({ index, text });
+        }
+
+        // Results that don't fit are dropped from the end
+        size_t payloadSize = QueryProtocol::GetPayloadSize(items);
+        while (payloadSize > QueryProtocol::MAX_PAYLOAD_SIZE)
+        {
+            payloadSize -= sizeof(QueryProtocol::ItemHeader) + items.back().text.size() * sizeof(wchar_t);
+            items.pop_back();
+        }
+
+        QueryProtocol::ResponseHeader header{ QueryProtocol::MAGIC, status, QueryProtocol::Transfer::Inline, 0, static_cast<uint32_t>(items.size()), payloadSize };
+
+        if (payloadSize > QueryProtocol::SHARED_MEMORY_THRESHOLD)
+        {
+            if (auto section = ShareWithClient(pipe, items, payloadSize))
+            {
+                header.transfer = QueryProtocol::Transfer::SharedMemory;
+                Metrics::Increment(CounterId::SharedMemoryResponses);
+
+                // If the client is gone by now, its copy of the handle goes away with it
+                if (QueryProtocol::Write(pipe, &header, sizeof(header)))
+                {
+                    QueryProtocol::Write(pipe, &*section, sizeof(*section));
+                }
+                return;
+            }
+        }
+
+        std::vector<BYTE> payload(payloadSize);
+        QueryProtocol::WritePayload(items, payload.data());
+
+        if (QueryProtocol::Write(pipe, &header, sizeof(header)) && !payload.empty())
+        {
+            QueryProtocol::Write(pipe, payload.data(), payload.size());
+        }
+    }
+
+    std::optional<uint64_t> QueryServer::ShareWithClient(HANDLE pipe, const std::vector<QueryProtocol::Item>& items, size_t payloadSize)
+    {
+        ULONG clientProcessId = 0;
+        if (!GetNamedPipeClientProcessId(pipe, &clientProcessId))
+        {
+            return std::nullopt;
+        }
+
+        winrt::handle clientProcess(OpenProcess(PROCESS_DUP_HANDLE, FALSE, clientProcessId));
+        if (!clientProcess)
+        {
+            return std::nullopt;
+        }
+
+        winrt::handle section(CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+            static_cast<DWORD>(static_cast<uint64_t>(payloadSize) >> 32), static_cast<DWORD>(payloadSize), nullptr));
+        if (!section)
+        {
+            return std::nullopt;
+        }
+
+        void* view = MapViewOfFile(section.get(), FILE_MAP_WRITE, 0, 0, payloadSize);
+        if (!view)
+        {
+            return std::nullopt;
+        }
+
+        QueryProtocol::WritePayload(items, static_cast<BYTE*>(view));
+        UnmapViewOfFile(view);
+
+        // The client only gets to read the section
+        HANDLE clientSection = nullptr;
+        if (!DuplicateHandle(GetCurrentProcess(), section.get(), clientProcess.get(), &clientSection, FILE_MAP_READ, FALSE, 0))
+        {
+            return std::nullopt;
+        }
+
+        return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(clientSection));
+    }
+}
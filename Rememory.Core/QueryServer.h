@@ -0,0 +1,54 @@
+#pragma once
+#include "pch.h"
+#include "QueryServer.g.h"
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "QueryProtocol.h"
+
+namespace winrt::Rememory::Core::implementation
+{
+    // One thread waits for clients, each connected client is served on the thread pool,
+    // so a slow client or a long search doesn't hold up the others.
+    struct QueryServer : QueryServerT<QueryServer>
+    {
+        QueryServer() = default;
+        ~QueryServer();
+
+        bool IsEnabled() const { return m_isEnabled; }
+        void IsEnabled(bool value);
+        void SetHistoryProvider(Rememory::Core::QueryHistoryProvider const& provider);
+        void SetSearchProvider(Rememory::Core::QuerySearchProvider const& provider);
+
+    private:
+        static constexpr DWORD PIPE_BUFFER_SIZE = 64 * 1024;
+
+        std::mutex m_mutex;
+        std::mutex m_providerMutex;   // Separate, the listener takes it while m_mutex waits for the listener to stop
+        Rememory::Core::QueryHistoryProvider m_provider{ nullptr };
+        Rememory::Core::QuerySearchProvider m_searchProvider{ nullptr };
+        winrt::handle m_stopEvent;
+        std::thread m_thread;
+        std::atomic<bool> m_isEnabled = false;
+
+        bool Start();
+        void Stop();
+        void Listen(winrt::file_handle pipe);
+        static winrt::file_handle CreatePipe(bool isFirstInstance);
+
+        // Takes the providers rather than this, so a connection never keeps the server alive while it shuts down
+        static winrt::fire_and_forget HandleConnection(winrt::file_handle pipe, Rememory::Core::QueryHistoryProvider provider, Rememory::Core::QuerySearchProvider searchProvider);
+        static void Respond(HANDLE pipe, QueryProtocol::Status status, const std::vector<std::pair<uint32_t, winrt::hstring>>& results);
+
+        // Writes the payload to a section and duplicates its handle into the client, nullopt if the client can't be reached
+        static std::optional<uint64_t> ShareWithClient(HANDLE pipe, const std::vector<QueryProtocol::Item>& items, size_t payloadSize);
+    };
+}
+
+namespace winrt::Rememory::Core::factory_implementation
+{
+    struct QueryServer : QueryServerT<QueryServer, implementation::QueryServer> {};
+}
@@ -0,0 +1,84 @@
+#include "pch.h"
+#include "RegexMatcher.h"
+#include "RegexMatcher.g.cpp"
+#include "Metrics.h"
+#include <algorithm>
+#include <atomic>
+#include <execution>
+#include <thread>
+
+namespace winrt::Rememory::Core::implementation
+{
+    Rememory::Core::RegexMatcher RegexMatcher::TryCreate(winrt::hstring const& pattern, bool ignoreCase)
+    {
+        auto program = RegexProgram::Compile(pattern, ignoreCase);
+        return program ? winrt::make<RegexMatcher>(std::move(*program)) : nullptr;
+    }
+
+    winrt::Windows::Foundation::IAsyncOperation<winrt::Windows::Foundation::Collections::IVectorView<int32_t>> RegexMatcher::FindMatchesAsync(winrt::Windows::Foundation::Collections::IVectorView<winrt::hstring> texts, uint32_t maxCount)
+    {
+        auto strongThis = get_strong();
+        auto cancellation = co_await winrt::get_cancellation_token();
+        auto isCanceled = std::make_shared<std::atomic<bool>>(false);
+        cancellation.callback([isCanceled] { isCanceled->store(true); });
+
+        std::vector<winrt::hstring> items(texts.Size());
+        texts.GetMany(0, items);
+
+        co_await winrt::resume_background();
+
+        Metrics::Scope scope(MetricId::RegexSearch);
+
+        if (maxCount == 0 || items.empty())
+        {
+            co_return winrt::single_threaded_vector<int32_t>().GetView();
+        }
+
+        size_t chunkCount = std::clamp<size_t>(items.size() / MIN_CHUNK_SIZE, 1, std::max(std::thread::hardware_concurrency(), 1u));
+        size_t chunkSize = (items.size() + chunkCount - 1) / chunkCount;
+        std::vector<std::vector<int32_t>> chunkMatches(chunkCount);
+
+        std::for_each(std::execution::par, chunkMatches.begin(), chunkMatches.end(), [&](std::vector<int32_t>& matches)
+            {
+                size_t start = (&matches - chunkMatches.data()) * chunkSize;
+                size_t end = std::min(start + chunkSize, items.size());
+
+                for (size_t i = start; i < end && matches.size() < maxCount; i++)
+                {
+                    if ((i - start) % CANCELLATION_CHECK_INTERVAL == 0 && isCanceled->load(std::memory_order_relaxed))
+                    {
+                        break;
+                    }
+
+                    if (m_program.IsMatch(items[i]))
+                    {
+                        matches.push_back(static_cast<int32_t>(i));
+                    }
+                }
+            });
+
+        // Chunks are in order, so the first maxCount matches are the earliest texts
+        std::vector<int32_t> indices;
+        for (const auto& matches : chunkMatches)
+        {
+            indices.insert(indices.end(), matches.begin(), matches.begin() + std::min<size_t>(matches.size(), maxCount - indices.size()));
+            if (indices.size() == maxCount)
+            {
+                break;
+            }
+        }
+
+        co_return winrt::single_threaded_vector(std::move(indices)).GetView();
+    }
+
+    winrt::Windows::Foundation::Collections::IVectorView<Rememory::Core::MatchSpan> RegexMatcher::GetMatchSpans(winrt::hstring const& text) const
+    {
+        std::vector<Rememory::Core::MatchSpan> spans;
+        for (const auto& [start, length] : m_program.FindAll(text, MAX_SPAN_COUNT))
+        {
+            spans.push_back({ static_cast<int32_t>(start), static_cast<int32_t>(length) });
+        }
+
+        return winrt::single_threaded_vector(std::move(spans)).GetView();
+    }
+}
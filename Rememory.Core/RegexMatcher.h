@@ -0,0 +1,30 @@
+#pragma once
+#include "pch.h"
+#include "RegexMatcher.g.h"
+#include "RegexProgram.h"
+
+namespace winrt::Rememory::Core::implementation
+{
+    // Texts are scanned in parallel chunks, each one stopping once it has enough matches or the search is canceled
+    struct RegexMatcher : RegexMatcherT<RegexMatcher>
+    {
+        RegexMatcher(RegexProgram&& program) : m_program(std::move(program)) {}
+
+        static Rememory::Core::RegexMatcher TryCreate(winrt::hstring const& pattern, bool ignoreCase);
+
+        winrt::Windows::Foundation::IAsyncOperation<winrt::Windows::Foundation::Collections::IVectorView<int32_t>> FindMatchesAsync(winrt::Windows::Foundation::Collections::IVectorView<winrt::hstring> texts, uint32_t maxCount);
+        winrt::Windows::Foundation::Collections::IVectorView<Rememory::Core::MatchSpan> GetMatchSpans(winrt::hstring const& text) const;
+
+    private:
+        static constexpr size_t MIN_CHUNK_SIZE = 256;
+        static constexpr size_t CANCELLATION_CHECK_INTERVAL = 64;   // Texts between checks
+        static constexpr size_t MAX_SPAN_COUNT = 1000;
+
+        RegexProgram m_program;
+    };
+}
+
+namespace winrt::Rememory::Core::factory_implementation
+{
+    struct RegexMatcher : RegexMatcherT<RegexMatcher, implementation::RegexMatcher> {};
+}
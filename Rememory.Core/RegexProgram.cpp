@@ -0,0 +1,1093 @@
+#include "pch.h"
+#include <algorithm>
+#include <array>
+#include <memory>
+#include "RegexProgram.h"
+#include "FuzzyScorer.h"
+
+namespace {
+    constexpr uint32_t UNBOUNDED = UINT32_MAX;
+    constexpr uint32_t MAX_DEPTH = 128;   // Nested groups, bounded so parsing and compiling can't overflow the stack
+
+    std::optional<uint32_t> ParseHex(std::wstring_view digits)
+    {
+        uint32_t value = 0;
+        for (wchar_t c : digits)
+        {
+            uint32_t digit = 0;
+            if (c >= L'0' && c <= L'9')
+            {
+                digit = c - L'0';
+            }
+            else if (c >= L'a' && c <= L'f')
+            {
+                digit = c - L'a' + 10;
+            }
+            else if (c >= L'A' && c <= L'F')
+            {
+                digit = c - L'A' + 10;
+            }
+            else
+            {
+                return std::nullopt;
+            }
+            value = value * 16 + digit;
+        }
+        return value;
+    }
+}
+
+namespace winrt::Rememory::Core::implementation
+{
+    struct RegexProgram::Node
+    {
+        enum class Type : uint8_t
+        {
+            Empty,
+            Char,
+            Any,
+            AnyNewline,
+            Class,
+            Assert,
+            Concat,
+            Alternate,
+            Repeat
+        };
+
+        Type type = Type::Empty;
+        wchar_t c = 0;
+        uint32_t classIndex = 0;
+        Assertion assertion = Assertion::TextStart;
+        uint32_t min = 0;
+        uint32_t max = 0;
+        bool isGreedy = true;
+        std::vector<size_t> children;
+    };
+
+    // Recursive descent over the pattern into a tree of nodes. Classes are added to the program as they are parsed
+    class RegexProgram::Parser
+    {
+    public:
+        Parser(std::wstring_view pattern, RegexProgram& program) : m_pattern(pattern), m_program(program) {}
+
+        const std::vector<Node>& Nodes() const { return m_nodes; }
+
+        // Index of the root node, nullopt if the pattern is invalid or uses what can't be matched in linear time
+        std::optional<size_t> Parse()
+        {
+            ParseFlags();
+
+            auto root = ParseAlternation(0);
+            if (!root || m_position != m_pattern.size())
+            {
+                return std::nullopt;
+            }
+            return root;
+        }
+
+    private:
+        std::wstring_view m_pattern;
+        size_t m_position = 0;
+        RegexProgram& m_program;
+        std::vector<Node> m_nodes;
+        bool m_isMultiline = false;
+        bool m_isSingleline = false;
+
+        bool AtEnd() const { return m_position >= m_pattern.size(); }
+        wchar_t Peek(size_t offset = 0) const { return m_position + offset < m_pattern.size() ? m_pattern[m_position + offset] : L'\0'; }
+
+        bool Skip(wchar_t c)
+        {
+            if (AtEnd() || Peek() != c)
+            {
+                return false;
+            }
+            m_position++;
+            return true;
+        }
+
+        size_t AddNode(Node node)
+        {
+            m_nodes.push_back(std::move(node));
+            return m_nodes.size() - 1;
+        }
+
+        // (?i), (?m), (?s) or a combination, only at the start of the pattern
+        void ParseFlags()
+        {
+            while (Peek() == L'(' && Peek(1) == L'?')
+            {
+                size_t end = m_position + 2;
+                while (end < m_pattern.size() && (m_pattern[end] == L'i' || m_pattern[end] == L'm' || m_pattern[end] == L's'))
+                {
+                    end++;
+                }
+
+                if (end == m_position + 2 || end >= m_pattern.size() || m_pattern[end] != L')')
+                {
+                    return;
+                }
+
+                for (size_t i = m_position + 2; i < end; i++)
+                {
+                    switch (m_pattern[i])
+                    {
+                    case L'i':
+                        m_program.m_ignoreCase = true;
+                        break;
+                    case L'm':
+                        m_isMultiline = true;
+                        break;
+                    case L's':
+                        m_isSingleline = true;
+                        break;
+                    }
+                }
+
+                m_position = end + 1;
+            }
+        }
+
+        std::optional<size_t> ParseAlternation(uint32_t depth)
+        {
+            if (depth > MAX_DEPTH)
+            {
+                return std::nullopt;
+            }
+
+            Node alternate{ Node::Type::Alternate };
+            do
+            {
+                auto branch = ParseConcat(depth);
+                if (!branch)
+                {
+                    return std::nullopt;
+                }
+                alternate.children.push_back(*branch);
+            } while (Skip(L'|'));
+
+            return alternate.children.size() == 1 ? alternate.children.front() : AddNode(std::move(alternate));
+        }
+
+        std::optional<size_t> ParseConcat(uint32_t depth)
+        {
+            Node concat{ Node::Type::Concat };
+
+            while (!AtEnd() && Peek() != L'|' && Peek() != L')')
+            {
+                auto atom = ParseAtom(depth);
+                if (!atom)
+                {
+                    return std::nullopt;
+                }
+
+                uint32_t min = 0;
+                uint32_t max = 0;
+                if (ParseQuantifier(min, max))
+                {
+                    if (min > MAX_REPEAT || (max != UNBOUNDED && (max > MAX_REPEAT || max < min)))
+                    {
+                        return std::nullopt;
+                    }
+
+                    bool isGreedy = !Skip(L'?');
+                    atom = AddNode({ .type = Node::Type::Repeat, .min = min, .max = max, .isGreedy = isGreedy, .children = { *atom } });
+
+                    // A quantifier can't follow another one, as in .NET
+                    uint32_t nestedMin = 0;
+                    uint32_t nestedMax = 0;
+                    if (ParseQuantifier(nestedMin, nestedMax))
+                    {
+                        return std::nullopt;
+                    }
+                }
+
+                concat.children.push_back(*atom);
+            }
+
+            if (concat.children.empty())
+            {
+                return AddNode({ Node::Type::Empty });
+            }
+            return concat.children.size() == 1 ? concat.children.front() : AddNode(std::move(concat));
+        }
+
+        std::optional<size_t> ParseAtom(uint32_t depth)
+        {
+            wchar_t c = Peek();
+            m_position++;
+
+            switch (c)
+            {
+            case L'(':
+                return ParseGroup(depth);
+            case L'[':
+                return ParseClass();
+            case L'.':
+                return AddNode({ m_isSingleline ? Node::Type::AnyNewline : Node::Type::Any });
+            case L'^':
+                return AddNode({ .type = Node::Type::Assert, .assertion = m_isMultiline ? Assertion::LineStart : Assertion::TextStart });
+            case L'$':
+                return AddNode({ .type = Node::Type::Assert, .assertion = m_isMultiline ? Assertion::LineEnd : Assertion::TextEnd });
+            case L'*':
+            case L'+':
+            case L'?':
+                return std::nullopt;   // Quantifier following nothing
+            case L'\\':
+                return ParseEscape();
+            default:
+                return AddChar(c);
+            }
+        }
+
+        std::optional<size_t> ParseGroup(uint32_t depth)
+        {
+            if (Skip(L'?'))
+            {
+                if (Skip(L':'))
+                {
+                }
+                else if ((Peek() == L'<' && Peek(1) != L'=' && Peek(1) != L'!') || Peek() == L'\'')
+                {
+                    // Named groups don't capture anything here, so they are plain groups
+                    wchar_t close = Peek() == L'<' ? L'>' : L'\'';
+                    size_t end = m_pattern.find(close, m_position + 1);
+                    if (end == std::wstring_view::npos || end == m_position + 1)
+                    {
+                        return std::nullopt;
+                    }
+                    m_position = end + 1;
+                }
+                else
+                {
+                    return std::nullopt;   // Lookarounds, atomic groups and inline flags past the start
+                }
+            }
+
+            auto group = ParseAlternation(depth + 1);
+            if (!group || !Skip(L')'))
+            {
+                return std::nullopt;
+            }
+            return group;
+        }
+
+        bool ParseQuantifier(uint32_t& min, uint32_t& max)
+        {
+            switch (Peek())
+            {
+            case L'*':
+                min = 0;
+                max = UNBOUNDED;
+                break;
+            case L'+':
+                min = 1;
+                max = UNBOUNDED;
+                break;
+            case L'?':
+                min = 0;
+                max = 1;
+                break;
+            case L'{':
+                return ParseCount(min, max);
+            default:
+                return false;
+            }
+
+            m_position++;
+            return true;
+        }
+
+        // {n}, {n,} or {n,m}. Anything else is a literal brace, as in .NET
+        bool ParseCount(uint32_t& min, uint32_t& max)
+        {
+            size_t start = m_position;
+            m_position++;
+
+            auto readNumber = [this]() -> std::optional<uint32_t>
+                {
+                    size_t digitsStart = m_position;
+                    uint32_t value = 0;
+                    while (!AtEnd() && Peek() >= L'0' && Peek() <= L'9')
+                    {
+                        value = std::min<uint32_t>(value * 10 + (Peek() - L'0'), MAX_REPEAT + 1);
+                        m_position++;
+                    }
+                    return m_position > digitsStart ? std::optional{ value } : std::nullopt;
+                };
+
+            auto first = readNumber();
+            if (first)
+            {
+                min = *first;
+                max = *first;
+
+                if (Skip(L','))
+                {
+                    auto second = readNumber();
+                    max = second ? *second : UNBOUNDED;
+                }
+
+                if (Skip(L'}'))
+                {
+                    return true;
+                }
+            }
+
+            m_position = start;
+            return false;
+        }
+
+        std::optional<size_t> ParseEscape()
+        {
+            if (AtEnd())
+            {
+                return std::nullopt;
+            }
+
+            wchar_t c = Peek();
+            const CharSets& sets = GetCharSets();
+
+            switch (c)
+            {
+            case L'd':
+            case L'D':
+            case L'w':
+            case L'W':
+            case L's':
+            case L'S':
+            {
+                m_position++;
+                wchar_t lower = c | 0x20;
+                const CharSet& set = lower == L'd' ? sets.digit : lower == L'w' ? sets.word : sets.space;
+                auto index = AddClass(set, c != lower);
+                return index ? std::optional{ AddNode({ .type = Node::Type::Class, .classIndex = *index }) } : std::nullopt;
+            }
+            case L'b':
+                m_position++;
+                return AddNode({ .type = Node::Type::Assert, .assertion = Assertion::WordBoundary });
+            case L'B':
+                m_position++;
+                return AddNode({ .type = Node::Type::Assert, .assertion = Assertion::NotWordBoundary });
+            case L'A':
+                m_position++;
+                return AddNode({ .type = Node::Type::Assert, .assertion = Assertion::TextStart });
+            case L'Z':
+                m_position++;
+                return AddNode({ .type = Node::Type::Assert, .assertion = Assertion::TextEnd });
+            case L'z':
+                m_position++;
+                return AddNode({ .type = Node::Type::Assert, .assertion = Assertion::AbsoluteEnd });
+            default:
+            {
+                auto escaped = ParseCharEscape();
+                return escaped ? std::optional{ AddChar(*escaped) } : std::nullopt;
+            }
+            }
+        }
+
+        // The character after a backslash, for escapes that stand for one character
+        std::optional<wchar_t> ParseCharEscape()
+        {
+            wchar_t c = Peek();
+            m_position++;
+
+            switch (c)
+            {
+            case L'n':
+                return L'\n';
+            case L'r':
+                return L'\r';
+            case L't':
+                return L'\t';
+            case L'f':
+                return L'\f';
+            case L'v':
+                return L'\v';
+            case L'a':
+                return L'\a';
+            case L'e':
+                return L'\x1B';
+            case L'0':
+                return L'\0';
+            case L'x':
+            case L'u':
+            {
+                size_t length = c == L'x' ? 2 : 4;
+                if (m_pattern.size() - m_position < length)
+                {
+                    return std::nullopt;
+                }
+
+                auto value = ParseHex(m_pattern.substr(m_position, length));
+                m_position += length;
+                return value ? std::optional{ static_cast<wchar_t>(*value) } : std::nullopt;
+            }
+            default:
+                // Backreferences and unknown letter escapes are errors, other characters stand for themselves
+                bool isLetterOrDigit = (c >= L'0' && c <= L'9') || ((c | 0x20) >= L'a' && (c | 0x20) <= L'z');
+                return isLetterOrDigit ? std::nullopt : std::optional{ c };
+            }
+        }
+
+        std::optional<size_t> ParseClass()
+        {
+            bool isNegated = Skip(L'^');
+            CharSet set;
+            bool isFirst = true;
+
+            while (true)
+            {
+                if (AtEnd())
+                {
+                    return std::nullopt;
+                }
+
+                // A closing bracket right after the opening one is a literal
+                if (!isFirst && Skip(L']'))
+                {
+                    break;
+                }
+                isFirst = false;
+
+                std::optional<wchar_t> low;
+                if (!ParseClassAtom(set, low))
+                {
+                    return std::nullopt;
+                }
+
+                if (!low)
+                {
+                    continue;
+                }
+
+                // A range, unless the dash is the last character of the class
+                if (Peek() == L'-' && Peek(1) != L']' && m_position + 1 < m_pattern.size())
+                {
+                    m_position++;
+
+                    std::optional<wchar_t> high;
+                    if (!ParseClassAtom(set, high) || !high || *high < *low)
+                    {
+                        return std::nullopt;
+                    }
+
+                    for (uint32_t i = *low; i <= *high; i++)
+                    {
+                        set.set(i);
+                    }
+                }
+                else
+                {
+                    set.set(*low);
+                }
+            }
+
+            auto index = AddClass(set, isNegated);
+            return index ? std::optional{ AddNode({ .type = Node::Type::Class, .classIndex = *index }) } : std::nullopt;
+        }
+
+        // Either a single character in c, or a shorthand class added to the set
+        bool ParseClassAtom(CharSet& set, std::optional<wchar_t>& c)
+        {
+            if (!Skip(L'\\'))
+            {
+                c = Peek();
+                m_position++;
+                return true;
+            }
+
+            if (AtEnd())
+            {
+                return false;
+            }
+
+            const CharSets& sets = GetCharSets();
+            switch (Peek())
+            {
+            case L'd':
+                set |= sets.digit;
+                break;
+            case L'D':
+                set |= ~sets.digit;
+                break;
+            case L'w':
+                set |= sets.word;
+                break;
+            case L'W':
+                set |= ~sets.word;
+                break;
+            case L's':
+                set |= sets.space;
+                break;
+            case L'S':
+                set |= ~sets.space;
+                break;
+            case L'b':
+                c = L'\b';
+                break;
+            default:
+                c = ParseCharEscape();
+                return c.has_value();
+            }
+
+            m_position++;
+            return true;
+        }
+
+        size_t AddChar(wchar_t c)
+        {
+            return AddNode({ .type = Node::Type::Char, .c = m_program.m_ignoreCase ? FuzzyScorer::Fold(c) : c });
+        }
+
+        // Classes are stored as they are tested: by lowercase when ignoring case, with negation applied
+        std::optional<uint32_t> AddClass(const CharSet& set, bool isNegated)
+        {
+            if (m_program.m_classes.size() >= MAX_CLASSES)
+            {
+                return std::nullopt;
+            }
+
+            CharSet stored;
+            if (m_program.m_ignoreCase)
+            {
+                for (uint32_t i = 0; i < set.size(); i++)
+                {
+                    if (set.test(i))
+                    {
+                        stored.set(FuzzyScorer::Fold(static_cast<wchar_t>(i)));
+                    }
+                }
+            }
+            else
+            {
+                stored = set;
+            }
+
+            if (isNegated)
+            {
+                stored.flip();
+            }
+
+            m_program.m_classes.push_back(stored);
+            return static_cast<uint32_t>(m_program.m_classes.size() - 1);
+        }
+    };
+
+    // Dense list of threads with a sparse index, so adding, checking and clearing are all constant time
+    struct RegexProgram::ThreadList
+    {
+        std::vector<uint32_t> sparse;
+        std::vector<uint32_t> pcs;
+        std::vector<size_t> starts;
+        size_t count = 0;
+
+        void Reset(size_t programSize)
+        {
+            if (sparse.size() < programSize)
+            {
+                sparse.resize(programSize);
+                pcs.resize(programSize);
+                starts.resize(programSize);
+            }
+            count = 0;
+        }
+
+        bool Contains(uint32_t pc) const
+        {
+            uint32_t index = sparse[pc];
+            return index < count && pcs[index] == pc;
+        }
+
+        void Add(uint32_t pc, size_t start)
+        {
+            sparse[pc] = static_cast<uint32_t>(count);
+            pcs[count] = pc;
+            starts[count] = start;
+            count++;
+        }
+    };
+
+    std::optional<RegexProgram> RegexProgram::Compile(std::wstring_view pattern, bool ignoreCase)
+    {
+        RegexProgram program;
+        program.m_ignoreCase = ignoreCase;
+
+        Parser parser(pattern, program);
+        auto root = parser.Parse();
+        if (!root || !program.Emit(parser.Nodes(), *root))
+        {
+            return std::nullopt;
+        }
+
+        program.Add({ OpCode::Match });
+
+        // A leading anchor or literal limits where a match can start
+        const auto& nodes = parser.Nodes();
+        const Node& rootNode = nodes[*root];
+        std::vector<size_t> items = rootNode.type == Node::Type::Concat ? rootNode.children : std::vector<size_t>{ *root };
+
+        if (nodes[items.front()].type == Node::Type::Assert && nodes[items.front()].assertion == Assertion::TextStart)
+        {
+            program.m_isAnchored = true;
+        }
+        else
+        {
+            for (size_t item : items)
+            {
+                if (nodes[item].type != Node::Type::Char)
+                {
+                    break;
+                }
+                program.m_prefix.push_back(nodes[item].c);
+            }
+
+            if (program.m_prefix.empty())
+            {
+                program.FindFirstChars();
+            }
+        }
+
+        return program;
+    }
+
+    bool RegexProgram::IsMatch(std::wstring_view text) const
+    {
+        return Search(text, 0, true).has_value();
+    }
+
+    std::vector<std::pair<size_t, size_t>> RegexProgram::FindAll(std::wstring_view text, size_t maxCount) const
+    {
+        std::vector<std::pair<size_t, size_t>> matches;
+        size_t position = 0;
+
+        while (matches.size() < maxCount && position <= text.size())
+        {
+            auto match = Search(text, position, false);
+            if (!match)
+            {
+                break;
+            }
+
+            // Empty matches are skipped past, so the search always moves on
+            auto [start, length] = *match;
+            if (length > 0)
+            {
+                matches.push_back(*match);
+            }
+            position = start + std::max<size_t>(length, 1);
+        }
+
+        return matches;
+    }
+
+    const RegexProgram::CharSets& RegexProgram::GetCharSets()
+    {
+        static const std::unique_ptr<CharSets> sets = []()
+            {
+                auto sets = std::make_unique<CharSets>();
+
+                std::array<wchar_t, 0x10000> chars;
+                for (size_t i = 0; i < chars.size(); i++)
+                {
+                    chars[i] = static_cast<wchar_t>(i);
+                }
+
+                std::array<WORD, 0x10000> types{};
+                GetStringTypeW(CT_CTYPE1, chars.data(), static_cast<int>(chars.size()), types.data());
+
+                for (size_t i = 0; i < chars.size(); i++)
+                {
+                    sets->digit[i] = (types[i] & C1_DIGIT) != 0;
+                    sets->space[i] = (types[i] & C1_SPACE) != 0;
+                    sets->word[i] = (types[i] & (C1_ALPHA | C1_DIGIT)) != 0 || chars[i] == L'_';
+                }
+
+                return sets;
+            }();
+
+        return *sets;
+    }
+
+    bool RegexProgram::Emit(const std::vector<Node>& nodes, size_t index)
+    {
+        if (m_program.size() > MAX_INSTRUCTIONS)
+        {
+            return false;
+        }
+
+        const Node& node = nodes[index];
+
+        switch (node.type)
+        {
+        case Node::Type::Empty:
+            return true;
+        case Node::Type::Char:
+            Add({ .op = OpCode::Char, .c = node.c });
+            return true;
+        case Node::Type::Any:
+            Add({ OpCode::Any });
+            return true;
+        case Node::Type::AnyNewline:
+            Add({ OpCode::AnyNewline });
+            return true;
+        case Node::Type::Class:
+            Add({ .op = OpCode::Class, .x = node.classIndex });
+            return true;
+        case Node::Type::Assert:
+            Add({ .op = OpCode::Assert, .assertion = node.assertion });
+            return true;
+        case Node::Type::Concat:
+            for (size_t child : node.children)
+            {
+                if (!Emit(nodes, child))
+                {
+                    return false;
+                }
+            }
+            return true;
+        case Node::Type::Alternate:
+        {
+            // Each branch but the last is tried first through a split, all of them jump past the rest
+            std::vector<size_t> jumps;
+            for (size_t i = 0; i < node.children.size(); i++)
+            {
+                bool isLast = i + 1 == node.children.size();
+                size_t split = isLast ? 0 : Add({ OpCode::Split });
+
+                if (!Emit(nodes, node.children[i]))
+                {
+                    return false;
+                }
+
+                if (!isLast)
+                {
+                    jumps.push_back(Add({ OpCode::Jump }));
+                    m_program[split].x = static_cast<uint32_t>(split + 1);
+                    m_program[split].y = static_cast<uint32_t>(m_program.size());
+                }
+            }
+
+            for (size_t jump : jumps)
+            {
+                m_program[jump].x = static_cast<uint32_t>(m_program.size());
+            }
+            return true;
+        }
+        case Node::Type::Repeat:
+        {
+            size_t child = node.children.front();
+            auto setSplit = [&](size_t split, size_t preferred, size_t other)
+                {
+                    m_program[split].x = static_cast<uint32_t>(node.isGreedy ? preferred : other);
+                    m_program[split].y = static_cast<uint32_t>(node.isGreedy ? other : preferred);
+                };
+
+            if (node.max == UNBOUNDED)
+            {
+                // min - 1 copies, then a copy that loops back to itself
+                for (uint32_t i = 1; i < node.min; i++)
+                {
+                    if (!Emit(nodes, child))
+                    {
+                        return false;
+                    }
+                }
+
+                if (node.min > 0)
+                {
+                    size_t loop = m_program.size();
+                    if (!Emit(nodes, child))
+                    {
+                        return false;
+                    }
+                    size_t split = Add({ OpCode::Split });
+                    setSplit(split, loop, split + 1);
+                }
+                else
+                {
+                    size_t split = Add({ OpCode::Split });
+                    if (!Emit(nodes, child))
+                    {
+                        return false;
+                    }
+                    Add({ .op = OpCode::Jump, .x = static_cast<uint32_t>(split) });
+                    setSplit(split, split + 1, m_program.size());
+                }
+                return true;
+            }
+
+            for (uint32_t i = 0; i < node.min; i++)
+            {
+                if (!Emit(nodes, child))
+                {
+                    return false;
+                }
+            }
+
+            // Optional copies, each one skipping to the end when it isn't taken
+            std::vector<size_t> splits;
+            for (uint32_t i = node.min; i < node.max; i++)
+            {
+                splits.push_back(Add({ OpCode::Split }));
+                if (!Emit(nodes, child))
+                {
+                    return false;
+                }
+            }
+
+            for (size_t split : splits)
+            {
+                setSplit(split, split + 1, m_program.size());
+            }
+            return true;
+        }
+        }
+
+        return false;
+    }
+
+    size_t RegexProgram::Add(Instruction instruction)
+    {
+        m_program.push_back(instruction);
+        return m_program.size() - 1;
+    }
+
+    void RegexProgram::FindFirstChars()
+    {
+        CharSet firstChars;
+        std::vector<bool> isVisited(m_program.size());
+        std::vector<uint32_t> stack{ 0 };
+
+        while (!stack.empty())
+        {
+            uint32_t pc = stack.back();
+            stack.pop_back();
+
+            if (isVisited[pc])
+            {
+                continue;
+            }
+            isVisited[pc] = true;
+
+            const Instruction& instruction = m_program[pc];
+            switch (instruction.op)
+            {
+            case OpCode::Char:
+                firstChars.set(instruction.c);
+                break;
+            case OpCode::Any:
+                firstChars.set();
+                firstChars.reset(L'\n');
+                break;
+            case OpCode::Class:
+                firstChars |= m_classes[instruction.x];
+                break;
+            case OpCode::Assert:
+                stack.push_back(pc + 1);   // Assumed to hold, which only makes the set larger
+                break;
+            case OpCode::Split:
+                stack.push_back(instruction.x);
+                stack.push_back(instruction.y);
+                break;
+            case OpCode::Jump:
+                stack.push_back(instruction.x);
+                break;
+            default:
+                return;   // Anything can start a match, or an empty match can start anywhere
+            }
+        }
+
+        m_firstChars = firstChars;
+        m_hasFirstChars = true;
+    }
+
+    bool RegexProgram::Accepts(const Instruction& instruction, wchar_t c) const
+    {
+        wchar_t key = m_ignoreCase ? FuzzyScorer::Fold(c) : c;
+
+        switch (instruction.op)
+        {
+        case OpCode::Char:
+            return key == instruction.c;
+        case OpCode::Any:
+            return c != L'\n';
+        case OpCode::AnyNewline:
+            return true;
+        case OpCode::Class:
+            return m_classes[instruction.x].test(key);
+        default:
+            return false;
+        }
+    }
+
+    bool RegexProgram::IsAsserted(Assertion assertion, std::wstring_view text, size_t position)
+    {
+        auto isWordAt = [&](size_t i) { return i < text.size() && GetCharSets().word.test(text[i]); };
+
+        switch (assertion)
+        {
+        case Assertion::TextStart:
+            return position == 0;
+        case Assertion::TextEnd:
+            return position == text.size() || (position + 1 == text.size() && text[position] == L'\n');
+        case Assertion::AbsoluteEnd:
+            return position == text.size();
+        case Assertion::LineStart:
+            return position == 0 || text[position - 1] == L'\n';
+        case Assertion::LineEnd:
+            return position == text.size() || text[position] == L'\n';
+        case Assertion::WordBoundary:
+            return (position > 0 && isWordAt(position - 1)) != isWordAt(position);
+        case Assertion::NotWordBoundary:
+            return (position > 0 && isWordAt(position - 1)) == isWordAt(position);
+        default:
+            return false;
+        }
+    }
+
+    size_t RegexProgram::FindCandidate(std::wstring_view text, size_t position) const
+    {
+        if (m_prefix.empty())
+        {
+            if (!m_hasFirstChars)
+            {
+                return position;
+            }
+
+            for (size_t i = position; i < text.size(); i++)
+            {
+                if (m_firstChars.test(m_ignoreCase ? FuzzyScorer::Fold(text[i]) : text[i]))
+                {
+                    return i;
+                }
+            }
+            return std::wstring_view::npos;
+        }
+
+        if (!m_ignoreCase)
+        {
+            return text.find(m_prefix, position);
+        }
+
+        for (size_t i = position; i < text.size() && text.size() - i >= m_prefix.size(); i++)
+        {
+            size_t k = 0;
+            while (k < m_prefix.size() && FuzzyScorer::Fold(text[i + k]) == m_prefix[k])
+            {
+                k++;
+            }
+
+            if (k == m_prefix.size())
+            {
+                return i;
+            }
+        }
+
+        return std::wstring_view::npos;
+    }
+
+    void RegexProgram::AddThread(ThreadList& list, uint32_t pc, size_t start, std::wstring_view text, size_t position) const
+    {
+        thread_local std::vector<uint32_t> stack;
+        stack.clear();
+        stack.push_back(pc);
+
+        // Depth first, the preferred branch of a split before the other one
+        while (!stack.empty())
+        {
+            pc = stack.back();
+            stack.pop_back();
+
+            if (list.Contains(pc))
+            {
+                continue;
+            }
+            list.Add(pc, start);
+
+            const Instruction& instruction = m_program[pc];
+            switch (instruction.op)
+            {
+            case OpCode::Jump:
+                stack.push_back(instruction.x);
+                break;
+            case OpCode::Split:
+                stack.push_back(instruction.y);
+                stack.push_back(instruction.x);
+                break;
+            case OpCode::Assert:
+                if (IsAsserted(instruction.assertion, text, position))
+                {
+                    stack.push_back(pc + 1);
+                }
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    std::optional<std::pair<size_t, size_t>> RegexProgram::Search(std::wstring_view text, size_t position, bool isAnyMatchEnough) const
+    {
+        thread_local ThreadList current;
+        thread_local ThreadList next;
+        current.Reset(m_program.size());
+        next.Reset(m_program.size());
+
+        std::optional<std::pair<size_t, size_t>> match;
+        size_t i = position;
+
+        while (true)
+        {
+            // New threads start at every position until a match is found, they have the lowest priority
+            if (!match && (!m_isAnchored || i == 0))
+            {
+                if (current.count == 0)
+                {
+                    i = FindCandidate(text, i);
+                    if (i == std::wstring_view::npos)
+                    {
+                        break;
+                    }
+                }
+                AddThread(current, 0, i, text, i);
+            }
+
+            if (current.count == 0)
+            {
+                break;
+            }
+
+            next.count = 0;
+            for (size_t k = 0; k < current.count; k++)
+            {
+                const Instruction& instruction = m_program[current.pcs[k]];
+
+                if (instruction.op == OpCode::Match)
+                {
+                    match = { current.starts[k], i - current.starts[k] };
+                    if (isAnyMatchEnough)
+                    {
+                        return match;
+                    }
+                    break;   // Threads after this one have lower priority and lose to it
+                }
+
+                if (i < text.size() && Accepts(instruction, text[i]))
+                {
+                    AddThread(next, current.pcs[k] + 1, current.starts[k], text, i + 1);
+                }
+            }
+
+            if (i >= text.size())
+            {
+                break;
+            }
+
+            std::swap(current, next);
+            i++;
+        }
+
+        return match;
+    }
+}
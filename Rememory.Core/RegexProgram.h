@@ -0,0 +1,104 @@
+#pragma once
+#include "pch.h"
+#include <bitset>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace winrt::Rememory::Core::implementation
+{
+    // Regular expressions run on a Pike VM, which steps every live NFA thread over each character at once
+    // instead of backtracking. Matching is linear in the length of the text for any pattern, so no pattern can hang
+    // a search, at the cost of backreferences and lookarounds, which can't be matched that way.
+    //
+    // The syntax is the common subset of .NET's: literals and escapes, ., [classes], \d \w \s and their negations,
+    // ^ $ \A \z \b \B, groups, alternation, greedy and lazy * + ? {n,m}, and leading (?ims) flags.
+    // Characters are UTF-16 code units, and ignoring case compares invariant lowercase.
+    class RegexProgram
+    {
+    public:
+        static std::optional<RegexProgram> Compile(std::wstring_view pattern, bool ignoreCase);
+
+        bool IsMatch(std::wstring_view text) const;
+
+        // Leftmost-first matches as start and length, the same ones a backtracking engine would find
+        std::vector<std::pair<size_t, size_t>> FindAll(std::wstring_view text, size_t maxCount) const;
+
+    private:
+        enum class OpCode : uint8_t
+        {
+            Char,
+            Any,          // Anything but a newline
+            AnyNewline,   // Anything, with (?s)
+            Class,
+            Assert,
+            Split,        // Continues at x first, then at y
+            Jump,
+            Match
+        };
+
+        enum class Assertion : uint8_t
+        {
+            TextStart,
+            TextEnd,        // End of the text or before a final newline
+            AbsoluteEnd,
+            LineStart,
+            LineEnd,
+            WordBoundary,
+            NotWordBoundary
+        };
+
+        struct Instruction
+        {
+            OpCode op;
+            Assertion assertion = Assertion::TextStart;
+            wchar_t c = 0;
+            uint32_t x = 0;   // Jump target or class index
+            uint32_t y = 0;
+        };
+
+        using CharSet = std::bitset<0x10000>;
+
+        struct CharSets
+        {
+            CharSet word;
+            CharSet digit;
+            CharSet space;
+        };
+
+        class Parser;
+        struct Node;
+        struct ThreadList;
+
+        // Repetition expands into copies, so large counts are refused before they blow up the program
+        static constexpr uint32_t MAX_REPEAT = 1000;
+        static constexpr size_t MAX_INSTRUCTIONS = 20000;
+        static constexpr size_t MAX_CLASSES = 256;
+
+        std::vector<Instruction> m_program;
+        std::vector<CharSet> m_classes;   // Indexed by the character, or by its lowercase when ignoring case
+        std::wstring m_prefix;            // Literal every match starts with, used to skip to candidate positions
+        CharSet m_firstChars;             // Characters a match can start with, when there's no prefix
+        bool m_hasFirstChars = false;
+        bool m_ignoreCase = false;
+        bool m_isAnchored = false;
+
+        static const CharSets& GetCharSets();
+
+        bool Emit(const std::vector<Node>& nodes, size_t index);
+        size_t Add(Instruction instruction);
+        void FindFirstChars();
+
+        bool Accepts(const Instruction& instruction, wchar_t c) const;
+        static bool IsAsserted(Assertion assertion, std::wstring_view text, size_t position);
+        size_t FindCandidate(std::wstring_view text, size_t position) const;
+
+        // Adds the thread and every thread reachable from it without consuming a character, in priority order
+        void AddThread(ThreadList& list, uint32_t pc, size_t start, std::wstring_view text, size_t position) const;
+
+        // Leftmost-first match at or after position, or just whether there is any with isAnyMatchEnough
+        std::optional<std::pair<size_t, size_t>> Search(std::wstring_view text, size_t position, bool isAnyMatchEnough) const;
+    };
+}
@@ -0,0 +1,748 @@
+#include "pch.h"
+#include <algorithm>
+#include <array>
+#include "TextExtractor.h"
+
+namespace {
+    const size_t MAX_HTML_ENTITY_LENGTH = 10;
+    const unsigned int DEFAULT_RTF_CODE_PAGE = 1252;
+    const long MAX_RTF_PARAMETER = 99999999;   // Parameters are 16-bit by the spec, longer runs of digits saturate here
+    const long MAX_RTF_UNICODE_SKIP = 16;      // Fallback characters after \u, writers emit one or two
+
+    constexpr bool IsAsciiSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f';
+    }
+
+    constexpr bool IsAsciiAlpha(char c)
+    {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    }
+
+    constexpr bool IsAsciiDigit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    constexpr char ToAsciiLower(char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    bool EqualsIgnoreCase(std::string_view left, std::string_view right)
+    {
+        return left.size() == right.size()
+            && std::equal(left.begin(), left.end(), right.begin(), [](char l, char r) { return ToAsciiLower(l) == ToAsciiLower(r); });
+    }
+
+    bool StartsWithIgnoreCase(std::string_view text, size_t position, std::string_view prefix)
+    {
+        return position + prefix.size() <= text.size() && EqualsIgnoreCase(text.substr(position, prefix.size()), prefix);
+    }
+
+    int HexDigitValue(char c)
+    {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    // Tags that start a new line in the rendered document
+    bool IsHtmlBlockTag(std::string_view name)
+    {
+        static constexpr std::array<std::string_view, 20> blockTags
+        {
+            "p", "div", "li", "tr", "ul", "ol", "table", "blockquote", "pre", "section",
+            "article", "header", "footer", "h1", "h2", "h3", "h4", "h5", "h6", "dd"
+        };
+
+        return std::any_of(blockTags.begin(), blockTags.end(), [name](std::string_view tag) { return EqualsIgnoreCase(name, tag); });
+    }
+
+    // RTF destinations whose content is never part of the visible text
+    bool IsRtfIgnoredDestination(std::string_view word)
+    {
+        static constexpr std::array<std::string_view, 28> destinations
+        {
+            "fonttbl", "colortbl", "stylesheet", "info", "pict", "object", "header", "headerl",
+            "headerr", "headerf", "footer", "footerl", "footerr", "footerf", "footnote", "themedata",
+            "colorschememapping", "datastore", "latentstyles", "listtable", "listoverridetable", "rsidtbl",
+            "generator", "xmlnstbl", "fldinst", "nonshppict", "filetbl", "revtbl"
+        };
+
+        return std::find(destinations.begin(), destinations.end(), word) != destinations.end();
+    }
+}
+
+namespace winrt::Rememory::Core::implementation
+{
+    TextExtractor::TextWriter::TextWriter(size_t expectedLength)
+    {
+        m_text.reserve(expectedLength);
+    }
+
+    void TextExtractor::TextWriter::Append(char32_t codePoint)
+    {
+        if (m_pendingSpace && !m_atLineStart)
+        {
+            m_text.push_back(L' ');
+        }
+
+        if (codePoint > 0xFFFF)
+        {
+            codePoint -= 0x10000;
+            m_text.push_back(static_cast<wchar_t>(0xD800 + (codePoint >> 10)));
+            m_text.push_back(static_cast<wchar_t>(0xDC00 + (codePoint & 0x3FF)));
+        }
+        else
+        {
+            m_text.push_back(static_cast<wchar_t>(codePoint));
+        }
+
+        m_pendingSpace = false;
+        m_atLineStart = false;
+        m_lineBreakCount = 0;
+    }
+
+    void TextExtractor::TextWriter::AppendSpace()
+    {
+        m_pendingSpace = true;
+    }
+
+    void TextExtractor::TextWriter::AppendLineBreak(bool force)
+    {
+        // Keep at most one empty line between paragraphs
+        if (m_text.empty() || m_lineBreakCount >= 2 || (!force && m_atLineStart))
+        {
+            return;
+        }
+
+        m_text.append(L"\r\n");
+        m_pendingSpace = false;
+        m_atLineStart = true;
+        m_lineBreakCount++;
+    }
+
+    void TextExtractor::TextWriter::AppendTab()
+    {
+        if (!m_atLineStart)
+        {
+            m_text.push_back(L'\t');
+            m_pendingSpace = false;
+        }
+    }
+
+    std::wstring TextExtractor::TextWriter::Finish()
+    {
+        while (!m_text.empty() && (m_text.back() == L'\r' || m_text.back() == L'\n' || m_text.back() == L'\t' || m_text.back() == L' '))
+        {
+            m_text.pop_back();
+        }
+
+        return std::move(m_text);
+    }
+
+
+    std::wstring TextExtractor::ExtractFromHtml(std::string_view cfHtml)
+    {
+        cfHtml = cfHtml.substr(0, cfHtml.find('\0'));
+        std::string_view html = GetHtmlFragment(cfHtml);
+
+        TextWriter writer{ html.size() / 2 };
+        size_t position = 0;
+
+        while (position < html.size())
+        {
+            char c = html[position];
+
+            if (c == '<')
+            {
+                if (html.compare(position, 4, "<!--") == 0)
+                {
+                    size_t commentEnd = html.find("-->", position + 4);
+                    position = commentEnd == std::string_view::npos ? html.size() : commentEnd + 3;
+                    continue;
+                }
+
+                size_t nameStart = position + 1;
+                bool isClosingTag = nameStart < html.size() && html[nameStart] == '/';
+                if (isClosingTag)
+                {
+                    nameStart++;
+                }
+
+                size_t nameEnd = nameStart;
+                while (nameEnd < html.size() && (IsAsciiAlpha(html[nameEnd]) || IsAsciiDigit(html[nameEnd])))
+                {
+                    nameEnd++;
+                }
+
+                std::string_view tagName = html.substr(nameStart, nameEnd - nameStart);
+                if (tagName.empty() || !IsAsciiAlpha(tagName.front()))
+                {
+                    // Not a tag, e.g. "a < b"
+                    writer.Append(U'<');
+                    position++;
+                    continue;
+                }
+
+                // Find the end of the tag, ignoring '>' inside quoted attribute values
+                char quote = 0;
+                size_t tagEnd = nameEnd;
+                for (; tagEnd < html.size(); tagEnd++)
+                {
+                    if (quote)
+                    {
+                        if (html[tagEnd] == quote) quote = 0;
+                    }
+                    else if (html[tagEnd] == '"' || html[tagEnd] == '\'')
+                    {
+                        quote = html[tagEnd];
+                    }
+                    else if (html[tagEnd] == '>')
+                    {
+                        break;
+                    }
+                }
+                position = tagEnd < html.size() ? tagEnd + 1 : html.size();
+
+                if (!isClosingTag && (EqualsIgnoreCase(tagName, "script") || EqualsIgnoreCase(tagName, "style")))
+                {
+                    // Skip everything up to the matching closing tag
+                    size_t closingTag = position;
+                    while ((closingTag = html.find("</", closingTag)) != std::string_view::npos
+                        && !StartsWithIgnoreCase(html, closingTag + 2, tagName))
+                    {
+                        closingTag += 2;
+                    }
+
+                    if (closingTag == std::string_view::npos)
+                    {
+                        position = html.size();
+                    }
+                    else
+                    {
+                        size_t closingTagEnd = html.find('>', closingTag);
+                        position = closingTagEnd == std::string_view::npos ? html.size() : closingTagEnd + 1;
+                    }
+                }
+                else if (EqualsIgnoreCase(tagName, "br"))
+                {
+                    writer.AppendLineBreak(true);
+                }
+                else if (EqualsIgnoreCase(tagName, "td") || EqualsIgnoreCase(tagName, "th"))
+                {
+                    if (isClosingTag)
+                    {
+                        writer.AppendTab();
+                    }
+                }
+                else if (IsHtmlBlockTag(tagName))
+                {
+                    writer.AppendLineBreak(false);
+                }
+
+                continue;
+            }
+
+            if (c == '&')
+            {
+                char32_t codePoint = 0;
+                if (DecodeHtmlEntity(html, position, codePoint))
+                {
+                    if (codePoint == U'\u00A0')
+                    {
+                        writer.AppendSpace();
+                    }
+                    else
+                    {
+                        writer.Append(codePoint);
+                    }
+                    continue;
+                }
+
+                writer.Append(U'&');
+                position++;
+                continue;
+            }
+
+            if (IsAsciiSpace(c))
+            {
+                writer.AppendSpace();
+                position++;
+                continue;
+            }
+
+            writer.Append(DecodeUtf8(html, position));
+        }
+
+        return writer.Finish();
+    }
+
+    std::wstring TextExtractor::ExtractFromRtf(std::string_view rtf)
+    {
+        struct GroupState
+        {
+            int unicodeSkipCount = 1;
+            bool isIgnored = false;
+        };
+
+        rtf = rtf.substr(0, rtf.find('\0'));
+
+        TextWriter writer{ rtf.size() / 4 };
+        std::vector<GroupState> groups;
+        std::vector<char> pendingBytes;
+        GroupState state;
+        unsigned int codePage = DEFAULT_RTF_CODE_PAGE;
+        int charsToSkip = 0;   // Fallback characters that follow a \uN control word
+        size_t position = 0;
+
+        auto emitByte = [&](char byte)
+        {
+            if (state.isIgnored)
+            {
+                return;
+            }
+
+            if (charsToSkip > 0)
+            {
+                charsToSkip--;
+                return;
+            }
+
+            if (static_cast<unsigned char>(byte) < 0x80 && pendingBytes.empty())
+            {
+                writer.Append(static_cast<char32_t>(byte));
+            }
+            else
+            {
+                pendingBytes.push_back(byte);
+            }
+        };
+
+        while (position < rtf.size())
+        {
+            char c = rtf[position];
+
+            if (c == '{')
+            {
+                FlushRtfBytes(pendingBytes, codePage, writer);
+                groups.push_back(state);
+                charsToSkip = 0;
+                position++;
+
+                if (rtf.compare(position, 2, "\\*") == 0)
+                {
+                    state.isIgnored = true;
+                    position += 2;
+                }
+                continue;
+            }
+
+            if (c == '}')
+            {
+                FlushRtfBytes(pendingBytes, codePage, writer);
+                if (!groups.empty())
+                {
+                    state = groups.back();
+                    groups.pop_back();
+                }
+                charsToSkip = 0;
+                position++;
+                continue;
+            }
+
+            if (c == '\r' || c == '\n')
+            {
+                position++;
+                continue;
+            }
+
+            if (c != '\\')
+            {
+                emitByte(c);
+                position++;
+                continue;
+            }
+
+            // Control word or control symbol
+            position++;
+            if (position >= rtf.size())
+            {
+                break;
+            }
+
+            char symbol = rtf[position];
+
+            if (symbol == '\'')
+            {
+                int high = position + 1 < rtf.size() ? HexDigitValue(rtf[position + 1]) : -1;
+                int low = position + 2 < rtf.size() ? HexDigitValue(rtf[position + 2]) : -1;
+                position += 3;
+
+                if (high >= 0 && low >= 0)
+                {
+                    emitByte(static_cast<char>((high << 4) | low));
+                }
+                continue;
+            }
+
+            if (!IsAsciiAlpha(symbol))
+            {
+                position++;
+                FlushRtfBytes(pendingBytes, codePage, writer);
+
+                if (state.isIgnored)
+                {
+                    continue;
+                }
+
+                switch (symbol)
+                {
+                case '\\':
+                case '{':
+                case '}':
+                    writer.Append(static_cast<char32_t>(symbol));
+                    break;
+                case '~':
+                    writer.AppendSpace();
+                    break;
+                case '_':
+                    writer.Append(U'-');
+                    break;
+                case '\r':
+                case '\n':
+                    writer.AppendLineBreak(true);
+                    break;
+                }
+                continue;
+            }
+
+            size_t wordStart = position;
+            while (position < rtf.size() && IsAsciiAlpha(rtf[position]))
+            {
+                position++;
+            }
+            std::string_view word = rtf.substr(wordStart, position - wordStart);
+
+            bool hasParameter = false;
+            bool isNegative = false;
+            long parameter = 0;
+
+            if (position < rtf.size() && rtf[position] == '-')
+            {
+                isNegative = true;
+                position++;
+            }
+
+            // Every digit still belongs to the control word, only the value stops growing
+            while (position < rtf.size() && IsAsciiDigit(rtf[position]))
+            {
+                hasParameter = true;
+                parameter = std::min(parameter * 10 + (rtf[position] - '0'), MAX_RTF_PARAMETER);
+                position++;
+            }
+            parameter = isNegative ? -parameter : parameter;
+
+            // A single space is the delimiter of the control word
+            if (position < rtf.size() && rtf[position] == ' ')
+            {
+                position++;
+            }
+
+            if (word == "bin")
+            {
+                // Raw binary data follows, skip it without parsing
+                position = std::min(rtf.size(), position + static_cast<size_t>(std::max(0L, parameter)));
+                continue;
+            }
+
+            if (word == "u")
+            {
+                FlushRtfBytes(pendingBytes, codePage, writer);
+                if (!state.isIgnored && hasParameter)
+                {
+                    // A signed 16-bit UTF-16 code unit, characters past the BMP come as two of them
+                    long codeUnit = parameter < 0 ? parameter + 0x10000 : parameter;
+                    writer.Append(codeUnit >= 0 && codeUnit <= 0xFFFF ? static_cast<char32_t>(codeUnit) : U'\uFFFD');
+                }
+                charsToSkip = state.unicodeSkipCount;
+                continue;
+            }
+
+            FlushRtfBytes(pendingBytes, codePage, writer);
+            charsToSkip = 0;
+
+            if (word == "uc" && hasParameter)
+            {
+                state.unicodeSkipCount = static_cast<int>(std::clamp(parameter, 0L, MAX_RTF_UNICODE_SKIP));
+            }
+            else if (word == "ansicpg" && hasParameter && parameter > 0)
+            {
+                codePage = static_cast<unsigned int>(parameter);
+            }
+            else if (IsRtfIgnoredDestination(word))
+            {
+                state.isIgnored = true;
+            }
+            else if (state.isIgnored)
+            {
+                continue;
+            }
+            else if (word == "par" || word == "line" || word == "sect" || word == "page" || word == "row")
+            {
+                writer.AppendLineBreak(true);
+            }
+            else if (word == "tab" || word == "cell")
+            {
+                writer.AppendTab();
+            }
+            else if (word == "emdash")
+            {
+                writer.Append(U'\u2014');
+            }
+            else if (word == "endash")
+            {
+                writer.Append(U'\u2013');
+            }
+            else if (word == "lquote")
+            {
+                writer.Append(U'\u2018');
+            }
+            else if (word == "rquote")
+            {
+                writer.Append(U'\u2019');
+            }
+            else if (word == "ldblquote")
+            {
+                writer.Append(U'\u201C');
+            }
+            else if (word == "rdblquote")
+            {
+                writer.Append(U'\u201D');
+            }
+            else if (word == "bullet")
+            {
+                writer.Append(U'\u2022');
+            }
+        }
+
+        FlushRtfBytes(pendingBytes, codePage, writer);
+        return writer.Finish();
+    }
+
+
+    std::string_view TextExtractor::GetHtmlFragment(std::string_view cfHtml)
+    {
+        size_t start = ReadHtmlHeaderOffset(cfHtml, "StartFragment:");
+        size_t end = ReadHtmlHeaderOffset(cfHtml, "EndFragment:");
+
+        if (start != std::string_view::npos && end != std::string_view::npos && start <= end && end <= cfHtml.size())
+        {
+            return cfHtml.substr(start, end - start);
+        }
+
+        // Some applications write wrong offsets, fall back to the fragment markers
+        constexpr std::string_view startMarker = "<!--StartFragment-->";
+        size_t startMarkerPos = cfHtml.find(startMarker);
+        size_t endMarkerPos = cfHtml.find("<!--EndFragment-->");
+
+        if (startMarkerPos != std::string_view::npos && endMarkerPos != std::string_view::npos && startMarkerPos < endMarkerPos)
+        {
+            startMarkerPos += startMarker.size();
+            return cfHtml.substr(startMarkerPos, endMarkerPos - startMarkerPos);
+        }
+
+        size_t htmlStart = ReadHtmlHeaderOffset(cfHtml, "StartHTML:");
+        if (htmlStart != std::string_view::npos && htmlStart <= cfHtml.size())
+        {
+            return cfHtml.substr(htmlStart);
+        }
+
+        return cfHtml;
+    }
+
+    size_t TextExtractor::ReadHtmlHeaderOffset(std::string_view cfHtml, std::string_view key)
+    {
+        // The description header always precedes the markup
+        size_t headerEnd = cfHtml.find('<');
+        size_t keyPos = cfHtml.substr(0, headerEnd).find(key);
+        if (keyPos == std::string_view::npos)
+        {
+            return std::string_view::npos;
+        }
+
+        size_t position = keyPos + key.size();
+        size_t value = 0;
+        bool hasDigits = false;
+
+        while (position < cfHtml.size() && IsAsciiDigit(cfHtml[position]))
+        {
+            value = value * 10 + (cfHtml[position] - '0');
+            hasDigits = true;
+            position++;
+        }
+
+        return hasDigits ? value : std::string_view::npos;
+    }
+
+    bool TextExtractor::DecodeHtmlEntity(std::string_view html, size_t& position, char32_t& codePoint)
+    {
+        size_t end = html.find(';', position + 1);
+        if (end == std::string_view::npos || end - position > MAX_HTML_ENTITY_LENGTH)
+        {
+            return false;
+        }
+
+        std::string_view entity = html.substr(position + 1, end - position - 1);
+        if (entity.empty())
+        {
+            return false;
+        }
+
+        if (entity.front() == '#')
+        {
+            bool isHex = entity.size() > 1 && (entity[1] == 'x' || entity[1] == 'X');
+            size_t digitsStart = isHex ? 2 : 1;
+            char32_t value = 0;
+
+            if (digitsStart >= entity.size())
+            {
+                return false;
+            }
+
+            for (size_t i = digitsStart; i < entity.size(); i++)
+            {
+                int digit = isHex ? HexDigitValue(entity[i]) : (IsAsciiDigit(entity[i]) ? entity[i] - '0' : -1);
+                if (digit < 0)
+                {
+                    return false;
+                }
+                value = value * (isHex ? 16 : 10) + digit;
+            }
+
+            if (value == 0 || value > 0x10FFFF || (value >= 0xD800 && value <= 0xDFFF))
+            {
+                value = U'\uFFFD';
+            }
+
+            codePoint = value;
+            position = end + 1;
+            return true;
+        }
+
+        static constexpr std::array<std::pair<std::string_view, char32_t>, 20> namedEntities
+        { {
+            { "amp", U'&' }, { "lt", U'<' }, { "gt", U'>' }, { "quot", U'"' }, { "apos", U'\'' },
+            { "nbsp", U'\u00A0' }, { "copy", U'\u00A9' }, { "reg", U'\u00AE' }, { "trade", U'\u2122' }, { "hellip", U'\u2026' },
+            { "mdash", U'\u2014' }, { "ndash", U'\u2013' }, { "lsquo", U'\u2018' }, { "rsquo", U'\u2019' }, { "ldquo", U'\u201C' },
+            { "rdquo", U'\u201D' }, { "bull", U'\u2022' }, { "middot", U'\u00B7' }, { "euro", U'\u20AC' }, { "laquo", U'\u00AB' }
+        } };
+
+        auto it = std::find_if(namedEntities.begin(), namedEntities.end(), [entity](const auto& pair) { return pair.first == entity; });
+        if (it == namedEntities.end())
+        {
+            return false;
+        }
+
+        codePoint = it->second;
+        position = end + 1;
+        return true;
+    }
+
+    // Well-formed sequences only, as in table 3-7 of the Unicode standard (RFC 3629).
+    // Overlong forms, surrogates, code points past U+10FFFF and stray bytes become U+FFFD,
+    // one for each maximal ill-formed subpart.
+    char32_t TextExtractor::DecodeUtf8(std::string_view text, size_t& position)
+    {
+        auto lead = static_cast<unsigned char>(text[position]);
+        if (lead < 0x80)
+        {
+            position++;
+            return lead;
+        }
+
+        size_t length = 0;
+        char32_t codePoint = 0;
+        unsigned char secondMin = 0x80;   // Only the second byte has a narrower range, depending on the lead
+        unsigned char secondMax = 0xBF;
+
+        if (lead >= 0xC2 && lead <= 0xDF)
+        {
+            length = 2;
+            codePoint = lead & 0x1F;
+        }
+        else if (lead >= 0xE0 && lead <= 0xEF)
+        {
+            length = 3;
+            codePoint = lead & 0x0F;
+            if (lead == 0xE0)
+            {
+                secondMin = 0xA0;   // Overlong
+            }
+            else if (lead == 0xED)
+            {
+                secondMax = 0x9F;   // Surrogates
+            }
+        }
+        else if (lead >= 0xF0 && lead <= 0xF4)
+        {
+            length = 4;
+            codePoint = lead & 0x07;
+            if (lead == 0xF0)
+            {
+                secondMin = 0x90;   // Overlong
+            }
+            else if (lead == 0xF4)
+            {
+                secondMax = 0x8F;   // Past U+10FFFF
+            }
+        }
+        else
+        {
+            // Continuation bytes, overlong leads C0 C1, and F5..FF
+            position++;
+            return U'\uFFFD';
+        }
+
+        for (size_t i = 1; i < length; i++)
+        {
+            unsigned char min = i == 1 ? secondMin : 0x80;
+            unsigned char max = i == 1 ? secondMax : 0xBF;
+
+            if (position + i >= text.size() || static_cast<unsigned char>(text[position + i]) < min || static_cast<unsigned char>(text[position + i]) > max)
+            {
+                position += i;
+                return U'\uFFFD';
+            }
+
+            codePoint = (codePoint << 6) | (static_cast<unsigned char>(text[position + i]) & 0x3F);
+        }
+
+        position += length;
+        return codePoint;
+    }
+
+    void TextExtractor::FlushRtfBytes(std::vector<char>& bytes, unsigned int codePage, TextWriter& writer)
+    {
+        if (bytes.empty())
+        {
+            return;
+        }
+
+        int wideLength = MultiByteToWideChar(codePage, 0, bytes.data(), static_cast<int>(bytes.size()), nullptr, 0);
+        if (wideLength > 0)
+        {
+            std::wstring wide(static_cast<size_t>(wideLength), L'\0');
+            MultiByteToWideChar(codePage, 0, bytes.data(), static_cast<int>(bytes.size()), wide.data(), wideLength);
+
+            for (wchar_t c : wide)
+            {
+                writer.Append(static_cast<char32_t>(c));
+            }
+        }
+
+        bytes.clear();
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace winrt::Rememory::Core::implementation
+{
+    // Converts rich clipboard payloads (CF_HTML, RTF) into plain text.
+    // Both extractors walk the source buffer once and write straight into the result string.
+    class TextExtractor
+    {
+    public:
+        // Extracts the visible text between the StartFragment/EndFragment offsets of a CF_HTML buffer.
+        static std::wstring ExtractFromHtml(std::string_view cfHtml);
+
+        // Extracts the document text of an RTF buffer, skipping tables, pictures and other destinations.
+        static std::wstring ExtractFromRtf(std::string_view rtf);
+
+    private:
+        class TextWriter
+        {
+        public:
+            explicit TextWriter(size_t expectedLength);
+
+            void Append(char32_t codePoint);
+            void AppendSpace();
+            void AppendLineBreak(bool force);
+            void AppendTab();
+            std::wstring Finish();
+
+        private:
+            std::wstring m_text;
+            bool m_pendingSpace = false;
+            bool m_atLineStart = true;
+            int m_lineBreakCount = 0;
+        };
+
+        static std::string_view GetHtmlFragment(std::string_view cfHtml);
+        static size_t ReadHtmlHeaderOffset(std::string_view cfHtml, std::string_view key);
+        static bool DecodeHtmlEntity(std::string_view html, size_t& position, char32_t& codePoint);
+        static char32_t DecodeUtf8(std::string_view text, size_t& position);
+        static void FlushRtfBytes(std::vector<char>& bytes, unsigned int codePage, TextWriter& writer);
+    };
+}
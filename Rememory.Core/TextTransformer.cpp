@@ -0,0 +1,315 @@
+#include "pch.h"
+#include <climits>
+#include "TextTransformer.h"
+
+namespace {
+    const wchar_t SNAKE_CASE_SEPARATOR = L'_';
+    const wchar_t KEBAB_CASE_SEPARATOR = L'-';
+}
+
+namespace winrt::Rememory::Core::implementation
+{
+    bool TextTransformer::LoadToClipboard(UINT formatId, std::wstring_view text, TextTransform transform)
+    {
+        size_t length = Transform(text, transform, nullptr, 0);
+        if (length == 0)
+        {
+            return false;
+        }
+
+        // We need (length + 1) to include the null terminator (L'\0')
+        HGLOBAL hGlobal = GlobalAlloc(GMEM_MOVEABLE, (length + 1) * sizeof(wchar_t));
+        if (!hGlobal)
+        {
+            return false;
+        }
+
+        wchar_t* buffer = static_cast<wchar_t*>(GlobalLock(hGlobal));
+        if (!buffer)
+        {
+            GlobalFree(hGlobal);
+            return false;
+        }
+
+        size_t written = Transform(text, transform, buffer, length);
+        buffer[written] = L'\0';
+
+        GlobalUnlock(hGlobal);
+
+        if (written != length || !SetClipboardData(formatId, hGlobal))
+        {
+            GlobalFree(hGlobal);
+            return false;
+        }
+
+        return true;
+    }
+
+    size_t TextTransformer::Transform(std::wstring_view text, TextTransform transform, wchar_t* buffer, size_t capacity)
+    {
+        TextOutput output{ buffer };
+
+        switch (transform)
+        {
+        case TextTransform::UpperCase:
+            return MapCase(text, true, buffer, capacity);
+        case TextTransform::LowerCase:
+            return MapCase(text, false, buffer, capacity);
+        case TextTransform::CapitalizedCase:
+            ToCapitalizedCase(text, output);
+            break;
+        case TextTransform::SentenceCase:
+            ToSentenceCase(text, output);
+            break;
+        case TextTransform::InvertCase:
+            ToInvertCase(text, output);
+            break;
+        case TextTransform::TrimWhitespace:
+            TrimWhitespace(text, output);
+            break;
+        case TextTransform::CamelCase:
+        case TextTransform::PascalCase:
+        case TextTransform::SnakeCase:
+        case TextTransform::KebabCase:
+            JoinWords(text, transform, output);
+            break;
+        default:
+            if (buffer)
+            {
+                memcpy(buffer, text.data(), text.size() * sizeof(wchar_t));
+            }
+            return text.size();
+        }
+
+        return output.Length();
+    }
+
+    bool TextTransformer::IsAscii(std::wstring_view text)
+    {
+        // Branch-free so the compiler can vectorize the scan
+        wchar_t bits = 0;
+        for (wchar_t c : text)
+        {
+            bits |= c;
+        }
+        return bits < 0x80;
+    }
+
+    TextTransformer::CharKind TextTransformer::Classify(wchar_t c)
+    {
+        if (c < 0x80)
+        {
+            if (c >= L'A' && c <= L'Z') return CharKind::Upper;
+            if (c >= L'a' && c <= L'z') return CharKind::Lower;
+            if (c >= L'0' && c <= L'9') return CharKind::Digit;
+            if (c == L' ' || (c >= L'\t' && c <= L'\r')) return CharKind::Space;
+            return CharKind::Other;
+        }
+
+        WORD type = 0;
+        if (!GetStringTypeW(CT_CTYPE1, &c, 1, &type))
+        {
+            return CharKind::Other;
+        }
+
+        if (type & C1_UPPER) return CharKind::Upper;
+        if (type & C1_LOWER) return CharKind::Lower;
+        if (type & C1_ALPHA) return CharKind::Letter;
+        if (type & C1_DIGIT) return CharKind::Digit;
+        if (type & C1_SPACE) return CharKind::Space;
+        return CharKind::Other;
+    }
+
+    bool TextTransformer::IsWordChar(CharKind kind)
+    {
+        return kind == CharKind::Upper || kind == CharKind::Lower || kind == CharKind::Letter || kind == CharKind::Digit;
+    }
+
+    wchar_t TextTransformer::ToUpper(wchar_t c)
+    {
+        if (c < 0x80)
+        {
+            return (c >= L'a' && c <= L'z') ? static_cast<wchar_t>(c - (L'a' - L'A')) : c;
+        }
+
+        CharUpperBuffW(&c, 1);
+        return c;
+    }
+
+    wchar_t TextTransformer::ToLower(wchar_t c)
+    {
+        if (c < 0x80)
+        {
+            return (c >= L'A' && c <= L'Z') ? static_cast<wchar_t>(c + (L'a' - L'A')) : c;
+        }
+
+        CharLowerBuffW(&c, 1);
+        return c;
+    }
+
+    size_t TextTransformer::MapCase(std::wstring_view text, bool toUpper, wchar_t* buffer, size_t capacity)
+    {
+        if (IsAscii(text))
+        {
+            if (buffer && capacity >= text.size())
+            {
+                wchar_t from = toUpper ? L'a' : L'A';
+                wchar_t delta = L'a' - L'A';
+                for (size_t i = 0; i < text.size(); i++)
+                {
+                    wchar_t c = text[i];
+                    bool isMapped = static_cast<unsigned int>(c - from) < 26;
+                    buffer[i] = isMapped ? static_cast<wchar_t>(toUpper ? c - delta : c + delta) : c;
+                }
+            }
+            return text.size();
+        }
+
+        if (text.size() > INT_MAX || capacity > INT_MAX)
+        {
+            return 0;
+        }
+
+        // Linguistic casing follows the user locale, the same as the culture-aware managed conversion did
+        DWORD flags = (toUpper ? LCMAP_UPPERCASE : LCMAP_LOWERCASE) | LCMAP_LINGUISTIC_CASING;
+        int length = LCMapStringEx(LOCALE_NAME_USER_DEFAULT, flags, text.data(), static_cast<int>(text.size()),
+            buffer, static_cast<int>(capacity), nullptr, nullptr, 0);
+
+        return length > 0 ? static_cast<size_t>(length) : 0;
+    }
+
+    void TextTransformer::ToCapitalizedCase(std::wstring_view text, TextOutput& output)
+    {
+        // Upper case the first letter of every word, lower case the rest. An apostrophe does not break a word
+        bool isInWord = false;
+        for (wchar_t c : text)
+        {
+            CharKind kind = Classify(c);
+            if (kind == CharKind::Upper || kind == CharKind::Lower || kind == CharKind::Letter)
+            {
+                output.Put(isInWord ? ToLower(c) : ToUpper(c));
+                isInWord = true;
+            }
+            else
+            {
+                output.Put(c);
+                isInWord = kind == CharKind::Digit || (isInWord && c == L'\'');
+            }
+        }
+    }
+
+    void TextTransformer::ToSentenceCase(std::wstring_view text, TextOutput& output)
+    {
+        // Lower case everything, then upper case the first letter after the start of the text or a sentence end
+        bool isSentenceStart = true;
+        for (wchar_t c : text)
+        {
+            wchar_t lower = ToLower(c);
+
+            if (isSentenceStart)
+            {
+                CharKind kind = Classify(lower);
+                if (kind == CharKind::Lower)
+                {
+                    output.Put(ToUpper(lower));
+                    isSentenceStart = false;
+                    continue;
+                }
+
+                isSentenceStart = kind == CharKind::Space;
+            }
+
+            output.Put(lower);
+
+            if (c == L'.' || c == L'?' || c == L'!')
+            {
+                isSentenceStart = true;
+            }
+        }
+    }
+
+    void TextTransformer::ToInvertCase(std::wstring_view text, TextOutput& output)
+    {
+        for (wchar_t c : text)
+        {
+            switch (Classify(c))
+            {
+            case CharKind::Upper:
+                output.Put(ToLower(c));
+                break;
+            case CharKind::Lower:
+                output.Put(ToUpper(c));
+                break;
+            default:
+                output.Put(c);
+                break;
+            }
+        }
+    }
+
+    void TextTransformer::TrimWhitespace(std::wstring_view text, TextOutput& output)
+    {
+        size_t start = 0;
+        size_t end = text.size();
+
+        while (start < end && Classify(text[start]) == CharKind::Space)
+        {
+            start++;
+        }
+
+        while (end > start && Classify(text[end - 1]) == CharKind::Space)
+        {
+            end--;
+        }
+
+        for (size_t i = start; i < end; i++)
+        {
+            output.Put(text[i]);
+        }
+    }
+
+    void TextTransformer::JoinWords(std::wstring_view text, TextTransform transform, TextOutput& output)
+    {
+        // Words are runs of letters and digits, also split where a lower case letter is followed by an upper case one.
+        // For example, "someInput text" has the words "some", "Input" and "text"
+        wchar_t separator = transform == TextTransform::SnakeCase ? SNAKE_CASE_SEPARATOR
+            : transform == TextTransform::KebabCase ? KEBAB_CASE_SEPARATOR
+            : L'\0';
+
+        size_t wordCount = 0;
+        bool isWordStart = true;
+        CharKind previousKind = CharKind::Other;
+
+        for (wchar_t c : text)
+        {
+            CharKind kind = Classify(c);
+            if (!IsWordChar(kind))
+            {
+                isWordStart = true;
+                previousKind = kind;
+                continue;
+            }
+
+            if (kind == CharKind::Upper && previousKind == CharKind::Lower)
+            {
+                isWordStart = true;
+            }
+
+            bool isCapitalized = false;
+            if (isWordStart)
+            {
+                if (wordCount > 0 && separator)
+                {
+                    output.Put(separator);
+                }
+
+                wordCount++;
+                isCapitalized = transform == TextTransform::PascalCase || (transform == TextTransform::CamelCase && wordCount > 1);
+                isWordStart = false;
+            }
+
+            output.Put(isCapitalized ? ToUpper(c) : ToLower(c));
+            previousKind = kind;
+        }
+    }
+}
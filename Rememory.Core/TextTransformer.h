@@ -0,0 +1,64 @@
+#pragma once
+#include "pch.h"
+#include <string_view>
+#include "winrt/Rememory.Core.h"
+
+namespace winrt::Rememory::Core::implementation
+{
+    // Case and word-style conversions applied to text while it is pasted.
+    // Each transform streams over the source once to measure and once to write straight into the clipboard memory.
+    class TextTransformer
+    {
+    public:
+        // Publishes the transformed text under formatId. Returns false if nothing is left to paste
+        static bool LoadToClipboard(UINT formatId, std::wstring_view text, TextTransform transform);
+
+        // Writes the transformed text to buffer, or only measures it if buffer is null. Returns its length in characters
+        static size_t Transform(std::wstring_view text, TextTransform transform, wchar_t* buffer, size_t capacity);
+
+    private:
+        enum class CharKind : uint8_t
+        {
+            Other,
+            Space,
+            Upper,
+            Lower,
+            Letter,   // Letter without case
+            Digit
+        };
+
+        class TextOutput
+        {
+        public:
+            explicit TextOutput(wchar_t* buffer) : m_buffer(buffer) {}
+
+            void Put(wchar_t c)
+            {
+                if (m_buffer)
+                {
+                    m_buffer[m_length] = c;
+                }
+                ++m_length;
+            }
+
+            size_t Length() const { return m_length; }
+
+        private:
+            wchar_t* m_buffer;
+            size_t m_length = 0;
+        };
+
+        static bool IsAscii(std::wstring_view text);
+        static CharKind Classify(wchar_t c);
+        static bool IsWordChar(CharKind kind);
+        static wchar_t ToUpper(wchar_t c);
+        static wchar_t ToLower(wchar_t c);
+
+        static size_t MapCase(std::wstring_view text, bool toUpper, wchar_t* buffer, size_t capacity);
+        static void ToCapitalizedCase(std::wstring_view text, TextOutput& output);
+        static void ToSentenceCase(std::wstring_view text, TextOutput& output);
+        static void ToInvertCase(std::wstring_view text, TextOutput& output);
+        static void TrimWhitespace(std::wstring_view text, TextOutput& output);
+        static void JoinWords(std::wstring_view text, TextTransform transform, TextOutput& output);
+    };
+}
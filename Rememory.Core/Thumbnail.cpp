@@ -0,0 +1,126 @@
+#include "pch.h"
+#include <algorithm>
+#include "Thumbnail.h"
+#include "FormatManager.h"
+#include "BlobWriter.h"
+
+namespace winrt::Rememory::Core::implementation
+{
+    winrt::Windows::Foundation::IAsyncAction Thumbnail::SaveThumbnailsAsync(std::filesystem::path dataPath, const ClipboardData* bitmapData)
+    {
+        if (!bitmapData || !bitmapData->data || !bitmapData->header)
+        {
+            co_return;
+        }
+
+        auto* pBitmapHeader = static_cast<const BITMAPINFOHEADER*>(bitmapData->header);
+        if (pBitmapHeader->biWidth <= 0 || pBitmapHeader->biHeight == 0)
+        {
+            co_return;
+        }
+
+        uint32_t width = static_cast<uint32_t>(pBitmapHeader->biWidth);
+        uint32_t height = static_cast<uint32_t>(abs(pBitmapHeader->biHeight));
+        if (bitmapData->size < static_cast<size_t>(width) * height * 4)
+        {
+            co_return;
+        }
+
+        // Each size is scaled from the previous one, so only the largest pass reads the full image
+        const BYTE* source = static_cast<const BYTE*>(bitmapData->data);
+        Pixels previous;
+
+        for (uint32_t size : SIZES)
+        {
+            Pixels thumbnail = Downscale(source, width, height, size);
+            bool isSaved = false;
+
+            try
+            {
+                // Thumbnails are only previews, so they skip the write-through
+                isSaved = co_await BlobWriter::WritePngAsync(GetThumbnailPath(dataPath, size), thumbnail.data, thumbnail.width, thumbnail.height, false);
+            }
+            catch (const hresult_error&) {}
+
+            if (!isSaved)
+            {
+                co_return;
+            }
+
+            previous = std::move(thumbnail);
+            source = previous.data.data();
+            width = previous.width;
+            height = previous.height;
+        }
+    }
+
+    std::filesystem::path Thumbnail::GetThumbnailPath(const std::filesystem::path& dataPath, uint32_t size)
+    {
+        // <History>/<FormatFolder>/<name>.png -> <History>/Thumbnails/<name>_<size>.png
+        auto historyFolder = dataPath.parent_path().parent_path();
+        auto fileName = dataPath.stem().wstring() + L"_" + std::to_wstring(size) + L".png";
+        return historyFolder / FormatManager::ThumbnailsFolderName().c_str() / fileName;
+    }
+
+    Thumbnail::Pixels Thumbnail::Downscale(const BYTE* source, uint32_t sourceWidth, uint32_t sourceHeight, uint32_t maxEdge)
+    {
+        Pixels result;
+
+        if (sourceWidth <= maxEdge && sourceHeight <= maxEdge)
+        {
+            result.width = sourceWidth;
+            result.height = sourceHeight;
+            result.data.assign(source, source + static_cast<size_t>(sourceWidth) * sourceHeight * 4);
+            return result;
+        }
+
+        double scale = static_cast<double>(maxEdge) / (std::max)(sourceWidth, sourceHeight);
+        result.width = (std::max)(1u, static_cast<uint32_t>(sourceWidth * scale));
+        result.height = (std::max)(1u, static_cast<uint32_t>(sourceHeight * scale));
+        result.data.resize(static_cast<size_t>(result.width) * result.height * 4);
+
+        // Target column of every source column, so the inner loop only adds
+        std::vector<uint32_t> targetColumns(sourceWidth);
+        std::vector<uint32_t> columnCounts(result.width);
+        for (uint32_t x = 0; x < sourceWidth; x++)
+        {
+            targetColumns[x] = static_cast<uint32_t>(static_cast<uint64_t>(x) * result.width / sourceWidth);
+            columnCounts[targetColumns[x]]++;
+        }
+
+        std::vector<uint32_t> rowSums(static_cast<size_t>(result.width) * 4);
+        uint32_t sourceY = 0;
+
+        for (uint32_t targetY = 0; targetY < result.height; targetY++)
+        {
+            uint32_t endY = static_cast<uint32_t>(static_cast<uint64_t>(targetY + 1) * sourceHeight / result.height);
+            uint32_t rowCount = endY - sourceY;
+            std::fill(rowSums.begin(), rowSums.end(), 0);
+
+            for (; sourceY < endY; sourceY++)
+            {
+                const BYTE* row = source + static_cast<size_t>(sourceY) * sourceWidth * 4;
+                for (uint32_t x = 0; x < sourceWidth; x++)
+                {
+                    uint32_t* sum = &rowSums[static_cast<size_t>(targetColumns[x]) * 4];
+                    sum[0] += row[x * 4];
+                    sum[1] += row[x * 4 + 1];
+                    sum[2] += row[x * 4 + 2];
+                    sum[3] += row[x * 4 + 3];
+                }
+            }
+
+            BYTE* target = result.data.data() + static_cast<size_t>(targetY) * result.width * 4;
+            for (uint32_t x = 0; x < result.width; x++)
+            {
+                uint32_t count = (std::max)(1u, columnCounts[x] * rowCount);
+                for (int channel = 0; channel < 4; channel++)
+                {
+                    target[x * 4 + channel] = static_cast<BYTE>((rowSums[x * 4 + channel] + count / 2) / count);
+                }
+            }
+        }
+
+        return result;
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "pch.h"
+#include <filesystem>
+#include <vector>
+#include "ClipboardMonitor.h"
+
+namespace winrt::Rememory::Core::implementation
+{
+    // Pre-scaled previews of image clips, written next to the history blobs so the clips list never decodes full images
+    class Thumbnail
+    {
+    public:
+        // Edge lengths of the generated thumbnails, largest first
+        static constexpr uint32_t SIZES[] = { 256, 64 };
+
+        // Downscales the 32bpp pixels of bitmapData and saves a PNG thumbnail per size for the clip blob at dataPath
+        static winrt::Windows::Foundation::IAsyncAction SaveThumbnailsAsync(std::filesystem::path dataPath, const ClipboardData* bitmapData);
+
+        static std::filesystem::path GetThumbnailPath(const std::filesystem::path& dataPath, uint32_t size);
+
+    private:
+        struct Pixels
+        {
+            std::vector<BYTE> data;
+            uint32_t width = 0;
+            uint32_t height = 0;
+        };
+
+        // Box filter: every target pixel is the average of the source pixels it covers
+        static Pixels Downscale(const BYTE* source, uint32_t sourceWidth, uint32_t sourceHeight, uint32_t maxEdge);
+    };
+}
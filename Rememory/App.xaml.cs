@@ -17,6 +17,7 @@ using System;
 using System.Globalization;
 using System.Linq;
 using System.Threading;
+using System.Threading.Tasks;
 
 namespace Rememory
 {
@@ -42,6 +43,8 @@ namespace Rememory
 
         public Microsoft.UI.Dispatching.DispatcherQueue DispatcherQueue { get; private set; } = Microsoft.UI.Dispatching.DispatcherQueue.GetForCurrentThread();
 
+        private static readonly TimeSpan PendingClipsSaveTimeout = TimeSpan.FromSeconds(5);
+
         private readonly string[] _launchArguments;
         private readonly IKeyboardMonitor _keyboardMonitor;
         private OnboardingWindow _onboardingWindow;
@@ -114,9 +117,32 @@ namespace Rememory
         {
             ClipboardWindow.Closed -= ClipboardWindow_Closed;
             _keyboardMonitor.StopMonitor();
+            ExitAfterPendingClips();
+        }
+
+        /// <summary>
+        /// Exits once a copy that was still waiting for the clipboard to settle is saved
+        /// </summary>
+        public async void ExitAfterPendingClips()
+        {
+            var clipboardMonitor = Services.GetService<ClipboardMonitor>()!;
+            clipboardMonitor.StopMonitoring();
+
+            // A save that hangs doesn't keep the app from exiting
+            await Task.WhenAny(clipboardMonitor.FlushAsync().AsTask(), Task.Delay(PendingClipsSaveTimeout));
             Exit();
         }
 
+        /// <summary>
+        /// Saves a copy that was still waiting for the clipboard to settle before returning, for when the process can end right after
+        /// </summary>
+        public void SavePendingClips()
+        {
+            var clipboardMonitor = Services.GetService<ClipboardMonitor>()!;
+            clipboardMonitor.StopMonitoring();
+            clipboardMonitor.Flush((uint)PendingClipsSaveTimeout.TotalMilliseconds);
+        }
+
         private static void MigrateStartupTask()
         {
             var createElevatedStartupTask = LegacyTaskSchedulerManager.IsHighestRunLevelEnabled() && AdministratorHelper.IsAppRunningAsAdministrator();
@@ -153,6 +179,7 @@ namespace Rememory
             // Monitors
             services.AddSingleton<ClipboardMonitor>();
             services.AddSingleton<IKeyboardMonitor, KeyboardMonitor>();
+            services.AddSingleton<QueryServer>();
 
             // Services
             services.AddSingleton<IStorageService>(sp =>
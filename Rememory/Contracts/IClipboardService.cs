@@ -41,6 +41,18 @@ namespace Rememory.Contracts
         /// </summary>
         IList<ClipModel> Clips { get; }
 
+        /// <summary>
+        /// Gets the total size in bytes of the files stored in the History folder for the tracked clips.
+        /// </summary>
+        long HistorySize { get; }
+
+        /// <summary>
+        /// Gets the size in bytes of the History files stored for the specified format.
+        /// </summary>
+        /// <param name="format">The clipboard format to get the size for.</param>
+        /// <returns>The number of bytes used by files of the <paramref name="format"/>.</returns>
+        long GetHistorySize(ClipboardFormat format);
+
         /// <summary>
         /// Sets the data into the system clipboard.
         /// </summary>
@@ -106,6 +118,13 @@ namespace Rememory.Contracts
         /// <param name="deleteFavoriteClips">If <c>true</c>, old favorite clips will also be deleted; otherwise, they will be preserved.</param>
         void DeleteOldClipsByQuantity(int quantity, bool deleteFavoriteClips);
 
+        /// <summary>
+        /// Deletes the oldest clips with files from the collection and persistent storage until the History files fit into <paramref name="maxSize"/>.
+        /// </summary>
+        /// <param name="maxSize">Maximum size in bytes of the History files to leave.</param>
+        /// <param name="deleteFavoriteClips">If <c>true</c>, old favorite clips will also be deleted; otherwise, they will be preserved.</param>
+        void DeleteOldClipsBySize(long maxSize, bool deleteFavoriteClips);
+
         /// <summary>
         /// Deletes all filtered clips from the collection and persistent storage.
         /// </summary>
@@ -66,18 +66,10 @@ namespace Rememory.Contracts
         void DeleteClip(int id);
 
         /// <summary>
-        /// Deletes clip records older than a specified cutoff time.
+        /// Deletes a batch of clip records from the storage within a single transaction.
         /// </summary>
-        /// <param name="cutoffTime">The timestamp threshold; clips recorded before this time will be deleted.</param>
-        /// <param name="deleteFavoriteClips">If true, favorite clips older than the cutoff time will also be deleted; otherwise, they will be kept.</param>
-        void DeleteOldClipsByTime(DateTime cutoffTime, bool deleteFavoriteClips);
-
-        /// <summary>
-        /// Deletes old clips if there are more than <paramref name="quantity"/>.
-        /// </summary>
-        /// <param name="quantity">Number of clips to leave.</param>
-        /// <param name="deleteFavoriteClips">If true, old favorite clips will also be deleted; otherwise, they will be kept.</param>
-        void DeleteOldClipsByQuantity(int quantity, bool deleteFavoriteClips);
+        /// <param name="ids">The unique identifiers of the clips to delete.</param>
+        void DeleteClips(IEnumerable<int> ids);
 
         /// <summary>
         /// Retrieves all tags from the database.
@@ -132,7 +124,7 @@ namespace Rememory.Contracts
         void AddColorMetadata(ColorMetadataModel colorMetadataModel, int dataId);
 
         /// <summary>
-        /// Adds files-specific metadata (FilesCount, FoldersCount) associated with a specific data item within a clip.
+        /// Adds or replaces files-specific metadata (FilesCount, FoldersCount, TotalSize) associated with a specific data item within a clip.
         /// </summary>
         /// <param name="filesMetadata">The <see cref="FilesMetadataModel"/> containing the metadata to add.</param>
         /// <param name="dataId">The unique identifier of the <see cref="DataModel"/> item to which this metadata belongs.</param>
@@ -20,6 +20,11 @@ namespace Rememory.Contracts
         /// </summary>
         event EventHandler<int> TagUnregistered;
 
+        /// <summary>
+        /// Occurs when a change to tags can protect clips from cleanup or let it delete them.
+        /// </summary>
+        event EventHandler CleanupProtectionChanged;
+
         /// <summary>
         /// List of all tags currently stored in memory.
         /// </summary>
@@ -5,6 +5,7 @@ using Rememory.Models;
 using Rememory.Models.Metadata;
 using System;
 using System.Collections.Generic;
+using System.Text;
 using System.Threading.Tasks;
 using Windows.Storage;
 
@@ -56,10 +57,22 @@ namespace Rememory.Converters
                         footerParts.Add("/Clipboard/ClipFooter_FoldersCount/Text".GetLocalizedFormatResource(filesMetadata.FoldersCount));
                     }
 
+                    if (filesMetadata.TotalSize is long totalSize)
+                    {
+                        footerParts.Add(FormatByteSize(totalSize));
+                    }
+
                     return string.Join(_filesAndFoldersCountDivider, footerParts);
                 }
             }
             return string.Empty;
         }
+
+        private static string FormatByteSize(long size)
+        {
+            // Localized by the shell, e.g. "1.25 GB", rounded to the nearest displayed digit
+            var buffer = new StringBuilder(32);
+            return NativeHelper.StrFormatByteSizeEx((ulong)size, 1, buffer, (uint)buffer.Capacity) == 0 ? buffer.ToString() : string.Empty;
+        }
     }
 }
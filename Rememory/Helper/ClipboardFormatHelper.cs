@@ -1,10 +1,13 @@
 ﻿using Rememory.Core;
 using Rememory.Models;
 using System;
-using System.Collections;
 using System.Collections.Generic;
 using System.IO;
 using System.Linq;
+using System.Runtime.InteropServices.WindowsRuntime;
+using System.Threading.Tasks;
+using Windows.Storage;
+using Windows.Storage.Streams;
 
 namespace Rememory.Helper
 {
@@ -34,46 +37,10 @@ namespace Rememory.Helper
         };
 
         /// <summary>
-        /// Compares two <see cref="ClipModel"/> objects for data equality.
-        /// Equality is defined as having the same Text data hash OR the same PNG data hash.
+        /// Edge lengths of the thumbnails generated for image clips at capture time.
+        /// Must match the sizes produced by Rememory.Core.
         /// </summary>
-        /// <param name="firstModel">The first ClipModel to compare.</param>
-        /// <param name="secondModel">The second ClipModel to compare.</param>
-        /// <returns><c>true</c> if the data content (Text or PNG hash) is considered equal; otherwise, <c>false</c>.</returns>
-        public static bool EqualDataTo(this ClipModel firstModel, ClipModel secondModel)
-        {
-            // Check if both have Text data and their hashes match
-            bool textMatch = firstModel.Data.TryGetValue(ClipboardFormat.Text, out var firstTextData)
-                          && secondModel.Data.TryGetValue(ClipboardFormat.Text, out var secondTextData)
-                          && StructuralComparisons.StructuralEqualityComparer.Equals(firstTextData?.Hash, secondTextData?.Hash);
-
-            // If text matches, they are equal
-            if (textMatch) return true;
-
-            // Check if both have Bitmap data and their hashes match
-            bool bitmapMatch = firstModel.Data.TryGetValue(ClipboardFormat.Bitmap, out var firstBitmapData)
-                          && secondModel.Data.TryGetValue(ClipboardFormat.Bitmap, out var secondBitmapData)
-                          && StructuralComparisons.StructuralEqualityComparer.Equals(firstBitmapData?.Hash, secondBitmapData?.Hash);
-
-            // If bitmap matches, they are equal
-            if (bitmapMatch) return true;
-
-            // Check if both have Png data and their hashes match
-            bool pngMatch = firstModel.Data.TryGetValue(ClipboardFormat.Png, out var firstPngData)
-                         && secondModel.Data.TryGetValue(ClipboardFormat.Png, out var secondPngData)
-                         && StructuralComparisons.StructuralEqualityComparer.Equals(firstPngData?.Hash, secondPngData?.Hash);
-
-            // Return true if PNG matches
-            if (pngMatch) return true;
-
-            // Check if both have Files data and their hashes match
-            bool filesMatch = firstModel.Data.TryGetValue(ClipboardFormat.Files, out var firstFilesData)
-                         && secondModel.Data.TryGetValue(ClipboardFormat.Files, out var secondFilesData)
-                         && StructuralComparisons.StructuralEqualityComparer.Equals(firstFilesData?.Hash, secondFilesData?.Hash);
-
-            // Return true if Files matches
-            return filesMatch;
-        }
+        public static readonly uint[] ThumbnailSizes = [256, 64];
 
         /// <summary>
         /// Deletes external files associated with non-text data formats stored within a <see cref="ClipModel"/>.
@@ -94,12 +61,80 @@ namespace Rememory.Helper
                     {
                         fileInfo.Delete();
                     }
+                    if (IsImage(dataModel))
+                    {
+                        DeleteThumbnails(dataModel);
+                    }
                     clipModel.Data.Remove(dataModel.Format);
                 }
                 catch { }
             }
         }
 
+        // Clips saved before thumbnails existed have none, and neither may the Thumbnails folder
+        private static void DeleteThumbnails(DataModel dataModel)
+        {
+            foreach (var size in ThumbnailSizes)
+            {
+                try
+                {
+                    var thumbnailPath = FormatManager.GetThumbnailPath(dataModel.Data, size);
+                    if (File.Exists(thumbnailPath))
+                    {
+                        File.Delete(thumbnailPath);
+                    }
+                }
+                catch { }
+            }
+        }
+
+        /// <summary>
+        /// Returns the smallest pre-scaled thumbnail of an image clip that is at least <paramref name="minSize"/> pixels on its long edge.
+        /// </summary>
+        /// <returns>The thumbnail path, or <c>null</c> if the clip is not an image or has no thumbnail (e.g. clips captured before thumbnails existed).</returns>
+        public static string? GetThumbnailPath(this DataModel data, uint minSize)
+        {
+            if (!IsImage(data))
+            {
+                return null;
+            }
+
+            foreach (var size in ThumbnailSizes.Where(size => size >= minSize).OrderBy(size => size))
+            {
+                var thumbnailPath = FormatManager.GetThumbnailPath(data.Data, size);
+                if (File.Exists(thumbnailPath))
+                {
+                    return thumbnailPath;
+                }
+            }
+
+            return null;
+        }
+
+        private static bool IsImage(DataModel data) => data.Format is ClipboardFormat.Png or ClipboardFormat.Bitmap;
+
+        /// <summary>
+        /// Returns what the text data as a whole looks like, classifying it natively if it wasn't done at capture.
+        /// </summary>
+        public static TextContent GetTextContent(this DataModel data)
+        {
+            return data.Content ??= FormatManager.ClassifyText(data.Data);
+        }
+
+        /// <summary>
+        /// Specifies whether text data is an absolute http or https link.
+        /// </summary>
+        /// <param name="data">The data we want to check.</param>
+        /// <returns><c>True</c> if data is a web link, otherwise <c>False</c>.</returns>
+        public static bool IsWebLink(this DataModel data)
+        {
+            // The native classifier rules out most texts, so only link candidates are parsed
+            return data.Format == ClipboardFormat.Text
+                && data.GetTextContent().HasFlag(TextContent.Link)
+                && Uri.TryCreate(data.Data, UriKind.Absolute, out var uri)
+                && (uri.Scheme == Uri.UriSchemeHttp || uri.Scheme == Uri.UriSchemeHttps);
+        }
+
         /// <summary>
         /// Specifies whether data is stored in a file format.
         /// </summary>
@@ -110,6 +145,99 @@ namespace Rememory.Helper
             return CanFormatBeFile(data.Format);
         }
 
+        /// <summary>
+        /// Reads the size of the data file into <see cref="DataModel.Size"/> if it's not known yet.
+        /// </summary>
+        /// <param name="data">The data model to update</param>
+        public static void UpdateFileSize(this DataModel data)
+        {
+            if (data.Size != 0 || !data.IsFile())
+            {
+                return;
+            }
+
+            try
+            {
+                var fileInfo = new FileInfo(data.Data);
+                if (fileInfo.Exists)
+                {
+                    data.Size = fileInfo.Length;
+                }
+            }
+            catch { }
+        }
+
+        /// <summary>
+        /// Reads a whole history file as text, decrypting it if it was saved encrypted.
+        /// </summary>
+        /// <param name="path">Path to the history file</param>
+        /// <returns>The file text, or an empty string if the file can't be read.</returns>
+        public static string ReadHistoryText(string path)
+        {
+            var buffer = FormatManager.ReadHistoryFile(path);
+            if (buffer is null)
+            {
+                return string.Empty;
+            }
+
+            using var reader = new StreamReader(buffer.AsStream());
+            return reader.ReadToEnd();
+        }
+
+        /// <summary>
+        /// Opens a history file for reading. Encrypted files are decrypted into memory, plain files are read from disk.
+        /// </summary>
+        /// <param name="path">Path to the history file</param>
+        /// <exception cref="IOException">Thrown if an encrypted file can't be decrypted.</exception>
+        public static async Task<IRandomAccessStream> OpenHistoryFileAsync(string path)
+        {
+            if (!FormatManager.IsHistoryFileSealed(path))
+            {
+                var file = await StorageFile.GetFileFromPathAsync(path);
+                return await file.OpenReadAsync();
+            }
+
+            var buffer = await Task.Run(() => FormatManager.ReadHistoryFile(path))
+                ?? throw new IOException($"Unable to decrypt {path}");
+
+            var stream = new InMemoryRandomAccessStream();
+            await stream.WriteAsync(buffer);
+            stream.Seek(0);
+            return stream;
+        }
+
+        /// <summary>
+        /// Returns a history file that can be handed to other apps. Encrypted files are decrypted only when the file is read.
+        /// </summary>
+        /// <param name="path">Path to the history file</param>
+        public static async Task<StorageFile> GetHistoryStorageFileAsync(string path)
+        {
+            if (!FormatManager.IsHistoryFileSealed(path))
+            {
+                return await StorageFile.GetFileFromPathAsync(path);
+            }
+
+            return await StorageFile.CreateStreamedFileAsync(Path.GetFileName(path), async request =>
+            {
+                try
+                {
+                    var buffer = await Task.Run(() => FormatManager.ReadHistoryFile(path));
+                    if (buffer is null)
+                    {
+                        request.FailAndClose(StreamedFileFailureMode.Failed);
+                        return;
+                    }
+
+                    await request.WriteAsync(buffer);
+                    request.Dispose();
+                }
+                catch
+                {
+                    request.FailAndClose(StreamedFileFailureMode.Incomplete);
+                }
+            }, null);
+        }
+
         /// <summary>
         /// Specifies whether format can be stored as a file.
         /// </summary>
@@ -1,4 +1,5 @@
 ﻿using Microsoft.UI;
+using Rememory.Core;
 using System;
 using System.Globalization;
 using System.Text.RegularExpressions;
@@ -26,6 +27,16 @@ namespace Rememory.Helper
             return isHexMatch || isRgbMatch || isHslMatch;
         }
 
+        /// <summary>
+        /// Checks the content kind recognized by <see cref="FormatManager.ClassifyText"/> for a color
+        /// </summary>
+        /// <returns>True if the text is a color, otherwise False</returns>
+        public static bool IsColor(this TextContent content, bool isHexColorPrefixRequired)
+        {
+            return content.HasFlag(TextContent.Color)
+                || (!isHexColorPrefixRequired && content.HasFlag(TextContent.UnprefixedColor));
+        }
+
         /// <summary>
         /// Converts HEX, RGB, RGBA, HSL, HSLA color formats to <see cref="Windows.UI.Color"/>
         /// </summary>
@@ -0,0 +1,130 @@
+﻿using Rememory.Core;
+using Rememory.Services;
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Runtime.InteropServices;
+using System.Text;
+
+namespace Rememory.Helper
+{
+    /// <summary>
+    /// Handles "rememory get", "list" and "search" by querying the running app, without starting a second one
+    /// </summary>
+    public static class CommandLineClient
+    {
+        private const int DefaultListCount = 20;
+        private const int DefaultSearchCount = 50;
+
+        private const int ERROR_FILE_NOT_FOUND = unchecked((int)0x80070002);
+        private const int ERROR_NOT_READY = unchecked((int)0x80070015);
+
+        public static bool IsCommand(string[] args) => args.Length > 0 && args[0] is "get" or "list" or "search";
+
+        public static int Run(string[] args)
+        {
+            // The app is a windowed one, so it writes to the terminal it was started from
+            NativeHelper.AttachConsole(NativeHelper.ATTACH_PARENT_PROCESS);
+            Console.OutputEncoding = Encoding.UTF8;
+
+            try
+            {
+                switch (args[0])
+                {
+                    case "get":
+                        {
+                            uint index = 1;
+                            if (args.Length > 1 && (!uint.TryParse(args[1], out index) || index == 0))
+                            {
+                                return Usage();
+                            }
+
+                            var item = QueryClient.Get(index).FirstOrDefault();
+                            if (item.Text is null)
+                            {
+                                Console.Error.WriteLine($"There is no clip at position {index}");
+                                return 1;
+                            }
+
+                            Console.Out.Write(item.Text);
+                            return 0;
+                        }
+                    case "list":
+                        {
+                            uint count = DefaultListCount;
+                            if (args.Length > 1 && !uint.TryParse(args[1], out count))
+                            {
+                                return Usage();
+                            }
+
+                            PrintItems(QueryClient.List(count));
+                            return 0;
+                        }
+                    case "search":
+                        {
+                            if (args.Length < 2)
+                            {
+                                return Usage();
+                            }
+
+                            string searchString = string.Join(' ', args.Skip(1));
+                            var items = SearchService.TryParseRegex(searchString, out var pattern, out var ignoreCase)
+                                ? QueryClient.SearchRegex(pattern, ignoreCase, DefaultSearchCount)
+                                : QueryClient.Search(searchString, DefaultSearchCount);
+
+                            PrintItems(items);
+                            return items.Count > 0 ? 0 : 1;
+                        }
+                    default:
+                        return Usage();
+                }
+            }
+            // Too long queries, invalid patterns and rejected requests, each with its own message
+            catch (ArgumentException ex)
+            {
+                Console.Error.WriteLine(ex.Message.Trim());
+                return 2;
+            }
+            catch (Exception ex) when (ex is System.IO.FileNotFoundException || ex.HResult == ERROR_FILE_NOT_FOUND)
+            {
+                Console.Error.WriteLine("Rememory isn't running, or command-line access is off or the history is encrypted in Settings > Storage");
+                return 1;
+            }
+            catch (COMException ex) when (ex.HResult == ERROR_NOT_READY)
+            {
+                Console.Error.WriteLine("Rememory hasn't loaded the history yet");
+                return 1;
+            }
+            catch (Exception ex)
+            {
+                Console.Error.WriteLine($"Unable to query Rememory: {ex.Message}");
+                return 1;
+            }
+        }
+
+        // One clip per line as its position and first line, so the output can be piped to other tools
+        private static void PrintItems(IReadOnlyList<QueryItem> items)
+        {
+            foreach (var item in items)
+            {
+                var text = item.Text.AsSpan();
+                int lineEnd = text.IndexOfAny('\r', '\n');
+                if (lineEnd >= 0)
+                {
+                    text = text[..lineEnd];
+                }
+
+                Console.Out.WriteLine($"{item.Index}\t{text}");
+            }
+        }
+
+        private static int Usage()
+        {
+            Console.Error.WriteLine("Usage:");
+            Console.Error.WriteLine("  rememory get [position]      Full text of a clip, 1 being the most recent");
+            Console.Error.WriteLine($"  rememory list [count]        Most recent clips, {DefaultListCount} by default");
+            Console.Error.WriteLine("  rememory search <query>      Clips matching a fuzzy query, or /pattern/ and /pattern/i for a regular expression");
+            return 2;
+        }
+    }
+}
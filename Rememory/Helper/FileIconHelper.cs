@@ -1,5 +1,6 @@
 ﻿using Microsoft.UI.Xaml.Media.Imaging;
 using System;
+using System.Collections.Generic;
 using System.Runtime.InteropServices;
 using System.Runtime.InteropServices.WindowsRuntime;
 using System.Threading.Tasks;
@@ -9,17 +10,38 @@ namespace Rememory.Helper
 {
     public static partial class FileIconHelper
     {
-        public static async Task<SoftwareBitmapSource?> GetFileIconAsync(string path, int size = 16)
+        // Rendered icons by system image list index and size. Files of the same type share an index,
+        // so every row showing it reuses one bitmap. Only used from the UI thread.
+        private static readonly Dictionary<(int IconIndex, int Size), Task<SoftwareBitmapSource?>> _iconCache = [];
+        private const int IconCacheLimit = 1024;
+
+        public static Task<SoftwareBitmapSource?> GetFileIconAsync(string path, int size = 16)
         {
             if (string.IsNullOrWhiteSpace(path))
             {
                 throw new ArgumentException("Path must not be null or empty.", nameof(path));
             }
 
+            var key = (GetIconIndex(path), size);
+            if (!_iconCache.TryGetValue(key, out var iconTask))
+            {
+                if (_iconCache.Count >= IconCacheLimit)
+                {
+                    _iconCache.Clear();
+                }
+
+                iconTask = CreateIconAsync(key.Item1, size);
+                _iconCache[key] = iconTask;
+            }
+
+            return iconTask;
+        }
+
+        private static async Task<SoftwareBitmapSource?> CreateIconAsync(int iconIndex, int size)
+        {
             IntPtr hIcon = IntPtr.Zero;
             try
             {
-                var iconIndex = GetIconIndex(path);
                 hIcon = GetSmallIcon(iconIndex);
                 if (hIcon == IntPtr.Zero)
                 {
@@ -39,6 +61,10 @@ namespace Rememory.Helper
 
                 return softwareBitmapSource;
             }
+            catch (InvalidOperationException)
+            {
+                return null;
+            }
             finally
             {
                 if (hIcon != IntPtr.Zero)
@@ -63,9 +89,6 @@ namespace Rememory.Helper
             IntPtr hIcon = IntPtr.Zero;
             spiml.GetIcon(iImage, ILD_TRANSPARENT | ILD_IMAGE, ref hIcon);
 
-            var info = new IMAGEINFO();
-            spiml.GetImageInfo(iImage, ref info);
-
             return hIcon;
         }
 
@@ -20,6 +20,11 @@ namespace Rememory.Helper
         [DllImport("kernel32.dll")]
         internal static extern bool AllocConsole();
 
+        internal const uint ATTACH_PARENT_PROCESS = 0xFFFFFFFF;
+
+        [DllImport("kernel32.dll", SetLastError = true)]
+        internal static extern bool AttachConsole(uint dwProcessId);
+
         [DllImport("user32.dll", CharSet = CharSet.Unicode, SetLastError = true)]
         internal static extern int MessageBox(IntPtr hWnd, string text, string caption, uint type);
 
@@ -35,6 +40,9 @@ namespace Rememory.Helper
         [DllImport("user32.dll", CharSet = CharSet.Auto)]
         internal static extern int RegisterWindowMessage(string msg);
 
+        [DllImport("shlwapi.dll", CharSet = CharSet.Unicode)]
+        internal static extern int StrFormatByteSizeEx(ulong ull, int flags, StringBuilder pszBuf, uint cchBuf);
+
 
         [DllImport("kernel32.dll", CharSet = CharSet.Unicode)]
         internal static extern IntPtr LoadLibrary(string lpFileName);
@@ -0,0 +1,349 @@
+﻿using System;
+using System.Buffers;
+using System.Buffers.Binary;
+using System.Collections.Generic;
+using System.IO;
+using System.IO.Compression;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace Rememory.Helper
+{
+    /// <summary>
+    /// Writes a zip archive whose entries are compressed in parallel.
+    /// ZipArchive deflates every entry on the writing thread, so here each entry is deflated into a temporary file on a worker
+    /// and the writer only copies finished data, keeping the entries in their original order.
+    /// Stored entries skip the temporary file, a worker only computes their checksum and the writer copies the source
+    /// </summary>
+    public static class ParallelZipWriter
+    {
+        public record EntrySource(string EntryName, Func<Stream> OpenRead, CompressionLevel CompressionLevel, DateTime LastWriteTime);
+
+        private record PreparedEntry(EntrySource Source, FileStream? Data, uint Crc32, long Length);
+
+        private record WrittenEntry(byte[] Name, ushort Method, uint DosDateTime, uint Crc32, long Length, long CompressedLength, long Offset);
+
+        private const int BufferSize = 81920;
+        private const ushort StoredMethod = 0;
+        private const ushort DeflateMethod = 8;
+        private const ushort Utf8NameFlag = 0x0800;
+        private const ushort DefaultVersion = 20;
+        private const ushort Zip64Version = 45;
+
+        // Slicing-by-8 tables, Crc32Tables[0] is the classic byte table
+        private static readonly uint[][] Crc32Tables = CreateCrc32Tables();
+
+        public static async Task WriteAsync(string destinationFilePath, IEnumerable<EntrySource> sources, string tempFolderPath)
+        {
+            // At most this many entries are compressed or waiting to be written at once, which bounds the temporary disk usage
+            int maxPendingCount = Math.Max(2, Environment.ProcessorCount);
+            var pendingEntries = new Queue<Task<PreparedEntry>>();
+            var writtenEntries = new List<WrittenEntry>();
+
+            await using var output = new FileStream(destinationFilePath, FileMode.Create, FileAccess.Write, FileShare.None, BufferSize, useAsync: true);
+
+            try
+            {
+                foreach (var source in sources)
+                {
+                    if (pendingEntries.Count == maxPendingCount)
+                    {
+                        writtenEntries.Add(await WriteEntryAsync(output, await pendingEntries.Dequeue()));
+                    }
+                    pendingEntries.Enqueue(Task.Run(() => PrepareEntryAsync(source, tempFolderPath)));
+                }
+
+                while (pendingEntries.Count > 0)
+                {
+                    writtenEntries.Add(await WriteEntryAsync(output, await pendingEntries.Dequeue()));
+                }
+
+                await WriteCentralDirectoryAsync(output, writtenEntries);
+            }
+            finally
+            {
+                // Releases the temporary files of entries that were not written after a failure
+                while (pendingEntries.Count > 0)
+                {
+                    try
+                    {
+                        if ((await pendingEntries.Dequeue()).Data is FileStream data)
+                        {
+                            await data.DisposeAsync();
+                        }
+                    }
+                    catch { }
+                }
+            }
+        }
+
+        private static async Task<PreparedEntry> PrepareEntryAsync(EntrySource source, string tempFolderPath)
+        {
+            if (IsStored(source))
+            {
+                return await PrepareStoredEntryAsync(source);
+            }
+
+            // The temporary file is removed as soon as the entry is written or dropped
+            var data = new FileStream(Path.Combine(tempFolderPath, Path.GetRandomFileName()), FileMode.CreateNew, FileAccess.ReadWrite, FileShare.None,
+                BufferSize, FileOptions.Asynchronous | FileOptions.DeleteOnClose);
+            var buffer = ArrayPool<byte>.Shared.Rent(BufferSize);
+
+            try
+            {
+                uint crc = uint.MaxValue;
+                long length = 0;
+
+                await using (var sourceStream = source.OpenRead())
+                await using (var deflateStream = new DeflateStream(data, source.CompressionLevel, leaveOpen: true))
+                {
+                    int read;
+                    while ((read = await sourceStream.ReadAsync(buffer.AsMemory(0, BufferSize))) > 0)
+                    {
+                        crc = UpdateCrc32(crc, buffer.AsSpan(0, read));
+                        length += read;
+                        await deflateStream.WriteAsync(buffer.AsMemory(0, read));
+                    }
+                }
+
+                return new(source, data, ~crc, length);
+            }
+            catch
+            {
+                await data.DisposeAsync();
+                throw;
+            }
+            finally
+            {
+                ArrayPool<byte>.Shared.Return(buffer);
+            }
+        }
+
+        private static async Task<PreparedEntry> PrepareStoredEntryAsync(EntrySource source)
+        {
+            var buffer = ArrayPool<byte>.Shared.Rent(BufferSize);
+
+            try
+            {
+                uint crc = uint.MaxValue;
+                long length = 0;
+
+                await using var sourceStream = source.OpenRead();
+                int read;
+                while ((read = await sourceStream.ReadAsync(buffer.AsMemory(0, BufferSize))) > 0)
+                {
+                    crc = UpdateCrc32(crc, buffer.AsSpan(0, read));
+                    length += read;
+                }
+
+                return new(source, null, ~crc, length);
+            }
+            finally
+            {
+                ArrayPool<byte>.Shared.Return(buffer);
+            }
+        }
+
+        private static async Task<WrittenEntry> WriteEntryAsync(FileStream output, PreparedEntry prepared)
+        {
+            // A stored entry is copied from its source, which is expected to be unchanged since its checksum was computed
+            await using var data = prepared.Data ?? prepared.Source.OpenRead();
+
+            var entry = new WrittenEntry(
+                Encoding.UTF8.GetBytes(prepared.Source.EntryName),
+                IsStored(prepared.Source) ? StoredMethod : DeflateMethod,
+                ToDosDateTime(prepared.Source.LastWriteTime),
+                prepared.Crc32,
+                prepared.Length,
+                prepared.Data?.Length ?? prepared.Length,
+                output.Position);
+            bool isZip64 = IsZip64Size(entry);
+
+            using var header = new MemoryStream();
+            using (var writer = new BinaryWriter(header, Encoding.UTF8, leaveOpen: true))
+            {
+                writer.Write(0x04034b50u);
+                writer.Write(isZip64 ? Zip64Version : DefaultVersion);
+                writer.Write(Utf8NameFlag);
+                writer.Write(entry.Method);
+                writer.Write(entry.DosDateTime);
+                writer.Write(entry.Crc32);
+                writer.Write(isZip64 ? uint.MaxValue : (uint)entry.CompressedLength);
+                writer.Write(isZip64 ? uint.MaxValue : (uint)entry.Length);
+                writer.Write((ushort)entry.Name.Length);
+                writer.Write((ushort)(isZip64 ? 20 : 0));
+                writer.Write(entry.Name);
+
+                if (isZip64)
+                {
+                    writer.Write((ushort)0x0001);
+                    writer.Write((ushort)16);
+                    writer.Write(entry.Length);
+                    writer.Write(entry.CompressedLength);
+                }
+            }
+
+            await output.WriteAsync(header.GetBuffer().AsMemory(0, (int)header.Length));
+            if (prepared.Data is not null)
+            {
+                data.Seek(0, SeekOrigin.Begin);
+            }
+            await data.CopyToAsync(output, BufferSize);
+
+            return entry;
+        }
+
+        private static async Task WriteCentralDirectoryAsync(FileStream output, List<WrittenEntry> entries)
+        {
+            long directoryOffset = output.Position;
+
+            using var directory = new MemoryStream();
+            using (var writer = new BinaryWriter(directory, Encoding.UTF8, leaveOpen: true))
+            {
+                foreach (var entry in entries)
+                {
+                    bool isZip64Size = IsZip64Size(entry);
+                    bool isZip64Offset = entry.Offset >= uint.MaxValue;
+                    int extraLength = (isZip64Size ? 16 : 0) + (isZip64Offset ? 8 : 0);
+                    ushort version = isZip64Size || isZip64Offset ? Zip64Version : DefaultVersion;
+
+                    writer.Write(0x02014b50u);
+                    writer.Write(version);
+                    writer.Write(version);
+                    writer.Write(Utf8NameFlag);
+                    writer.Write(entry.Method);
+                    writer.Write(entry.DosDateTime);
+                    writer.Write(entry.Crc32);
+                    writer.Write(isZip64Size ? uint.MaxValue : (uint)entry.CompressedLength);
+                    writer.Write(isZip64Size ? uint.MaxValue : (uint)entry.Length);
+                    writer.Write((ushort)entry.Name.Length);
+                    writer.Write((ushort)(extraLength > 0 ? extraLength + 4 : 0));
+                    writer.Write((ushort)0);   // Comment length
+                    writer.Write((ushort)0);   // Disk number
+                    writer.Write((ushort)0);   // Internal attributes
+                    writer.Write(0u);          // External attributes
+                    writer.Write(isZip64Offset ? uint.MaxValue : (uint)entry.Offset);
+                    writer.Write(entry.Name);
+
+                    if (extraLength > 0)
+                    {
+                        writer.Write((ushort)0x0001);
+                        writer.Write((ushort)extraLength);
+                        if (isZip64Size)
+                        {
+                            writer.Write(entry.Length);
+                            writer.Write(entry.CompressedLength);
+                        }
+                        if (isZip64Offset)
+                        {
+                            writer.Write(entry.Offset);
+                        }
+                    }
+                }
+
+                long directoryLength = directory.Length;
+                long zip64RecordOffset = directoryOffset + directoryLength;
+                bool isZip64 = entries.Count >= ushort.MaxValue || directoryOffset >= uint.MaxValue || directoryLength >= uint.MaxValue;
+
+                if (isZip64)
+                {
+                    writer.Write(0x06064b50u);
+                    writer.Write(44ul);   // Size of the remaining record
+                    writer.Write(Zip64Version);
+                    writer.Write(Zip64Version);
+                    writer.Write(0u);
+                    writer.Write(0u);
+                    writer.Write((ulong)entries.Count);
+                    writer.Write((ulong)entries.Count);
+                    writer.Write(directoryLength);
+                    writer.Write(directoryOffset);
+
+                    writer.Write(0x07064b50u);
+                    writer.Write(0u);
+                    writer.Write(zip64RecordOffset);
+                    writer.Write(1u);
+                }
+
+                writer.Write(0x06054b50u);
+                writer.Write((ushort)0);
+                writer.Write((ushort)0);
+                writer.Write((ushort)Math.Min(entries.Count, ushort.MaxValue));
+                writer.Write((ushort)Math.Min(entries.Count, ushort.MaxValue));
+                writer.Write(isZip64 ? uint.MaxValue : (uint)directoryLength);
+                writer.Write(isZip64 ? uint.MaxValue : (uint)directoryOffset);
+                writer.Write((ushort)0);   // Comment length
+            }
+
+            await output.WriteAsync(directory.GetBuffer().AsMemory(0, (int)directory.Length));
+        }
+
+        private static bool IsStored(EntrySource source) => source.CompressionLevel == CompressionLevel.NoCompression;
+
+        private static bool IsZip64Size(WrittenEntry entry) => entry.Length >= uint.MaxValue || entry.CompressedLength >= uint.MaxValue;
+
+        private static uint ToDosDateTime(DateTime time)
+        {
+            if (time.Year < 1980)
+            {
+                time = new DateTime(1980, 1, 1);
+            }
+            else if (time.Year > 2107)
+            {
+                time = new DateTime(2107, 12, 31, 23, 59, 58);
+            }
+
+            return (uint)(time.Year - 1980) << 25 | (uint)time.Month << 21 | (uint)time.Day << 16
+                | (uint)time.Hour << 11 | (uint)time.Minute << 5 | (uint)time.Second / 2;
+        }
+
+        // Eight bytes per step, a byte at a time the checksum was slower than storing the data
+        private static uint UpdateCrc32(uint crc, ReadOnlySpan<byte> data)
+        {
+            var tables = Crc32Tables;
+            while (data.Length >= 8)
+            {
+                uint low = BinaryPrimitives.ReadUInt32LittleEndian(data) ^ crc;
+                uint high = BinaryPrimitives.ReadUInt32LittleEndian(data[4..]);
+
+                crc = tables[7][low & 0xFF] ^ tables[6][(low >> 8) & 0xFF] ^ tables[5][(low >> 16) & 0xFF] ^ tables[4][low >> 24]
+                    ^ tables[3][high & 0xFF] ^ tables[2][(high >> 8) & 0xFF] ^ tables[1][(high >> 16) & 0xFF] ^ tables[0][high >> 24];
+                data = data[8..];
+            }
+
+            foreach (var value in data)
+            {
+                crc = tables[0][(crc ^ value) & 0xFF] ^ (crc >> 8);
+            }
+            return crc;
+        }
+
+        private static uint[][] CreateCrc32Tables()
+        {
+            var tables = new uint[8][];
+            for (int i = 0; i < tables.Length; i++)
+            {
+                tables[i] = new uint[256];
+            }
+
+            for (uint i = 0; i < 256; i++)
+            {
+                uint value = i;
+                for (int bit = 0; bit < 8; bit++)
+                {
+                    value = (value & 1) != 0 ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+                }
+                tables[0][i] = value;
+            }
+
+            for (int i = 1; i < tables.Length; i++)
+            {
+                for (int j = 0; j < 256; j++)
+                {
+                    uint previous = tables[i - 1][j];
+                    tables[i][j] = (previous >> 8) ^ tables[0][previous & 0xFF];
+                }
+            }
+            return tables;
+        }
+    }
+}
@@ -1,6 +1,7 @@
 ﻿using CommunityToolkit.Mvvm.ComponentModel;
 using Rememory.Core;
 using Rememory.Models.Metadata;
+using System.Threading;
 
 namespace Rememory.Models
 {
@@ -10,17 +11,94 @@ namespace Rememory.Models
 
         public ClipboardFormat Format { get; set; } = format;
 
+        // Either the string or its CompressedText, swapped as a single reference so readers on other threads see one or the other
+        private object? _data = data;
+        private object? _plainText;
+
         /// <summary>
         /// Contains only string text or absolute path to the file
         /// </summary>
-        public string Data { get; set; } = data;
+        public string Data
+        {
+            get => ReadText(_data) ?? string.Empty;
+            set => _data = value;
+        }
 
         /// <summary>
         /// Hash of the <see cref="Data"/> content
         /// </summary>
         public byte[] Hash { get; set; } = hash;
 
+        /// <summary>
+        /// Plain text extracted from HTML or RTF content, used for search
+        /// </summary>
+        public string? PlainText
+        {
+            get => ReadText(_plainText);
+            set => _plainText = value;
+        }
+
+        /// <summary>
+        /// Size in bytes of the file the <see cref="Data"/> points to, 0 for data stored inline
+        /// </summary>
+        public long Size { get; set; }
+
+        /// <summary>
+        /// Kind of text recognized at capture, not stored in the database
+        /// </summary>
+        public TextContent? Content { get; set; }
+
         [ObservableProperty]
         public partial IMetadata? Metadata { get; set; }
+
+        /// <summary>
+        /// Moves long texts out of the managed heap into compressed native memory.
+        /// Reads decompress them, or take them from the native cache of the most recently read texts,
+        /// until <see cref="DecompressText"/> is called or the text is set again.
+        /// </summary>
+        public void CompressText()
+        {
+            TryCompress(ref _data);
+            TryCompress(ref _plainText);
+        }
+
+        /// <summary>
+        /// Keeps the texts as strings again
+        /// </summary>
+        public void DecompressText()
+        {
+            TryDecompress(ref _data);
+            TryDecompress(ref _plainText);
+        }
+
+        /// <summary>
+        /// <see cref="Data"/> for a fuzzy search, or null if it is compressed and can't match, so it isn't decompressed for nothing
+        /// </summary>
+        public string? GetDataToMatch(FuzzyMatcher matcher) => CanMatch(_data, matcher) ? Data : null;
+
+        /// <summary>
+        /// <see cref="PlainText"/> for a fuzzy search, or null if it is compressed and can't match
+        /// </summary>
+        public string? GetPlainTextToMatch(FuzzyMatcher matcher) => CanMatch(_plainText, matcher) ? PlainText : null;
+
+        private static bool CanMatch(object? value, FuzzyMatcher matcher) => value is not CompressedText compressedText || compressedText.CanMatch(matcher);
+
+        private static string? ReadText(object? value) => value is CompressedText compressedText ? compressedText.Decompress() : (string?)value;
+
+        private static void TryCompress(ref object? value)
+        {
+            if (value is string text && CompressedText.TryCompress(text) is CompressedText compressedText)
+            {
+                Interlocked.CompareExchange(ref value, compressedText, text);
+            }
+        }
+
+        private static void TryDecompress(ref object? value)
+        {
+            if (value is CompressedText compressedText)
+            {
+                Interlocked.CompareExchange(ref value, compressedText.Decompress(), compressedText);
+            }
+        }
     }
 }
@@ -11,6 +11,11 @@ namespace Rememory.Models.Metadata
 
         public int FoldersCount { get; set; } = 0;
 
+        /// <summary>
+        /// Total size of the files and folder contents in bytes, null until it's fully counted
+        /// </summary>
+        public long? TotalSize { get; set; }
+
         public string[] Paths { get; private set; } = [];
 
         public FilesMetadataModel() { }
@@ -32,6 +37,14 @@ namespace Rememory.Models.Metadata
             }
         }
 
+        public FilesMetadataModel(string filesPaths, FilesInfo filesInfo)
+        {
+            SetPaths(filesPaths);
+            FilesCount = filesInfo.FilesCount;
+            FoldersCount = filesInfo.FoldersCount;
+            TotalSize = filesInfo.IsTotalSizeComplete ? (long)filesInfo.TotalSize : null;
+        }
+
         public void SetPaths(string filesPaths)
         {
             Paths = filesPaths.Split(FormatManager.FilePathsSeparator);
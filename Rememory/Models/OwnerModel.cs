@@ -46,6 +46,11 @@ namespace Rememory.Models
 
         public int ClipsCount { get; set; } = 0;
 
+        /// <summary>
+        /// Total size in bytes of the History files that belong to this owner's clips
+        /// </summary>
+        public long DataSize { get; set; } = 0;
+
         private void UpdateIconBitmap(byte[]? icon)
         {
             IconBitmap = icon is null ? null : BitmapHelper.GetBitmapFromBytes(icon);
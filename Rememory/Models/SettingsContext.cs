@@ -26,6 +26,7 @@ namespace Rememory.Models
     {
         private readonly ApplicationDataContainer _localSettings;
         private readonly ClipboardMonitor _clipboardMonitor;
+        private readonly QueryServer _queryServer;
 
         #region Settings Window
 
@@ -395,6 +396,33 @@ namespace Rememory.Models
         }
 
 
+        private bool? _isHistorySizeLimitEnabled;
+
+        [Settings(nameof(IsHistorySizeLimitEnabled), DefaultValue = false)]
+        public bool IsHistorySizeLimitEnabled
+        {
+            get => _isHistorySizeLimitEnabled ??= GetSettingValue<bool>();
+            set => SetSettingsProperty(ref _isHistorySizeLimitEnabled, value);
+        }
+
+
+        private int? _historySizeLimit;
+        private static bool HistorySizeLimitValidate(int value) => value >= HistorySizeLimitLowerBound && value <= HistorySizeLimitUpperBound;
+
+        public static readonly int HistorySizeLimitLowerBound = 1;
+        public static readonly int HistorySizeLimitUpperBound = 1024;
+
+        /// <summary>
+        /// Maximum size of the files stored in the History folder, in gigabytes
+        /// </summary>
+        [Settings(nameof(HistorySizeLimit), DefaultValue = 10, Validator = nameof(HistorySizeLimitValidate))]
+        public int HistorySizeLimit
+        {
+            get => _historySizeLimit ??= GetSettingValue<int>();
+            set => SetSettingsProperty(ref _historySizeLimit, value);
+        }
+
+
         private bool? _isClipSizeValidationEnabled;
 
         [Settings(nameof(IsClipSizeValidationEnabled), DefaultValue = true)]
@@ -439,6 +467,87 @@ namespace Rememory.Models
             }
         }
 
+
+        private bool? _isSimilarImageCollapsingEnabled;
+
+        [Settings(nameof(IsSimilarImageCollapsingEnabled), DefaultValue = false)]
+        public bool IsSimilarImageCollapsingEnabled
+        {
+            get => _isSimilarImageCollapsingEnabled ??= GetSettingValue<bool>();
+            set
+            {
+                if (SetSettingsProperty(ref _isSimilarImageCollapsingEnabled, value))
+                {
+                    _clipboardMonitor.IsSimilarImageDetectionEnabled = value;
+                }
+            }
+        }
+
+
+        private int? _similarImageThreshold;
+        private static bool SimilarImageThresholdValidate(int value) => value >= SimilarImageThresholdLowerBound && value <= SimilarImageThresholdUpperBound;
+
+        public static readonly int SimilarImageThresholdLowerBound = 0;
+        public static readonly int SimilarImageThresholdUpperBound = 16;
+
+        /// <summary>
+        /// Number of differing bits of the 64-bit image hash at which two images are still considered the same
+        /// </summary>
+        [Settings(nameof(SimilarImageThreshold), DefaultValue = 4, Validator = nameof(SimilarImageThresholdValidate))]
+        public int SimilarImageThreshold
+        {
+            get => _similarImageThreshold ??= GetSettingValue<int>();
+            set
+            {
+                if (SetSettingsProperty(ref _similarImageThreshold, value))
+                {
+                    _clipboardMonitor.SimilarImageThreshold = value;
+                }
+            }
+        }
+
+
+        private bool? _isHistoryEncryptionEnabled;
+
+        /// <summary>
+        /// Seals new clips with a key protected for the current Windows user. Existing clips are not rewritten.
+        /// </summary>
+        [Settings(nameof(IsHistoryEncryptionEnabled), DefaultValue = false)]
+        public bool IsHistoryEncryptionEnabled
+        {
+            get => _isHistoryEncryptionEnabled ??= GetSettingValue<bool>();
+            set
+            {
+                if (SetSettingsProperty(ref _isHistoryEncryptionEnabled, value))
+                {
+                    _clipboardMonitor.IsHistoryEncryptionEnabled = value;
+                    UpdateQueryServer();
+                }
+            }
+        }
+
+
+        private bool? _isQueryServerEnabled;
+
+        /// <summary>
+        /// Lets scripts and terminals of the current Windows user read the history with <c>rememory get</c>, <c>list</c> and <c>search</c>.
+        /// The server stays off while the history is encrypted, it would hand the decrypted clips to any process of the user.
+        /// </summary>
+        [Settings(nameof(IsQueryServerEnabled), DefaultValue = false)]
+        public bool IsQueryServerEnabled
+        {
+            get => _isQueryServerEnabled ??= GetSettingValue<bool>();
+            set
+            {
+                if (SetSettingsProperty(ref _isQueryServerEnabled, value))
+                {
+                    UpdateQueryServer();
+                }
+            }
+        }
+
+        private void UpdateQueryServer() => _queryServer.IsEnabled = IsQueryServerEnabled && !IsHistoryEncryptionEnabled;
+
         #endregion
 
         #region Filters
@@ -480,9 +589,10 @@ namespace Rememory.Models
 
         public bool IsAppFirstRun { get; init; }
 
-        public SettingsContext(ClipboardMonitor clipboardMonitor)
+        public SettingsContext(ClipboardMonitor clipboardMonitor, QueryServer queryServer)
         {
             _clipboardMonitor = clipboardMonitor;
+            _queryServer = queryServer;
             _localSettings = ApplicationData.GetDefault().LocalSettings;
             _supportedLanguages = ApplicationLanguages.ManifestLanguages.ToList();
             _supportedLanguages.Insert(0, string.Empty);   // Default language
@@ -491,6 +601,10 @@ namespace Rememory.Models
             _localSettings.Values["AppVersion"] = Package.Current.Id.Version.ToFormattedString();
 
             SetMaxDataSize(MaxClipSize);
+            _clipboardMonitor.IsSimilarImageDetectionEnabled = IsSimilarImageCollapsingEnabled;
+            _clipboardMonitor.SimilarImageThreshold = SimilarImageThreshold;
+            _clipboardMonitor.IsHistoryEncryptionEnabled = IsHistoryEncryptionEnabled;
+            UpdateQueryServer();
         }
 
         private T GetSettingValue<T>(object? overrideDefault = null, [CallerMemberName] string? propertyName = null)
@@ -17,6 +17,13 @@ namespace Rememory
         static int Main(string[] args)
         {
             ComWrappersSupport.InitializeComWrappers();
+
+            // Queries from a terminal are answered by the running app, this process only prints them
+            if (CommandLineClient.IsCommand(args))
+            {
+                return CommandLineClient.Run(args);
+            }
+
             AppActivationArguments activationArgs = AppInstance.GetCurrent().GetActivatedEventArgs();
             bool isRedirect;
             try
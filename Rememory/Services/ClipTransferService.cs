@@ -9,6 +9,7 @@ using System.Collections.Generic;
 using System.IO;
 using System.IO.Compression;
 using System.Linq;
+using System.Runtime.InteropServices.WindowsRuntime;
 using System.Threading.Tasks;
 
 namespace Rememory.Services
@@ -33,6 +34,10 @@ namespace Rememory.Services
                 return false;
             }
 
+            // Clips with identical blobs share a single archive entry
+            var exportedFiles = new Dictionary<string, DataModel>();
+            var exportedClips = clips.ToDictionary(clip => clip, clip => CreateExportClip(clip, exportedFiles));
+
             var backupDatabaseTempFilePath = GetTempDbFilePath();
             using SqliteService sqliteService = SqliteService.CreateForBackup(_clipboardMonitor.HistoryFolderPath, backupDatabaseTempFilePath);
 
@@ -61,7 +66,7 @@ namespace Rememory.Services
                         int? ownerId = (clip.Owner?.Id is not null && exportedOwnerIds.TryGetValue(clip.Owner.Id, out var exportedOwnerId))
                             ? exportedOwnerId
                             : null;
-                        var savedId = sqliteService.AddClip(clip, ownerId);
+                        var savedId = sqliteService.AddClip(exportedClips[clip], ownerId);
                         exportedClipIds.Add(clip.Id, savedId);
                     }
 
@@ -101,21 +106,25 @@ namespace Rememory.Services
                 return false;
             }
 
-            await using var zipStream = new FileStream(destinationFilePath, FileMode.Create, FileAccess.Write, FileShare.None, 4096, useAsync: true);
-            await using var archive = new ZipArchive(zipStream, ZipArchiveMode.Create);
-
-            await archive.CreateEntryFromFileAsync(backupDatabaseTempFilePath, "ClipboardManager.db", CompressionLevel.Optimal);
-            File.Delete(backupDatabaseTempFilePath);
-
-            foreach (var clip in clips)
+            // Entries are deflated in parallel, the database goes first as before
+            ParallelZipWriter.EntrySource[] entrySources = [
+                new("ClipboardManager.db", () => File.OpenRead(backupDatabaseTempFilePath), CompressionLevel.Optimal, DateTime.Now),
+                .. exportedFiles.Values
+                    .Where(dataModel => Path.Exists(dataModel.Data))
+                    .Select(dataModel => new ParallelZipWriter.EntrySource(
+                        GetEntryName(dataModel.Data),
+                        () => OpenExportFile(dataModel.Data),
+                        GetCompressionLevel(dataModel.Format),
+                        File.GetLastWriteTime(dataModel.Data)))
+            ];
+
+            try
             {
-                foreach (var dataModel in clip.Data.Values.Where(dm => dm.IsFile() && Path.Exists(dm.Data)))
-                {
-                    var parentName = Path.GetFileName(Path.GetDirectoryName(dataModel.Data))!;
-                    var entryName = Path.Combine(parentName, Path.GetFileName(dataModel.Data));
-
-                    await archive.CreateEntryFromFileAsync(dataModel.Data, entryName, CompressionLevel.Optimal);
-                }
+                await ParallelZipWriter.WriteAsync(destinationFilePath, entrySources, ApplicationData.GetDefault().TemporaryFolder.Path);
+            }
+            finally
+            {
+                File.Delete(backupDatabaseTempFilePath);
             }
 
             return true;
@@ -137,29 +146,25 @@ namespace Rememory.Services
                 return false;
             }
 
-            // Data files extract
-            
-            var dataFilesToExtract = archive.Entries
-                .Where(entry => entry.Length > 0 && SupportedFormatFolders_.Any(supportedFolderName => entry.FullName.StartsWith(supportedFolderName)))
-                .Select(entry => new KeyValuePair<string, ZipArchiveEntry>(Path.Combine(_clipboardMonitor.HistoryFolderPath, entry.FullName), entry))
-                .Where(dataFileEntryPair => !File.Exists(dataFileEntryPair.Key));
-
-            foreach (var dataFileEntryPair in dataFilesToExtract)
-            {
-                Directory.CreateDirectory(Path.GetDirectoryName(dataFileEntryPair.Key)!);
-                await dataFileEntryPair.Value.ExtractToFileAsync(dataFileEntryPair.Key);
-            }
-
             // DB extract and import
 
             var extractedDbPath = GetTempDbFilePath();
             dbEntry.ExtractToFile(extractedDbPath);
 
             using SqliteService sqliteService = SqliteService.CreateForBackup(_clipboardMonitor.HistoryFolderPath, extractedDbPath);
-            var clipsTimeHashSet = _clipboardService.Clips.Select(c => c.ClipTime).ToHashSet();   // To check if we already have this clip by cliptime
+
+            // A clip is already present if it has the same time or the same content
+            Dictionary<DateTime, ClipModel> clipsByTime = [];
+            Dictionary<string, ClipModel> clipsByContent = [];
+            foreach (var clip in _clipboardService.Clips)
+            {
+                clipsByTime.TryAdd(clip.ClipTime, clip);
+                AddContentKeys(clip, clipsByContent);
+            }
 
             IList<TagModel> tagsToImport = [];
             IList<ClipModel> clipsToImport = [];
+            IList<(ClipModel BackupClip, ClipModel PresentClip)> clipsToMerge = [];
 
             await Task.Run(() =>
             {
@@ -172,9 +177,57 @@ namespace Rememory.Services
                 }
 
                 tagsToImport = [.. sqliteService.GetTags()];
-                clipsToImport = [.. sqliteService.GetClips(owners, tagsToImport).Where(clip => !clipsTimeHashSet.Contains(clip.ClipTime))];
+                var clipsToImportSet = new HashSet<ClipModel>(ReferenceEqualityComparer.Instance);
+
+                foreach (var clip in sqliteService.GetClips(owners, tagsToImport))
+                {
+                    var presentClip = clipsByTime.GetValueOrDefault(clip.ClipTime)
+                        ?? GetContentKeys(clip).Select(key => clipsByContent.GetValueOrDefault(key)).FirstOrDefault(match => match is not null);
+
+                    if (presentClip is null)
+                    {
+                        // Also skips repeats within the backup itself
+                        AddContentKeys(clip, clipsByContent);
+                        clipsToImport.Add(clip);
+                        clipsToImportSet.Add(clip);
+                    }
+                    else if (clipsToImportSet.Contains(presentClip))
+                    {
+                        // A repeat within the backup passes its tags and favorite state to the clip that is imported
+                        presentClip.IsFavorite |= clip.IsFavorite;
+                        foreach (var tag in clip.Tags.Where(tag => !presentClip.Tags.Contains(tag)))
+                        {
+                            presentClip.Tags.Add(tag);
+                        }
+                    }
+                    else
+                    {
+                        clipsToMerge.Add((clip, presentClip));
+                    }
+                }
             });
 
+            // Data files extract, only those referenced by the imported clips
+
+            var dataFilesToImport = clipsToImport
+                .SelectMany(clip => clip.Data.Values)
+                .Where(dataModel => dataModel.IsFile())
+                .Select(dataModel => dataModel.Data)
+                .ToHashSet(StringComparer.OrdinalIgnoreCase);
+
+            var dataFilesToExtract = archive.Entries
+                .Where(entry => entry.Length > 0 && SupportedFormatFolders_.Any(supportedFolderName => entry.FullName.StartsWith(supportedFolderName)))
+                .Select(entry => new KeyValuePair<string, ZipArchiveEntry>(Path.Combine(_clipboardMonitor.HistoryFolderPath, entry.FullName), entry))
+                .Where(dataFileEntryPair => dataFilesToImport.Contains(dataFileEntryPair.Key) && !File.Exists(dataFileEntryPair.Key));
+
+            foreach (var dataFileEntryPair in dataFilesToExtract)
+            {
+                Directory.CreateDirectory(Path.GetDirectoryName(dataFileEntryPair.Key)!);
+                await dataFileEntryPair.Value.ExtractToFileAsync(dataFileEntryPair.Key);
+            }
+
+            SplitSharedDataFiles(clipsToImport);
+
             Dictionary<int, TagModel> tagIdPairs = [];
             foreach (var tagToImport in tagsToImport)
             {
@@ -222,6 +275,20 @@ namespace Rememory.Services
                 importedClips.Add(newClip);
             }
 
+            // Clips that are already in history keep their data, but get the tags and favorite state from the backup
+            foreach (var (backupClip, presentClip) in clipsToMerge)
+            {
+                foreach (var tag in backupClip.Tags)
+                {
+                    _tagService.AddClipToTag(tagIdPairs[tag.Id], presentClip);
+                }
+
+                if (backupClip.IsFavorite && !presentClip.IsFavorite)
+                {
+                    _clipboardService.ToggleClipFavorite(presentClip);
+                }
+            }
+
             foreach (var insertedTag in tagIdPairs.Values.Where(tag => tag.ClipsCount == 0))
             {
                 _tagService.UnregisterTag(insertedTag);
@@ -235,6 +302,110 @@ namespace Rememory.Services
             return true;
         }
 
+        /// <summary>
+        /// Copies the clip for the backup database, pointing its files to the first exported file with the same content
+        /// </summary>
+        private static ClipModel CreateExportClip(ClipModel clip, Dictionary<string, DataModel> exportedFiles)
+        {
+            var exportClip = new ClipModel()
+            {
+                ClipTime = clip.ClipTime,
+                IsFavorite = clip.IsFavorite,
+                IsLink = clip.IsLink
+            };
+
+            foreach (var (format, dataModel) in clip.Data)
+            {
+                var exportData = dataModel;
+
+                if (dataModel.IsFile())
+                {
+                    var key = GetContentKey(dataModel);
+                    if (!exportedFiles.TryGetValue(key, out var exportedFile))
+                    {
+                        exportedFiles.Add(key, dataModel);
+                    }
+                    else if (exportedFile.Data != dataModel.Data)
+                    {
+                        exportData = new DataModel(format, exportedFile.Data, dataModel.Hash)
+                        {
+                            Metadata = dataModel.Metadata,
+                            PlainText = dataModel.PlainText
+                        };
+                    }
+                }
+
+                exportClip.Data.Add(format, exportData);
+            }
+
+            return exportClip;
+        }
+
+        /// <summary>
+        /// Every clip owns its files, so a file that is shared in the backup gets a copy per additional clip
+        /// </summary>
+        private static void SplitSharedDataFiles(IEnumerable<ClipModel> clips)
+        {
+            var usedPaths = new HashSet<string>(StringComparer.OrdinalIgnoreCase);
+
+            foreach (var dataModel in clips.SelectMany(clip => clip.Data.Values).Where(dataModel => dataModel.IsFile()))
+            {
+                if (usedPaths.Add(dataModel.Data) || !File.Exists(dataModel.Data))
+                {
+                    continue;
+                }
+
+                var directory = Path.GetDirectoryName(dataModel.Data)!;
+                var name = Path.GetFileNameWithoutExtension(dataModel.Data);
+                var extension = Path.GetExtension(dataModel.Data);
+                string copyPath;
+                int index = 1;
+
+                do
+                {
+                    copyPath = Path.Combine(directory, $"{name}_{index++}{extension}");
+                }
+                while (File.Exists(copyPath));
+
+                File.Copy(dataModel.Data, copyPath);
+                dataModel.Data = copyPath;
+                usedPaths.Add(copyPath);
+            }
+        }
+
+        private static void AddContentKeys(ClipModel clip, Dictionary<string, ClipModel> clipsByContent)
+        {
+            foreach (var key in GetContentKeys(clip))
+            {
+                clipsByContent.TryAdd(key, clip);
+            }
+        }
+
+        private static string GetContentKey(DataModel dataModel) => $"{dataModel.Format}:{Convert.ToHexString(dataModel.Hash)}";
+
+        /// <summary>
+        /// Keys of the formats that identify a clip, same as the duplicate detection of new captures
+        /// </summary>
+        private static IEnumerable<string> GetContentKeys(ClipModel clip) => clip.Data.Values
+            .Where(dataModel => dataModel.Format is ClipboardFormat.Text or ClipboardFormat.Bitmap or ClipboardFormat.Png or ClipboardFormat.Files)
+            .Select(GetContentKey);
+
+        // Backups are not encrypted, so encrypted files are exported decrypted
+        private static Stream OpenExportFile(string path) => FormatManager.IsHistoryFileSealed(path)
+            ? (FormatManager.ReadHistoryFile(path) ?? throw new IOException($"Unable to decrypt {path}")).AsStream()
+            : File.OpenRead(path);
+
+        private static string GetEntryName(string filePath)
+        {
+            var parentName = Path.GetFileName(Path.GetDirectoryName(filePath))!;
+            return Path.Combine(parentName, Path.GetFileName(filePath));
+        }
+
+        // PNG is already deflated, recompressing it only costs time
+        private static CompressionLevel GetCompressionLevel(ClipboardFormat format) => format == ClipboardFormat.Png
+            ? CompressionLevel.NoCompression
+            : CompressionLevel.Optimal;
+
         private static string GetTempDbFilePath() => Path.Combine(ApplicationData.GetDefault().TemporaryFolder.Path, string.Format("Backup_{0:yyyyMMdd_HHmmss}.db", DateTime.Now));
     }
 }
@@ -11,6 +11,7 @@ using System.IO;
 using System.Linq;
 using System.Runtime.InteropServices.WindowsRuntime;
 using System.Threading.Tasks;
+using Windows.Foundation;
 using Windows.Storage;
 
 namespace Rememory.Services
@@ -24,20 +25,47 @@ namespace Rememory.Services
 
         public IList<ClipModel> Clips { get; private set; }
 
+        public long HistorySize { get; private set; }
+
         private readonly IStorageService _storageService;
         private readonly IOwnerService _ownerService;
         private readonly ITagService _tagService;
         private readonly ILinkPreviewService _linkPreviewService;
         private readonly ClipboardMonitor _clipboardMonitor;
+        private readonly QueryServer _queryServer;
+
+        // Clips by id, resolved from the native duplicate index hint
+        private readonly Dictionary<int, ClipModel> _clipsById = [];
+
+        // Bytes of History files per format, kept up to date as clips are added and deleted
+        private readonly Dictionary<ClipboardFormat, long> _historySizeByFormat = [];
 
         private readonly SettingsContext _settingsContext = App.Current.SettingsContext;
 
+        // Time given to count the size of copied folders the capture didn't finish with
+        private static readonly TimeSpan FilesScanTimeBudget = TimeSpan.FromSeconds(30);
+
+        // The most recent clips keep their text as strings, older texts are compressed in native memory
+        private const int HotClipCount = 100;
+
+        // Files of the most recent and the most pasted clips are read and decoded natively ahead of a paste
+        private const int RecentPasteCandidateCount = 5;
+        private const int FrequentPasteCandidateCount = 3;
+        private readonly Dictionary<string, (ClipboardFormat Format, int Count)> _filePasteCounts = [];
+
+        // Kept up to date so cleanup by quantity costs as much as the clips it deletes, not the whole history.
+        // The count is null when it has to be recounted, after tags changed
+        private int? _cleanableCount;
+        private bool _cleanableCountIncludesFavorites;
+        private int _protectedTailCount;   // Oldest clips that cleanup can't delete, skipped by the next cleanup
+
         public ClipboardService(
             IStorageService storageService,
             IOwnerService ownerService,
             ITagService tagService,
             ILinkPreviewService linkPreviewService,
-            ClipboardMonitor clipboardMonitor)
+            ClipboardMonitor clipboardMonitor,
+            QueryServer queryServer)
         {
             _storageService = storageService;
             _ownerService = ownerService;
@@ -45,61 +73,86 @@ namespace Rememory.Services
             _linkPreviewService = linkPreviewService;
             _clipboardMonitor = clipboardMonitor;
             _clipboardMonitor.ContentDetected += ClipboardMonitor_ContentDetected;
+            _tagService.CleanupProtectionChanged += (_, _) => InvalidateCleanupState();
 
             Clips = ReadClipsFromStorage();
+            RebuildDuplicateIndex();
+
+            foreach (var clip in Clips)
+            {
+                UpdateHistorySize(clip, true);
+            }
+
+            CompressColdClips();
+            UpdatePasteCandidates();
+
+            _queryServer = queryServer;
+            _queryServer.SetHistoryProvider(GetQueryHistoryAsync);
+            _queryServer.SetSearchProvider(SearchQueryHistoryAsync);
         }
 
         public bool SetClipboardData(Dictionary<ClipboardFormat, DataModel> data, TextCaseType? caseType = null)
         {
-            var dataMap = new Dictionary<ClipboardFormat, string>();
+            var dataMap = data.ToDictionary(item => item.Key, item => item.Value.Data);
 
-            foreach (var item in data)
-            {
-                string finalData = item.Value.Data;
-
-                // Apply Text Case transformation if needed
-                if (item.Key == ClipboardFormat.Text && caseType.HasValue)
-                {
-                    finalData = finalData.ConvertText(caseType.Value);
-                }
+            // Text case is converted natively while the text is copied into the clipboard memory
+            var textTransform = caseType?.ToTextTransform() ?? TextTransform.None;
+            bool isSet = _clipboardMonitor.SetClipboardData(dataMap, textTransform);
 
-                dataMap[item.Key] = finalData;
+            foreach (var dataModel in data.Values.Where(ClipboardFormatHelper.IsFile))
+            {
+                int count = _filePasteCounts.GetValueOrDefault(dataModel.Data).Count;
+                _filePasteCounts[dataModel.Data] = (dataModel.Format, count + 1);
             }
+            UpdatePasteCandidates();
 
-            return _clipboardMonitor.SetClipboardData(dataMap);
+            return isSet;
         }
 
         public void AddClip(ClipModel clip)
         {
-            Clips.Insert(0, clip);
-            _storageService.AddClip(clip, GetNonEmptyOwnerId(clip));   // Don't save empty owner id
-
+            // Metadata known up front is attached before saving, so the clip is written in a single transaction
             if (clip.Data.TryGetValue(ClipboardFormat.Text, out var textData))
             {
-                if (textData.Data.IsValidColor(_settingsContext.IsHexColorPrefixRequired))
+                // The text is classified natively, at capture for new clips
+                if (textData.GetTextContent().IsColor(_settingsContext.IsHexColorPrefixRequired))
                 {
-                    ColorMetadataModel colorMetadata = new();
-                    textData.Metadata = colorMetadata;
-                    _storageService.AddColorMetadata(colorMetadata, textData.Id);
+                    textData.Metadata = new ColorMetadataModel();
                 }
                 else
                 {
                     // Detect if the new clip contains a link
-                    clip.IsLink = Uri.TryCreate(textData.Data, UriKind.Absolute, out var uri)
-                        && (uri.Scheme == Uri.UriSchemeHttp || uri.Scheme == Uri.UriSchemeHttps);
-
-                    if (_settingsContext.IsLinkPreviewLoadingEnabled && clip.IsLink)
-                    {
-                        _linkPreviewService.TryLoadLinkMetadata(textData);
-                    }
+                    clip.IsLink = textData.IsWebLink();
                 }
             }
 
             if (clip.Data.TryGetValue(ClipboardFormat.Files, out var filesData))
             {
-                FilesMetadataModel filesMetadata = new(filesData.Data);
-                filesData.Metadata = filesMetadata;
-                _storageService.AddFilesMetadata(filesMetadata, filesData.Id);
+                filesData.Metadata ??= new FilesMetadataModel(filesData.Data);
+            }
+
+            foreach (var data in clip.Data.Values)
+            {
+                data.UpdateFileSize();
+            }
+
+            Clips.Insert(0, clip);
+            UpdateCleanupState(clip, true);
+            _storageService.AddClip(clip, GetNonEmptyOwnerId(clip));   // Don't save empty owner id
+            AddToDuplicateIndex(clip);
+            UpdateHotClips(clip);
+            UpdatePasteCandidates();
+            UpdateHistorySize(clip, true);
+
+            // Link preview is loaded later and saved on its own
+            if (textData is not null && clip.IsLink && _settingsContext.IsLinkPreviewLoadingEnabled)
+            {
+                _linkPreviewService.TryLoadLinkMetadata(textData);
+            }
+
+            if (filesData?.Metadata is FilesMetadataModel { TotalSize: null } filesMetadata)
+            {
+                _ = UpdateFilesTotalSizeAsync(clip, filesData, filesMetadata);
             }
 
             OnNewClipAdded(Clips, clip);
@@ -108,16 +161,31 @@ namespace Rememory.Services
             {
                 DeleteOldClipsByQuantity(_settingsContext.CleanupQuantity, _settingsContext.IsFavoriteClipsCleaningEnabled);
             }
+
+            if (_settingsContext.IsHistorySizeLimitEnabled)
+            {
+                DeleteOldClipsBySize((long)_settingsContext.HistorySizeLimit * 1024 * 1024 * 1024, _settingsContext.IsFavoriteClipsCleaningEnabled);
+            }
         }
 
         public void InsertClips(IEnumerable<ClipModel> clips)
         {
             foreach (var clip in clips)
             {
+                foreach (var data in clip.Data.Values)
+                {
+                    data.UpdateFileSize();
+                }
+
                 Clips.Add(clip);
+                UpdateHistorySize(clip, true);
             }
 
             Clips = [.. Clips.OrderByDescending(c => c.ClipTime)];
+            InvalidateCleanupState();
+            RebuildDuplicateIndex();
+            CompressColdClips();
+            UpdatePasteCandidates();
             OnClipsCollectionChanged(Clips);
         }
 
@@ -130,14 +198,20 @@ namespace Rememory.Services
             if (Clips.First() != clip)
             {
                 Clips.Remove(clip);
+                UpdateCleanupState(clip, false);
                 Clips.Insert(0, clip);
+                UpdateCleanupState(clip, true);
+                UpdateHotClips(clip);
+                UpdatePasteCandidates();
                 OnClipMovedToTop(Clips, clip);
             }
         }
 
         public void ToggleClipFavorite(ClipModel clip)
         {
+            UpdateCleanupState(clip, false);
             clip.IsFavorite = !clip.IsFavorite;
+            UpdateCleanupState(clip, true);
             _storageService.UpdateClip(clip, GetNonEmptyOwnerId(clip));
         }
 
@@ -171,8 +245,8 @@ namespace Rememory.Services
 
                 if (dataModel.IsFile() && File.Exists(dataModel.Data))
                 {
-                    var originFile = await StorageFile.GetFileFromPathAsync(dataModel.Data);
-                    using var originStream = await originFile.OpenStreamForReadAsync();
+                    using var originHistoryStream = await ClipboardFormatHelper.OpenHistoryFileAsync(dataModel.Data);
+                    using var originStream = originHistoryStream.AsStreamForRead();
                     using var destinationStream = await newFile.OpenStreamForWriteAsync();
 
                     await originStream.CopyToAsync(destinationStream);
@@ -189,78 +263,81 @@ namespace Rememory.Services
         public void DeleteClip(ClipModel clip, bool deleteFromDb = true)
         {
             Clips.Remove(clip);
-            foreach (var tag in clip.Tags)
-            {
-                tag.Clips.Remove(clip);
-                tag.TogglePropertyUpdate(nameof(tag.ClipsCount));
-            }
-            clip.Tags.Clear();
-            clip.ClearExternalDataFiles();
+            ReleaseClip(clip);
             if (deleteFromDb)
             {
                 _storageService.DeleteClip(clip.Id);
             }
-            _ownerService.UnregisterClipOwner(clip);
+            UpdatePasteCandidates();
             OnClipDeleted(Clips, clip);
         }
 
         public void DeleteOldClipsByTime(DateTime cutoffTime, bool deleteFavoriteClips)
         {
-            var clipsToDelete = Clips
-                .Where(clip => clip.ClipTime < cutoffTime && (deleteFavoriteClips || !clip.IsFavorite) && clip.Tags.All(tag => tag.IsCleaningEnabled))
-                .ToList();
-
-            _storageService.DeleteOldClipsByTime(cutoffTime, deleteFavoriteClips);
-
-            foreach (var clip in clipsToDelete)
+            // Clips are ordered by time, so only the old tail has to be visited
+            var clipsToDelete = new List<ClipModel>();
+            int i = Clips.Count - 1;
+            for (; i >= 0 && Clips[i].ClipTime < cutoffTime; i--)
             {
-                DeleteClip(clip, false);
+                if (IsCleanable(Clips[i], deleteFavoriteClips))
+                {
+                    clipsToDelete.Add(Clips[i]);
+                }
             }
+
+            DeleteClips(clipsToDelete, i + 1);
         }
 
         public void DeleteOldClipsByQuantity(int quantity, bool deleteFavoriteClips)
         {
-            var filteredClips = Clips
-                .Where(clip => (deleteFavoriteClips || !clip.IsFavorite) && clip.Tags.All(tag => tag.IsCleaningEnabled))
-                .OrderByDescending(clip => clip.ClipTime)
-                .ToArray();
-
-            if (filteredClips.Length <= quantity)
+            int excessCount = GetCleanableCount(deleteFavoriteClips) - quantity;
+            if (excessCount <= 0)
             {
                 return;
             }
 
-            _storageService.DeleteOldClipsByQuantity(quantity, deleteFavoriteClips);
-
-            foreach (var clip in filteredClips.TakeLast(filteredClips.Length - quantity))
+            // The victims are the oldest cleanable clips, found walking back from the clips known to be protected
+            var clipsToDelete = new List<ClipModel>();
+            int i = Clips.Count - 1 - _protectedTailCount;
+            for (; i >= 0 && clipsToDelete.Count < excessCount; i--)
             {
-                DeleteClip(clip, false);
+                if (IsCleanable(Clips[i], deleteFavoriteClips))
+                {
+                    clipsToDelete.Add(Clips[i]);
+                }
             }
+
+            // Everything walked past and not deleted is protected, and ends up at the old end once the victims are gone
+            int protectedTailCount = Clips.Count - 1 - i - clipsToDelete.Count;
+            DeleteClips(clipsToDelete, i + 1);
+            _protectedTailCount = protectedTailCount;
         }
 
-        public void DeleteClipsByFilter(Func<ClipModel, bool> clipsFilter)
+        public void DeleteOldClipsBySize(long maxSize, bool deleteFavoriteClips)
         {
-            var clipsToDelete = Clips
-                .Where(clipsFilter)
-                .ToList();
-
-            var clipIdsToDelete = clipsToDelete
-                .Select(clip => clip.Id)
-                .ToList();
-
-            foreach (var clip in clipsToDelete)
-            {
-                DeleteClip(clip, false);
-            }
+            long excessSize = HistorySize - maxSize;
+            var clipsToDelete = new List<ClipModel>();
 
-            // Deleting each clip one by one since we use advanced filter
-            Task.Run(() =>
+            // Oldest clips with files go first, the newest clip is always kept
+            int i = Clips.Count - 1;
+            for (; i > 0 && excessSize > 0; i--)
             {
-                foreach (var id in clipIdsToDelete)
+                long clipSize = Clips[i].Data.Values.Sum(data => data.Size);
+                if (clipSize > 0 && IsCleanable(Clips[i], deleteFavoriteClips))
                 {
-                    _storageService.DeleteClip(id);
+                    clipsToDelete.Add(Clips[i]);
+                    excessSize -= clipSize;
                 }
-            });
+            }
+
+            DeleteClips(clipsToDelete, i + 1);
+        }
+
+        public long GetHistorySize(ClipboardFormat format) => _historySizeByFormat.GetValueOrDefault(format);
+
+        public void DeleteClipsByFilter(Func<ClipModel, bool> clipsFilter)
+        {
+            DeleteClips(Clips.Where(clipsFilter).ToList());
         }
 
         protected virtual void OnNewClipAdded(IList<ClipModel> clips, ClipModel newClip)
@@ -315,7 +392,13 @@ namespace Rememory.Services
             {
                 if (!string.IsNullOrEmpty(record.Data) && record.Hash is not null && record.Hash.Length > 0)
                 {
-                    DataModel clipData = new(record.Format, record.Data, record.Hash.ToArray());
+                    DataModel clipData = new(record.Format, record.Data, record.Hash.ToArray())
+                    {
+                        PlainText = string.IsNullOrEmpty(record.PlainText) ? null : record.PlainText,
+                        Content = record.Format == ClipboardFormat.Text ? record.Content : null,
+                        // File counts and sizes are scanned natively during the capture
+                        Metadata = record.FilesInfo is null ? null : new FilesMetadataModel(record.Data, record.FilesInfo)
+                    };
                     clip.Data.TryAdd(record.Format, clipData);
                 }
             }
@@ -325,20 +408,31 @@ namespace Rememory.Services
                 return;
             }
 
-            App.Current.DispatcherQueue.TryEnqueue(() =>
+            void AddDetectedClip()
             {
                 _ownerService.RegisterClipOwner(clip, ownerPath, iconPixels);
 
-                if (!TryMoveDuplicateItem(clip))
+                if (!TryMoveDuplicateItem(clip, snapshot.ExistingClipId))
                 {
                     AddClip(clip);
+                    ReplaceSimilarItem(clip, snapshot.SimilarClipId);
                 }
 
                 if (_settingsContext.IsClipCopyMessageEnabled)
                 {
                     ShowToolTipMessage(clip);
                 }
-            });
+            }
+
+            // The event is raised on the UI thread, where the clip is added right away, so it's saved once Flush returns
+            if (App.Current.DispatcherQueue.HasThreadAccess)
+            {
+                AddDetectedClip();
+            }
+            else
+            {
+                App.Current.DispatcherQueue.TryEnqueue(AddDetectedClip);
+            }
         }
 
         private bool IsOwnerPathExcluded(string ownerPath)
@@ -360,23 +454,29 @@ namespace Rememory.Services
             return false;
         }
 
-        private bool TryMoveDuplicateItem(ClipModel newClip)
+        private bool TryMoveDuplicateItem(ClipModel newClip, int existingClipId)
         {
-            if (Clips.FirstOrDefault(clip => clip.EqualDataTo(newClip)) is ClipModel toMove)
+            if (existingClipId != 0 && _clipsById.TryGetValue(existingClipId, out var toMove))
             {
                 bool isMovedToTop = false;
                 if (!toMove.Equals(Clips.FirstOrDefault()))
                 {
                     Clips.Remove(toMove);
+                    UpdateCleanupState(toMove, false);
                     Clips.Insert(0, toMove);
+                    UpdateCleanupState(toMove, true);
+                    UpdateHotClips(toMove);
+                    UpdatePasteCandidates();
                     isMovedToTop = true;
                     toMove.ClipTime = newClip.ClipTime;
                 }
 
                 if (toMove.Owner != newClip.Owner)
                 {
+                    UpdateHistorySize(toMove, false);
                     _ownerService.UnregisterClipOwner(toMove);
                     toMove.Owner = newClip.Owner;   // newClip.Owner is already registered
+                    UpdateHistorySize(toMove, true);
                 }
 
                 _storageService.UpdateClip(toMove, GetNonEmptyOwnerId(toMove));
@@ -394,6 +494,303 @@ namespace Rememory.Services
             return false;
         }
 
+        /// <summary>
+        /// The new capture keeps its own image, the older clip with a near-identical one is deleted with its files and thumbnails.
+        /// Its tags and favorite state carry over to the new clip
+        /// </summary>
+        private void ReplaceSimilarItem(ClipModel newClip, int similarClipId)
+        {
+            // Cleanup after adding may have deleted it already
+            if (similarClipId == 0 || !_clipsById.TryGetValue(similarClipId, out var toReplace) || toReplace == newClip)
+            {
+                return;
+            }
+
+            foreach (var tag in toReplace.Tags.ToArray())
+            {
+                _tagService.AddClipToTag(tag, newClip);
+            }
+
+            if (toReplace.IsFavorite && !newClip.IsFavorite)
+            {
+                ToggleClipFavorite(newClip);
+            }
+
+            DeleteClip(toReplace);
+        }
+
+        /// <summary>
+        /// Compresses the text of every clip past the hot ones in the background
+        /// </summary>
+        private void CompressColdClips()
+        {
+            var coldData = Clips.Skip(HotClipCount).SelectMany(clip => clip.Data.Values).ToArray();
+            Task.Run(() =>
+            {
+                foreach (var data in coldData)
+                {
+                    data.CompressText();
+                }
+            });
+        }
+
+        /// <summary>
+        /// Keeps the text of the clip that moved to the top as strings and compresses the one pushed out of the hot clips
+        /// </summary>
+        private void UpdateHotClips(ClipModel topClip)
+        {
+            foreach (var data in topClip.Data.Values)
+            {
+                data.DecompressText();
+            }
+
+            if (Clips.Count > HotClipCount)
+            {
+                foreach (var data in Clips[HotClipCount].Data.Values)
+                {
+                    data.CompressText();
+                }
+            }
+        }
+
+        private void UpdatePasteCandidates()
+        {
+            var recentFiles = Clips.Take(RecentPasteCandidateCount)
+                .SelectMany(clip => clip.Data.Values)
+                .Where(ClipboardFormatHelper.IsFile)
+                .Select(dataModel => new KeyValuePair<ClipboardFormat, string>(dataModel.Format, dataModel.Data));
+
+            var frequentFiles = _filePasteCounts
+                .OrderByDescending(item => item.Value.Count)
+                .Take(FrequentPasteCandidateCount)
+                .Select(item => new KeyValuePair<ClipboardFormat, string>(item.Value.Format, item.Key));
+
+            _clipboardMonitor.SetPasteCandidates(recentFiles.Concat(frequentFiles).DistinctBy(file => file.Value).ToList());
+        }
+
+        /// <summary>
+        /// Texts of the most recent clips for the query server, the same texts the search matches
+        /// </summary>
+        private IAsyncOperation<IReadOnlyList<string>> GetQueryHistoryAsync(uint maxCount)
+        {
+            return Task.Run(async () =>
+            {
+                var clips = await GetClipsSnapshotAsync(maxCount);
+                return (IReadOnlyList<string>)clips.Select(clip => SearchService.GetSearchableText(clip) ?? string.Empty).ToArray();
+            }).AsAsyncOperation();
+        }
+
+        /// <summary>
+        /// Best matches of a query server search, found by the same matchers as the search in the app
+        /// </summary>
+        private IAsyncOperation<IReadOnlyList<QueryItem>> SearchQueryHistoryAsync(string query, bool isRegex, bool ignoreCase, uint maxCount)
+        {
+            return Task.Run(async () =>
+            {
+                var clips = await GetClipsSnapshotAsync(uint.MaxValue);
+                List<string> texts;
+                IReadOnlyList<int> indices = [];
+
+                if (isRegex)
+                {
+                    texts = clips.Select(clip => SearchService.GetSearchableText(clip) ?? string.Empty).ToList();
+                    if (RegexMatcher.TryCreate(query, ignoreCase) is RegexMatcher regexMatcher)
+                    {
+                        indices = await regexMatcher.FindMatchesAsync(texts, maxCount);
+                    }
+                }
+                else
+                {
+                    // Compressed texts that can't match are left out without being decompressed
+                    var matcher = new FuzzyMatcher(query);
+                    texts = clips.Select(clip => SearchService.GetSearchableText(clip, matcher) ?? string.Empty).ToList();
+                    indices = await matcher.FindBestAsync(texts, maxCount);
+                }
+
+                return (IReadOnlyList<QueryItem>)indices.Select(index => new QueryItem { Index = index + 1, Text = texts[index] }).ToArray();
+            }).AsAsyncOperation();
+        }
+
+        private Task<ClipModel[]> GetClipsSnapshotAsync(uint maxCount)
+        {
+            // Clips are only changed on the UI thread, so the snapshot is taken there
+            var snapshot = new TaskCompletionSource<ClipModel[]>();
+            if (!App.Current.DispatcherQueue.TryEnqueue(() => snapshot.SetResult(Clips.Take((int)Math.Min(maxCount, int.MaxValue)).ToArray())))
+            {
+                throw new InvalidOperationException("The app is shutting down");
+            }
+
+            return snapshot.Task;
+        }
+
+        private void AddToDuplicateIndex(ClipModel clip)
+        {
+            _clipsById[clip.Id] = clip;
+
+            foreach (var data in clip.Data.Values)
+            {
+                _clipboardMonitor.AddToDuplicateIndex(clip.Id, data.Format, data.Hash.AsBuffer());
+            }
+        }
+
+        private void RemoveFromDuplicateIndex(ClipModel clip)
+        {
+            _clipsById.Remove(clip.Id);
+            _clipboardMonitor.RemoveFromDuplicateIndex(clip.Id);
+        }
+
+        private void RebuildDuplicateIndex()
+        {
+            _clipsById.Clear();
+            _clipboardMonitor.ClearDuplicateIndex();
+
+            // Oldest first, so the newest clip owns a shared hash
+            for (int i = Clips.Count - 1; i >= 0; i--)
+            {
+                AddToDuplicateIndex(Clips[i]);
+            }
+        }
+
+        // Removes a batch of clips with a single pass over the list and a single storage transaction.
+        // Clips before firstIndex are known not to be deleted, so cleanup of the old end only moves the clips after it
+        private void DeleteClips(List<ClipModel> clipsToDelete, int firstIndex = 0)
+        {
+            if (clipsToDelete.Count == 0)
+            {
+                return;
+            }
+
+            if (Clips is List<ClipModel> clipsList)
+            {
+                var clipsToDeleteSet = clipsToDelete.ToHashSet();
+                int writeIndex = firstIndex;
+                for (int readIndex = firstIndex; readIndex < clipsList.Count; readIndex++)
+                {
+                    if (!clipsToDeleteSet.Contains(clipsList[readIndex]))
+                    {
+                        clipsList[writeIndex++] = clipsList[readIndex];
+                    }
+                }
+                clipsList.RemoveRange(writeIndex, clipsList.Count - writeIndex);
+            }
+            else
+            {
+                foreach (var clip in clipsToDelete)
+                {
+                    Clips.Remove(clip);
+                }
+            }
+
+            foreach (var clip in clipsToDelete)
+            {
+                ReleaseClip(clip);
+            }
+
+            _storageService.DeleteClips(clipsToDelete.Select(clip => clip.Id));
+            UpdatePasteCandidates();
+
+            foreach (var clip in clipsToDelete)
+            {
+                OnClipDeleted(Clips, clip);
+            }
+        }
+
+        private void ReleaseClip(ClipModel clip)
+        {
+            UpdateCleanupState(clip, false);
+            UpdateHistorySize(clip, false);
+            RemoveFromDuplicateIndex(clip);
+            foreach (var tag in clip.Tags)
+            {
+                tag.Clips.Remove(clip);
+                tag.TogglePropertyUpdate(nameof(tag.ClipsCount));
+            }
+            clip.Tags.Clear();
+            foreach (var dataModel in clip.Data.Values.Where(ClipboardFormatHelper.IsFile))
+            {
+                _filePasteCounts.Remove(dataModel.Data);
+            }
+            clip.ClearExternalDataFiles();
+            _ownerService.UnregisterClipOwner(clip);
+        }
+
+        private async Task UpdateFilesTotalSizeAsync(ClipModel clip, DataModel filesData, FilesMetadataModel filesMetadata)
+        {
+            try
+            {
+                var filesInfo = await FormatManager.ScanFilesAsync(filesData.Data, FilesScanTimeBudget);
+
+                // The clip could be deleted while its files were counted
+                if (filesInfo.IsTotalSizeComplete && _clipsById.ContainsKey(clip.Id))
+                {
+                    filesMetadata.TotalSize = (long)filesInfo.TotalSize;
+                    _storageService.AddFilesMetadata(filesMetadata, filesData.Id);
+                }
+            }
+            catch
+            {
+                // The size stays unknown, the clip itself is already saved
+            }
+        }
+
+        private void UpdateHistorySize(ClipModel clip, bool isAdded)
+        {
+            foreach (var data in clip.Data.Values)
+            {
+                if (data.Size == 0)
+                {
+                    continue;
+                }
+
+                long delta = isAdded ? data.Size : -data.Size;
+                _historySizeByFormat[data.Format] = _historySizeByFormat.GetValueOrDefault(data.Format) + delta;
+                HistorySize += delta;
+
+                if (clip.Owner is not null)
+                {
+                    clip.Owner.DataSize += delta;
+                }
+            }
+        }
+
+        private static bool IsCleanable(ClipModel clip, bool deleteFavoriteClips)
+        {
+            return (deleteFavoriteClips || !clip.IsFavorite) && clip.Tags.All(tag => tag.IsCleaningEnabled);
+        }
+
+        private int GetCleanableCount(bool deleteFavoriteClips)
+        {
+            if (_cleanableCount is null || _cleanableCountIncludesFavorites != deleteFavoriteClips)
+            {
+                _cleanableCount = Clips.Count(clip => IsCleanable(clip, deleteFavoriteClips));
+                _cleanableCountIncludesFavorites = deleteFavoriteClips;
+                _protectedTailCount = 0;
+            }
+
+            return _cleanableCount.Value;
+        }
+
+        /// <summary>
+        /// Call with false before a clip is removed, moved or changed, and with true after it's added or changed
+        /// </summary>
+        private void UpdateCleanupState(ClipModel clip, bool isAdded)
+        {
+            if (IsCleanable(clip, _cleanableCountIncludesFavorites))
+            {
+                _cleanableCount += isAdded ? 1 : -1;
+            }
+            else if (!isAdded)
+            {
+                _protectedTailCount = 0;   // It may have been one of the protected clips at the old end
+            }
+        }
+
+        private void InvalidateCleanupState()
+        {
+            _cleanableCount = null;
+            _protectedTailCount = 0;
+        }
+
         private static void ShowToolTipMessage(ClipModel clip)
         {
             string iconGlyph = string.Empty;
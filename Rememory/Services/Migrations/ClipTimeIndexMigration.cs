@@ -0,0 +1,39 @@
+﻿using Microsoft.Data.Sqlite;
+
+namespace Rememory.Services.Migrations
+{
+    /// <summary>
+    /// Creates index on Clips.ClipTime, so the startup load reads clips in order without sorting
+    /// App version 1.4.0
+    /// </summary>
+    public class ClipTimeIndexMigration : ISqliteMigration
+    {
+        public int Version => 6;
+
+        public void Up(SqliteConnection connection)
+        {
+            using var upCommand = connection.CreateCommand();
+            upCommand.CommandText = @"
+            BEGIN TRANSACTION;
+
+            CREATE INDEX IF NOT EXISTS IX_Clips_ClipTime ON Clips (ClipTime);
+
+            COMMIT;
+            ";
+            upCommand.ExecuteNonQuery();
+        }
+
+        public void Down(SqliteConnection connection)
+        {
+            using var downCommand = connection.CreateCommand();
+            downCommand.CommandText = @"
+            BEGIN TRANSACTION;
+
+            DROP INDEX IF EXISTS IX_Clips_ClipTime;
+
+            COMMIT;
+            ";
+            downCommand.ExecuteNonQuery();
+        }
+    }
+}
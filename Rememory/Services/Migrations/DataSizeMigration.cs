@@ -0,0 +1,40 @@
+﻿using Microsoft.Data.Sqlite;
+
+namespace Rememory.Services.Migrations
+{
+    /// <summary>
+    /// Adds Size column to Data table, existing file rows are filled in on the next load
+    /// App version 1.4.0
+    /// </summary>
+    public class DataSizeMigration : ISqliteMigration
+    {
+        public int Version => 7;
+
+        public void Up(SqliteConnection connection)
+        {
+            using var upCommand = connection.CreateCommand();
+            upCommand.CommandText = @"
+            BEGIN TRANSACTION;
+
+            ALTER TABLE Data ADD COLUMN Size INTEGER;
+
+            COMMIT;
+            ";
+            upCommand.ExecuteNonQuery();
+        }
+
+        public void Down(SqliteConnection connection)
+        {
+            using var downCommand = connection.CreateCommand();
+            downCommand.CommandText = @"
+            BEGIN TRANSACTION;
+
+            ALTER TABLE Data DROP COLUMN Size;
+
+            COMMIT;
+            VACUUM;
+            ";
+            downCommand.ExecuteNonQuery();
+        }
+    }
+}
@@ -0,0 +1,40 @@
+﻿using Microsoft.Data.Sqlite;
+
+namespace Rememory.Services.Migrations
+{
+    /// <summary>
+    /// Adds TotalSize column to FilesMetadata table
+    /// App version 1.4.0
+    /// </summary>
+    public class FilesTotalSizeMigration : ISqliteMigration
+    {
+        public int Version => 8;
+
+        public void Up(SqliteConnection connection)
+        {
+            using var upCommand = connection.CreateCommand();
+            upCommand.CommandText = @"
+            BEGIN TRANSACTION;
+
+            ALTER TABLE FilesMetadata ADD COLUMN TotalSize INTEGER;
+
+            COMMIT;
+            ";
+            upCommand.ExecuteNonQuery();
+        }
+
+        public void Down(SqliteConnection connection)
+        {
+            using var downCommand = connection.CreateCommand();
+            downCommand.CommandText = @"
+            BEGIN TRANSACTION;
+
+            ALTER TABLE FilesMetadata DROP COLUMN TotalSize;
+
+            COMMIT;
+            VACUUM;
+            ";
+            downCommand.ExecuteNonQuery();
+        }
+    }
+}
@@ -0,0 +1,40 @@
+﻿using Microsoft.Data.Sqlite;
+
+namespace Rememory.Services.Migrations
+{
+    /// <summary>
+    /// Adds PlainText column to Data table
+    /// App version 1.4.0
+    /// </summary>
+    public class PlainTextMigration : ISqliteMigration
+    {
+        public int Version => 5;
+
+        public void Up(SqliteConnection connection)
+        {
+            using var upCommand = connection.CreateCommand();
+            upCommand.CommandText = @"
+            BEGIN TRANSACTION;
+
+            ALTER TABLE Data ADD COLUMN PlainText TEXT;
+
+            COMMIT;
+            ";
+            upCommand.ExecuteNonQuery();
+        }
+
+        public void Down(SqliteConnection connection)
+        {
+            using var downCommand = connection.CreateCommand();
+            downCommand.CommandText = @"
+            BEGIN TRANSACTION;
+
+            ALTER TABLE Data DROP COLUMN PlainText;
+
+            COMMIT;
+            VACUUM;
+            ";
+            downCommand.ExecuteNonQuery();
+        }
+    }
+}
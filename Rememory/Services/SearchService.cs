@@ -12,8 +12,12 @@ namespace Rememory.Services
 {
     public class SearchService : ISearchService
     {
+        // Only the best matches are shown, ranking the whole history is cheap but showing it is not
+        private const uint MaxResultCount = 1000;
+
         private CancellationTokenSource? _cancellationTokenSource;
         private string? _lastSearchString;
+        private bool _wasTruncated;
 
         public void StartSearch(IEnumerable<ClipModel> items, string searchString, ObservableCollection<ClipModel> foundItems)
         {
@@ -34,58 +38,120 @@ namespace Rememory.Services
             {
                 await Task.Delay(300, cancellationToken);
 
-                // used to search in already filtered items
+                if (TryParseRegex(searchString, out var pattern, out var ignoreCase))
+                {
+                    await SearchRegexAsync(items, pattern, ignoreCase, foundItems, cancellationToken);
+                    _lastSearchString = null;
+                    return;
+                }
+
+                // used to search in already filtered items, unless some matches were left out of them
                 bool useLocalSearch = !string.IsNullOrWhiteSpace(_lastSearchString)
+                    && !_wasTruncated
                     && searchString.Length > _lastSearchString.Length
                     && searchString.Contains(_lastSearchString, StringComparison.OrdinalIgnoreCase);
 
-                var contextToSearch = useLocalSearch ? foundItems : items;
+                var contextToSearch = (useLocalSearch ? foundItems : items).ToList();
+                var matcher = new FuzzyMatcher(searchString);
+                var texts = contextToSearch.Select(item => GetSearchableText(item, matcher) ?? string.Empty).ToList();
 
-                var matches = new List<ClipModel>();
-                var matchesIds = new HashSet<int>();
+                cancellationToken.ThrowIfCancellationRequested();
 
-                foreach (var item in contextToSearch)
-                {
-                    cancellationToken.ThrowIfCancellationRequested();
+                // Ranked best first, the way fzf ranks its results
+                var indices = await matcher.FindBestAsync(texts, MaxResultCount).AsTask(cancellationToken);
+                var matches = indices.Select(index => contextToSearch[index]).ToList();
 
-                    if ((item.Data.TryGetValue(ClipboardFormat.Text, out var dataModel) || item.Data.TryGetValue(ClipboardFormat.Files, out dataModel))
-                        && dataModel.Data.Contains(searchString, StringComparison.OrdinalIgnoreCase))
-                    {
-                        if (useLocalSearch)
-                        {
-                            matchesIds.Add(item.Id);
-                        }
-                        else
-                        {
-                            matches.Add(item);
-                        }
-                    }
-                }
+                cancellationToken.ThrowIfCancellationRequested();
 
                 App.Current.DispatcherQueue.TryEnqueue(() =>
                 {
-                    if (useLocalSearch)
+                    foundItems.Clear();
+                    foreach (var match in matches)
                     {
-                        // remove items no longer matching
-                        var itemsToRemove = foundItems.Where(oldItem => !matchesIds.Contains(oldItem.Id)).ToList();
-                        foreach (var item in itemsToRemove)
-                        {
-                            foundItems.Remove(item);
-                        }
-                    }
-                    else
-                    {
-                        foundItems.Clear();
-                        foreach (var match in matches)
-                        {
-                            foundItems.Add(match);
-                        }
+                        foundItems.Add(match);
                     }
                 });
 
                 _lastSearchString = searchString;
+                _wasTruncated = matches.Count == MaxResultCount;
             }
             catch (OperationCanceledException) { }
         }
+
+        private async Task SearchRegexAsync(IEnumerable<ClipModel> items, string pattern, bool ignoreCase, ObservableCollection<ClipModel> foundItems, CancellationToken cancellationToken)
+        {
+            // A refined pattern can match clips the previous one didn't, so the whole history is searched every time
+            var contextToSearch = items.ToList();
+            var texts = contextToSearch.Select(item => GetSearchableText(item) ?? string.Empty).ToList();
+
+            // Invalid patterns find nothing
+            var matches = new List<ClipModel>();
+            if (RegexMatcher.TryCreate(pattern, ignoreCase) is RegexMatcher matcher)
+            {
+                var indices = await matcher.FindMatchesAsync(texts, MaxResultCount).AsTask(cancellationToken);
+                matches = indices.Select(index => contextToSearch[index]).ToList();
+            }
+
+            cancellationToken.ThrowIfCancellationRequested();
+
+            App.Current.DispatcherQueue.TryEnqueue(() =>
+            {
+                foundItems.Clear();
+                foreach (var match in matches)
+                {
+                    foundItems.Add(match);
+                }
+            });
+        }
+
+        /// <summary>
+        /// Ranges of the text matched by the search string, the same way the search matches clips
+        /// </summary>
+        public static IReadOnlyList<MatchSpan> GetMatchSpans(string searchString, string text)
+        {
+            if (TryParseRegex(searchString, out var pattern, out var ignoreCase))
+            {
+                return RegexMatcher.TryCreate(pattern, ignoreCase)?.GetMatchSpans(text) ?? [];
+            }
+
+            return new FuzzyMatcher(searchString).GetMatchSpans(text);
+        }
+
+        /// <summary>
+        /// "/pattern/" searches with a regular expression, "/pattern/i" ignores case
+        /// </summary>
+        internal static bool TryParseRegex(string searchString, out string pattern, out bool ignoreCase)
+        {
+            ignoreCase = searchString.EndsWith("/i", StringComparison.Ordinal);
+            int end = searchString.Length - (ignoreCase ? 2 : 1);
+
+            if (searchString.Length >= 2 && end > 0 && searchString[0] == '/' && searchString[end] == '/')
+            {
+                pattern = searchString[1..end];
+                return pattern.Length > 0;
+            }
+
+            pattern = string.Empty;
+            return false;
+        }
+
+        /// <summary>
+        /// Text a clip is searched by. With a matcher, compressed texts that can't match are left out without being decompressed
+        /// </summary>
+        internal static string? GetSearchableText(ClipModel item, FuzzyMatcher? matcher = null)
+        {
+            if (item.Data.TryGetValue(ClipboardFormat.Text, out var dataModel) || item.Data.TryGetValue(ClipboardFormat.Files, out dataModel))
+            {
+                return matcher is null ? dataModel.Data : dataModel.GetDataToMatch(matcher);
+            }
+
+            // Rich-only clips are searched by the text extracted at capture time
+            if (item.Data.TryGetValue(ClipboardFormat.Html, out dataModel) || item.Data.TryGetValue(ClipboardFormat.Rtf, out dataModel))
+            {
+                return matcher is null ? dataModel.PlainText : dataModel.GetPlainTextToMatch(matcher);
+            }
+
+            return null;
+        }
     }
 }
@@ -6,9 +6,11 @@ using Rememory.Models;
 using Rememory.Models.Metadata;
 using Rememory.Services.Migrations;
 using System;
+using System.Collections.Concurrent;
 using System.Collections.Generic;
 using System.IO;
 using System.Linq;
+using System.Runtime.InteropServices.WindowsRuntime;
 using System.Threading.Tasks;
 
 namespace Rememory.Services
@@ -26,9 +28,20 @@ namespace Rememory.Services
         /// </summary>
         private bool _updateModelIds;
         /// <summary>
+        /// Stores text sealed while history encryption is on. Backups are always readable on other machines.
+        /// </summary>
+        private bool _sealsText;
+        /// <summary>
         /// Used for backup to avoid opening new connection each time
         /// </summary>
         private SqliteConnection? _cachedConnection;
+        /// <summary>
+        /// Set once the database is in WAL mode, only then are commits made without waiting for the disk
+        /// </summary>
+        private bool _isWriteAheadLogEnabled;
+
+        private static readonly ConcurrentDictionary<string, ClipboardFormat> _formatNameCache = new();
+        private static readonly ConcurrentDictionary<string, MetadataFormat?> _metadataFormatCache = new();
 
         private SqliteService(string connectionString, bool cacheConnections)
         {
@@ -54,9 +67,11 @@ namespace Rememory.Services
             var service = new SqliteService($"Data Source={path}", false)
             {
                 _updateModelIds = true,
+                _sealsText = true,
                 _historyFolderPath = historyFolder
             };
             service.InitializeDatabase();
+            service.EnableWriteAheadLog();
             return service;
         }
 
@@ -65,6 +80,7 @@ namespace Rememory.Services
             var service = new SqliteService($"Data Source={tempFilePath};Pooling=false", true)
             {
                 _updateModelIds = false,
+                _sealsText = false,
                 _historyFolderPath = historyFolder
             };
             service.InitializeDatabase();
@@ -182,59 +198,146 @@ namespace Rememory.Services
                 .GroupBy(pair => pair.Item1)
                 .ToDictionary(group => group.Key, group => group.Select(pair => pair.Item2).ToList());
 
+            // Metadata tables are read once up front instead of a query per data row
+            Dictionary<int, LinkMetadataModel> linkMetadataDictionary = GetLinkMetadata(connection);
+            Dictionary<int, (int FilesCount, int FoldersCount, long? TotalSize)> filesMetadataDictionary = GetFilesMetadata(connection);
+
+            // Clips with all their data in one pass; rows of a clip are adjacent thanks to the ordering
             using var command = connection.CreateCommand();
             command.CommandText = @"
             SELECT
-              Id,
-              ClipTime,
-              IsFavorite,
-              OwnerId
+              c.Id,
+              c.ClipTime,
+              c.IsFavorite,
+              c.OwnerId,
+              d.Id,
+              d.Format,
+              d.Data,
+              d.Hash,
+              d.MetadataFormat,
+              d.PlainText,
+              d.Size
             FROM
-              Clips
+              Clips c
+              LEFT JOIN Data d ON d.ClipId = c.Id
             ORDER BY
-              ClipTime DESC;
+              c.ClipTime DESC,
+              c.Id DESC;
             ";
 
             using var reader = command.ExecuteReader();
+            ClipModel? clip = null;
+            bool isClipReadable = true;
+            List<DataModel> dataWithoutSize = [];
+
             while (reader.Read())
             {
                 int id = reader.GetInt32(0);
-                DateTime clipTime = reader.GetDateTime(1);
-                bool isFavorite = reader.GetBoolean(2);
-                int? ownerId = reader.IsDBNull(3) ? null : reader.GetInt32(3);
 
-                ClipModel clip = new()
+                if (clip is null || clip.Id != id)
                 {
-                    Id = id,
-                    ClipTime = clipTime,
-                    IsFavorite = isFavorite,
-                    // Using 0 for the empty owner
-                    Owner = ownersDictionary.TryGetValue(ownerId ?? 0, out var owner) ? owner : ownersDictionary[0],
-                    Data = GetDataByClipId(id, connection).ToDictionary(d => d.Format),
-                    Tags = clipTagsDictionary.TryGetValue(id, out var tagIds) ? [.. tagIds.Where(tagsDictionary.ContainsKey).Select(id => tagsDictionary[id])] : []
-                };
+                    if (clip is not null && isClipReadable)
+                    {
+                        yield return CompleteLoadedClip(clip);
+                    }
+
+                    isClipReadable = true;
 
-                foreach (var tag in clip.Tags)
+                    DateTime clipTime = reader.GetDateTime(1);
+                    bool isFavorite = reader.GetBoolean(2);
+                    int? ownerId = reader.IsDBNull(3) ? null : reader.GetInt32(3);
+
+                    clip = new()
+                    {
+                        Id = id,
+                        ClipTime = clipTime,
+                        IsFavorite = isFavorite,
+                        // Using 0 for the empty owner
+                        Owner = ownersDictionary.TryGetValue(ownerId ?? 0, out var owner) ? owner : ownersDictionary[0],
+                        Tags = clipTagsDictionary.TryGetValue(id, out var tagIds) ? [.. tagIds.Where(tagsDictionary.ContainsKey).Select(id => tagsDictionary[id])] : []
+                    };
+                }
+
+                if (reader.IsDBNull(4) || !isClipReadable)
                 {
-                    tag.Clips.Add(clip);
+                    continue;   // Clip without data, or already left out
                 }
 
-                if (clip.Owner is not null)
+                int dataId = reader.GetInt32(4);
+                ClipboardFormat format = GetCachedFormat(reader.GetString(5));
+                byte[] hash = (byte[])reader.GetValue(7);
+                MetadataFormat? metadataFormat = reader.IsDBNull(8) ? null : GetCachedMetadataFormat(reader.GetString(8));
+                long? size = reader.IsDBNull(10) ? null : reader.GetInt64(10);
+
+                // A clip missing some of its data would paste something other than what was copied, so it's left out whole.
+                // It stays in the database in case the key comes back, and the Performance diagnostics count it
+                string? plainText = null;
+                if (!TryReadText(reader, 6, out string data) || (!reader.IsDBNull(9) && !TryReadText(reader, 9, out plainText)))
                 {
-                    clip.Owner.ClipsCount++;
+                    isClipReadable = false;
+                    continue;
                 }
 
-                if (clip.Data.TryGetValue(ClipboardFormat.Text, out var textData))
+                if (string.IsNullOrEmpty(data))
                 {
-                    clip.IsLink = Uri.TryCreate(textData.Data, UriKind.Absolute, out var uri)
-                        && (uri.Scheme == Uri.UriSchemeHttp || uri.Scheme == Uri.UriSchemeHttps);
+                    continue;
                 }
-                yield return clip;
+
+                IMetadata? metadataModel = metadataFormat switch
+                {
+                    MetadataFormat.Link => linkMetadataDictionary.GetValueOrDefault(dataId),
+                    MetadataFormat.Color => new ColorMetadataModel(),
+                    MetadataFormat.Files => filesMetadataDictionary.TryGetValue(dataId, out var counts) ? CreateFilesMetadata(counts, data) : null,
+                    _ => null
+                };
+
+                if (ClipboardFormatHelper.CanFormatBeFile(format))
+                {
+                    data = ClipboardFormatHelper.ConvertFileNameToFullPath(data, format, _historyFolderPath);
+                }
+
+                var dataModel = new DataModel(format, data, hash) { Id = dataId, Metadata = metadataModel, PlainText = plainText, Size = size ?? 0 };
+                clip.Data.TryAdd(format, dataModel);
+
+                // Files saved before sizes were tracked are measured once
+                if (size is null && dataModel.IsFile())
+                {
+                    dataModel.UpdateFileSize();
+                    dataWithoutSize.Add(dataModel);
+                }
+            }
+
+            if (clip is not null && isClipReadable)
+            {
+                yield return CompleteLoadedClip(clip);
             }
 
+            reader.Close();
+            UpdateDataSizes(dataWithoutSize, connection);
+
             TryDisposeConnection(connection);
         }
 
+        private static ClipModel CompleteLoadedClip(ClipModel clip)
+        {
+            foreach (var tag in clip.Tags)
+            {
+                tag.Clips.Add(clip);
+            }
+
+            if (clip.Owner is not null)
+            {
+                clip.Owner.ClipsCount++;
+            }
+
+            if (clip.Data.TryGetValue(ClipboardFormat.Text, out var textData))
+            {
+                clip.IsLink = textData.IsWebLink();
+            }
+
+            return clip;
+        }
+
         public int AddClip(ClipModel clip, int? ownerId)
         {
             var connection = CreateOpenedConnection();
@@ -253,16 +356,31 @@ namespace Rememory.Services
             command.Parameters.AddWithValue("isFavorite", clip.IsFavorite);
             command.Parameters.AddWithValue("ownerId", ownerId ?? (object)DBNull.Value);
 
-            var id = Convert.ToInt32(command.ExecuteScalar());
+            // The clip, its data and metadata are committed together, with a single sync per clip
+            ExecuteNonQuery(connection, "BEGIN IMMEDIATE;");
+            int id;
 
-            if (_updateModelIds)
+            try
             {
-                clip.Id = id;
+                id = Convert.ToInt32(command.ExecuteScalar());
+
+                if (clip.Data is not null)
+                {
+                    AddData(id, clip.Data.Values, connection);
+                }
+
+                ExecuteNonQuery(connection, "COMMIT;");
+            }
+            catch
+            {
+                ExecuteNonQuery(connection, "ROLLBACK;");
+                TryDisposeConnection(connection);
+                throw;
             }
 
-            if (clip.Data is not null)
+            if (_updateModelIds)
             {
-                AddData(id, clip.Data.Values, connection);
+                clip.Id = id;
             }
 
             TryDisposeConnection(connection);
@@ -309,81 +427,37 @@ namespace Rememory.Services
             TryDisposeConnection(connection);
         }
 
-        public void DeleteOldClipsByTime(DateTime cutoffTime, bool deleteFavoriteClips)
+        public void DeleteClips(IEnumerable<int> ids)
         {
             var connection = CreateOpenedConnection();
             using var command = connection.CreateCommand();
             command.CommandText = @"
             DELETE FROM Clips
             WHERE
-              ClipTime < @cutoffTime
-              AND (
-                @deleteFavoriteClips
-                OR NOT IsFavorite
-              )
-              AND Id NOT IN (
-                SELECT
-                  c.Id
-                FROM
-                  Clips c
-                  JOIN ClipTags ct ON ct.ClipId = c.Id
-                  JOIN Tags t ON t.Id = ct.TagId
-                GROUP BY
-                  c.Id
-                HAVING
-                  COUNT(*) != SUM(t.IsCleaningEnabled)
-              );
-
-            VACUUM;
+              Id = @id;
             ";
 
-            command.Parameters.AddWithValue("cutoffTime", cutoffTime);
-            command.Parameters.AddWithValue("deleteFavoriteClips", deleteFavoriteClips);
-            command.ExecuteNonQuery();
+            var idParameter = command.Parameters.Add("id", SqliteType.Integer);
 
-            TryDisposeConnection(connection);
-        }
+            // One prepared statement and one commit for the whole batch
+            ExecuteNonQuery(connection, "BEGIN IMMEDIATE;");
 
-        public void DeleteOldClipsByQuantity(int quantity, bool deleteFavoriteClips)
-        {
-            var connection = CreateOpenedConnection();
-            using var command = connection.CreateCommand();
-            command.CommandText = @"
-            DELETE FROM Clips
-            WHERE
-              (
-                @deleteFavoriteClips
-                OR NOT IsFavorite
-              )
-              AND Id NOT IN (
-                SELECT
-                  c.Id
-                FROM
-                  Clips c
-                  JOIN ClipTags ct ON ct.ClipId = c.Id
-                  JOIN Tags t ON t.Id = ct.TagId
-                GROUP BY
-                  c.Id
-                HAVING
-                  COUNT(*) != SUM(t.IsCleaningEnabled)
-              )
-              AND Id NOT IN (
-                SELECT
-                  Id
-                FROM
-                  Clips
-                ORDER BY
-                  ClipTime DESC
-                LIMIT
-                  @quantity
-              );
-
-            VACUUM;
-            ";
+            try
+            {
+                foreach (var id in ids)
+                {
+                    idParameter.Value = id;
+                    command.ExecuteNonQuery();
+                }
 
-            command.Parameters.AddWithValue("deleteFavoriteClips", deleteFavoriteClips);
-            command.Parameters.AddWithValue("quantity", quantity);
-            command.ExecuteNonQuery();
+                ExecuteNonQuery(connection, "COMMIT;");
+            }
+            catch
+            {
+                ExecuteNonQuery(connection, "ROLLBACK;");
+                TryDisposeConnection(connection);
+                throw;
+            }
 
             TryDisposeConnection(connection);
         }
@@ -541,6 +615,12 @@ namespace Rememory.Services
         public void AddLinkMetadata(LinkMetadataModel linkMetadata, int dataId)
         {
             var connection = CreateOpenedConnection();
+            AddLinkMetadata(linkMetadata, dataId, connection);
+            TryDisposeConnection(connection);
+        }
+
+        private void AddLinkMetadata(LinkMetadataModel linkMetadata, int dataId, SqliteConnection connection)
+        {
             using var command = connection.CreateCommand();
             command.CommandText = @"
             INSERT INTO
@@ -556,19 +636,24 @@ namespace Rememory.Services
             ";
 
             command.Parameters.AddWithValue("id", dataId);
-            command.Parameters.AddWithValue("url", linkMetadata.Url ?? (object)DBNull.Value);
-            command.Parameters.AddWithValue("title", linkMetadata.Title ?? (object)DBNull.Value);
-            command.Parameters.AddWithValue("description", linkMetadata.Description ?? (object)DBNull.Value);
-            command.Parameters.AddWithValue("image", linkMetadata.Image ?? (object)DBNull.Value);
+            // Sealed like the link they describe
+            command.Parameters.AddWithValue("url", linkMetadata.Url is null ? DBNull.Value : SealText(linkMetadata.Url));
+            command.Parameters.AddWithValue("title", linkMetadata.Title is null ? DBNull.Value : SealText(linkMetadata.Title));
+            command.Parameters.AddWithValue("description", linkMetadata.Description is null ? DBNull.Value : SealText(linkMetadata.Description));
+            command.Parameters.AddWithValue("image", linkMetadata.Image is null ? DBNull.Value : SealText(linkMetadata.Image));
             command.Parameters.AddWithValue("metadataFormat", linkMetadata.Format.GetDescription());
             command.ExecuteNonQuery();
-
-            TryDisposeConnection(connection);
         }
 
         public void AddColorMetadata(ColorMetadataModel colorMetadata, int dataId)
         {
             var connection = CreateOpenedConnection();
+            AddColorMetadata(colorMetadata, dataId, connection);
+            TryDisposeConnection(connection);
+        }
+
+        private static void AddColorMetadata(ColorMetadataModel colorMetadata, int dataId, SqliteConnection connection)
+        {
             using var command = connection.CreateCommand();
             command.CommandText = @"
             UPDATE Data
@@ -581,19 +666,23 @@ namespace Rememory.Services
             command.Parameters.AddWithValue("id", dataId);
             command.Parameters.AddWithValue("metadataFormat", colorMetadata.Format.GetDescription());
             command.ExecuteNonQuery();
-
-            TryDisposeConnection(connection);
         }
 
         public void AddFilesMetadata(FilesMetadataModel filesMetadata, int dataId)
         {
             var connection = CreateOpenedConnection();
+            AddFilesMetadata(filesMetadata, dataId, connection);
+            TryDisposeConnection(connection);
+        }
+
+        private static void AddFilesMetadata(FilesMetadataModel filesMetadata, int dataId, SqliteConnection connection)
+        {
             using var command = connection.CreateCommand();
             command.CommandText = @"
-            INSERT INTO
-              FilesMetadata (Id, FilesCount, FoldersCount)
+            INSERT OR REPLACE INTO
+              FilesMetadata (Id, FilesCount, FoldersCount, TotalSize)
             VALUES
-              (@id, @filesCount, @foldersCout);
+              (@id, @filesCount, @foldersCout, @totalSize);
 
             UPDATE Data
             SET
@@ -605,10 +694,9 @@ namespace Rememory.Services
             command.Parameters.AddWithValue("id", dataId);
             command.Parameters.AddWithValue("filesCount", filesMetadata.FilesCount);
             command.Parameters.AddWithValue("foldersCout", filesMetadata.FoldersCount);
+            command.Parameters.AddWithValue("totalSize", filesMetadata.TotalSize ?? (object)DBNull.Value);
             command.Parameters.AddWithValue("metadataFormat", filesMetadata.Format.GetDescription());
             command.ExecuteNonQuery();
-
-            TryDisposeConnection(connection);
         }
 
         #endregion
@@ -678,46 +766,50 @@ namespace Rememory.Services
             });
         }
 
-        private IEnumerable<DataModel> GetDataByClipId(int clipId, SqliteConnection connection)
+        /// <summary>
+        /// Format names repeat on every data row, so each distinct name is resolved through FormatManager only once
+        /// </summary>
+        private static ClipboardFormat GetCachedFormat(string formatName) =>
+            _formatNameCache.GetOrAdd(formatName, name => FormatManager.FormatFromName(name));
+
+        private static MetadataFormat? GetCachedMetadataFormat(string description) =>
+            _metadataFormatCache.GetOrAdd(description, name => EnumExtensions.FromDescription<MetadataFormat>(name));
+
+        private static void UpdateDataSizes(List<DataModel> dataCollection, SqliteConnection connection)
         {
+            if (dataCollection.Count == 0)
+            {
+                return;
+            }
+
             using var command = connection.CreateCommand();
             command.CommandText = @"
-            SELECT
-              Id,
-              Format,
-              Data,
-              Hash,
-              MetadataFormat
-            FROM
-              Data
+            UPDATE Data
+            SET
+              Size = @size
             WHERE
-              ClipId = @clipId;
+              Id = @id;
             ";
+            var sizeParameter = command.Parameters.Add("size", SqliteType.Integer);
+            var idParameter = command.Parameters.Add("id", SqliteType.Integer);
 
-            command.Parameters.AddWithValue("clipId", clipId);
-            using var reader = command.ExecuteReader();
-            while (reader.Read())
-            {
-                int id = reader.GetInt32(0);
-                ClipboardFormat format = FormatManager.FormatFromName(reader.GetString(1));
-                string data = reader.GetString(2);
-                byte[] hash = (byte[])reader.GetValue(3);
-                MetadataFormat? metadataFormat = reader.IsDBNull(4) ? null : EnumExtensions.FromDescription<MetadataFormat>(reader.GetString(4));
+            ExecuteNonQuery(connection, "BEGIN IMMEDIATE;");
 
-                IMetadata? metadataModel = metadataFormat switch
-                {
-                    MetadataFormat.Link => GetLinkMetadataById(id, connection),
-                    MetadataFormat.Color => new ColorMetadataModel(),
-                    MetadataFormat.Files => GetFilesMetadataById(id, data, connection),
-                    _ => null
-                };
-
-                if (ClipboardFormatHelper.CanFormatBeFile(format))
+            try
+            {
+                foreach (var data in dataCollection)
                 {
-                    data = ClipboardFormatHelper.ConvertFileNameToFullPath(data, format, _historyFolderPath);
+                    sizeParameter.Value = data.Size;
+                    idParameter.Value = data.Id;
+                    command.ExecuteNonQuery();
                 }
 
-                yield return new DataModel(format, data, hash) { Id = id, Metadata = metadataModel };
+                ExecuteNonQuery(connection, "COMMIT;");
+            }
+            catch
+            {
+                ExecuteNonQuery(connection, "ROLLBACK;");
+                throw;
             }
         }
 
@@ -726,9 +818,9 @@ namespace Rememory.Services
             using var command = connection.CreateCommand();
             command.CommandText = @"
             INSERT INTO
-              Data (ClipId, Format, Data, Hash)
+              Data (ClipId, Format, Data, Hash, PlainText, Size)
             VALUES
-              (@clipId, @format, @data, @hash);
+              (@clipId, @format, @data, @hash, @plainText, @size);
             SELECT
               last_insert_rowid();
             ";
@@ -738,14 +830,21 @@ namespace Rememory.Services
             dataParameter.ParameterName = "data";
             var hashParameter = command.CreateParameter();
             hashParameter.ParameterName = "hash";
+            var plainTextParameter = command.CreateParameter();
+            plainTextParameter.ParameterName = "plainText";
+            var sizeParameter = command.CreateParameter();
+            sizeParameter.ParameterName = "size";
             command.Parameters.AddWithValue("clipId", clipId);
-            command.Parameters.AddRange([formatParameter, dataParameter, hashParameter]);
+            command.Parameters.AddRange([formatParameter, dataParameter, hashParameter, plainTextParameter, sizeParameter]);
 
             foreach (var data in dataCollection)
             {
                 formatParameter.Value = FormatManager.FormatToName(data.Format);
-                dataParameter.Value = data.IsFile() ? ClipboardFormatHelper.ConvertFullPathToFileName(data.Data) : data.Data;
+                dataParameter.Value = data.IsFile() ? ClipboardFormatHelper.ConvertFullPathToFileName(data.Data) : SealText(data.Data);
                 hashParameter.Value = data.Hash;
+                plainTextParameter.Value = data.PlainText is null ? DBNull.Value : SealText(data.PlainText);
+                // Unknown file size is left empty and measured on the next load
+                sizeParameter.Value = data.IsFile() && data.Size == 0 ? DBNull.Value : (object)data.Size;
 
                 var id = Convert.ToInt32(command.ExecuteScalar());
 
@@ -757,18 +856,46 @@ namespace Rememory.Services
                 switch (data.Metadata)
                 {
                     case LinkMetadataModel linkMetadata:
-                        AddLinkMetadata(linkMetadata, id);
+                        AddLinkMetadata(linkMetadata, id, connection);
                         break;
                     case ColorMetadataModel colorMetadata:
-                        AddColorMetadata(colorMetadata, id);
+                        AddColorMetadata(colorMetadata, id, connection);
                         break;
                     case FilesMetadataModel filesMetadata:
-                        AddFilesMetadata(filesMetadata, id);
+                        AddFilesMetadata(filesMetadata, id, connection);
                         break;
                 }
             }
         }
 
+        /// <summary>
+        /// Sealed text is stored as a blob, plain text as a string. Empty text stays a string, since opening it couldn't be told from a failure
+        /// </summary>
+        private object SealText(string text)
+        {
+            return (_sealsText && text.Length > 0 ? FormatManager.SealText(text)?.ToArray() : null) ?? (object)text;
+        }
+
+        /// <summary>
+        /// False if the text is sealed and can't be opened
+        /// </summary>
+        private static bool TryReadText(SqliteDataReader reader, int ordinal, out string text)
+        {
+            if (reader.GetValue(ordinal) is byte[] sealedText)
+            {
+                text = FormatManager.OpenSealedText(sealedText.AsBuffer());
+                return text.Length > 0;
+            }
+
+            text = reader.GetString(ordinal);
+            return true;
+        }
+
+        private static string? ReadOptionalText(SqliteDataReader reader, int ordinal)
+        {
+            return !reader.IsDBNull(ordinal) && TryReadText(reader, ordinal, out var text) ? text : null;
+        }
+
         private IEnumerable<(int, int)> GetClipTags(SqliteConnection connection)
         {
             using var command = connection.CreateCommand();
@@ -789,31 +916,32 @@ namespace Rememory.Services
             }
         }
 
-        private LinkMetadataModel? GetLinkMetadataById(int id, SqliteConnection connection)
+        private Dictionary<int, LinkMetadataModel> GetLinkMetadata(SqliteConnection connection)
         {
             using var command = connection.CreateCommand();
             command.CommandText = @"
             SELECT
+              Id,
               Url,
               Title,
               Description,
               Image
             FROM
-              LinkMetadata
-            WHERE
-              Id = @id;
+              LinkMetadata;
             ";
 
-            command.Parameters.AddWithValue("id", id);
+            Dictionary<int, LinkMetadataModel> linkMetadata = [];
             using var reader = command.ExecuteReader();
-            if (reader.Read())
+            while (reader.Read())
             {
-                string? url = reader.IsDBNull(0) ? null : reader.GetString(0);
-                string? title = reader.IsDBNull(1) ? null : reader.GetString(1);
-                string? description = reader.IsDBNull(2) ? null : reader.GetString(2);
-                string? image = reader.IsDBNull(3) ? null : reader.GetString(3);
+                int id = reader.GetInt32(0);
+                // Metadata that can't be opened is left empty, the link itself is still in the clip
+                string? url = ReadOptionalText(reader, 1);
+                string? title = ReadOptionalText(reader, 2);
+                string? description = ReadOptionalText(reader, 3);
+                string? image = ReadOptionalText(reader, 4);
 
-                return new LinkMetadataModel()
+                linkMetadata[id] = new LinkMetadataModel()
                 {
                     Url = url,
                     Title = title,
@@ -821,38 +949,57 @@ namespace Rememory.Services
                     Image = image
                 };
             }
-            return null;
+            return linkMetadata;
         }
 
-        private FilesMetadataModel? GetFilesMetadataById(int id, string paths, SqliteConnection connection)
+        private Dictionary<int, (int FilesCount, int FoldersCount, long? TotalSize)> GetFilesMetadata(SqliteConnection connection)
         {
             using var command = connection.CreateCommand();
             command.CommandText = @"
             SELECT
+              Id,
               FilesCount,
-              FoldersCount
+              FoldersCount,
+              TotalSize
             FROM
-              FilesMetadata
-            WHERE
-              Id = @id;
+              FilesMetadata;
             ";
 
-            command.Parameters.AddWithValue("id", id);
+            Dictionary<int, (int, int, long?)> filesMetadata = [];
             using var reader = command.ExecuteReader();
-            if (reader.Read())
+            while (reader.Read())
+            {
+                filesMetadata[reader.GetInt32(0)] = (reader.GetInt32(1), reader.GetInt32(2), reader.IsDBNull(3) ? null : reader.GetInt64(3));
+            }
+            return filesMetadata;
+        }
+
+        private static FilesMetadataModel CreateFilesMetadata((int FilesCount, int FoldersCount, long? TotalSize) counts, string paths)
+        {
+            var metadata = new FilesMetadataModel()
             {
-                int filesCount = reader.GetInt32(0);
-                int foldersCount = reader.GetInt32(1);
+                FilesCount = counts.FilesCount,
+                FoldersCount = counts.FoldersCount,
+                TotalSize = counts.TotalSize
+            };
+            metadata.SetPaths(paths);
+            return metadata;
+        }
 
-                var metadata = new FilesMetadataModel()
-                {
-                    FilesCount = filesCount,
-                    FoldersCount = foldersCount
-                };
-                metadata.SetPaths(paths);
-                return metadata;
+        /// <summary>
+        /// Commits append to the log instead of rewriting database pages, and readers don't block the writer.
+        /// The mode is stored in the database file, backups keep the default journal so they stay a single file.
+        /// </summary>
+        private void EnableWriteAheadLog()
+        {
+            var connection = CreateOpenedConnection();
+            using (var command = connection.CreateCommand())
+            {
+                // Returns the mode in effect, which stays the old one if WAL isn't supported
+                command.CommandText = "PRAGMA journal_mode = WAL;";
+                _isWriteAheadLogEnabled = string.Equals(command.ExecuteScalar() as string, "wal", StringComparison.OrdinalIgnoreCase);
             }
-            return null;
+            TryDisposeConnection(connection);
         }
 
         private void InitializeDatabase()
@@ -872,9 +1019,23 @@ namespace Rememory.Services
 
             var connection = new SqliteConnection(_connectionString);
             connection.Open();
+
+            // Safe with WAL: a crash can lose the last commits but never corrupts the database.
+            // With the rollback journal of backups it could, so they keep the default FULL
+            if (_isWriteAheadLogEnabled)
+            {
+                ExecuteNonQuery(connection, "PRAGMA synchronous = NORMAL;");
+            }
             return connection;
         }
 
+        private static void ExecuteNonQuery(SqliteConnection connection, string commandText)
+        {
+            using var command = connection.CreateCommand();
+            command.CommandText = commandText;
+            command.ExecuteNonQuery();
+        }
+
         private void TryDisposeConnection(SqliteConnection connection)
         {
             if (connection != _cachedConnection)
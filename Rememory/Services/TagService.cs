@@ -10,6 +10,7 @@ namespace Rememory.Services
     {
         public event EventHandler<TagModel>? TagRegistered;
         public event EventHandler<int>? TagUnregistered;
+        public event EventHandler? CleanupProtectionChanged;
 
         public IList<TagModel> Tags { get; private set; }
 
@@ -42,11 +43,13 @@ namespace Rememory.Services
             Tags.Remove(tag);
             _storageService.DeleteTag(tag.Id);
             OnTagUnregistered(tag.Id);
+            OnCleanupProtectionChanged();
         }
 
         public void UpdateTag(TagModel tag)
         {
             _storageService.UpdateTag(tag);
+            OnCleanupProtectionChanged();
         }
 
         public void AddClipToTag(TagModel tag, ClipModel clip)
@@ -58,6 +61,7 @@ namespace Rememory.Services
                 clip.TogglePropertyUpdate(nameof(clip.HasTags));
                 tag.TogglePropertyUpdate(nameof(tag.ClipsCount));
                 _storageService.AddClipTags([(clip.Id, tag.Id)]);
+                OnCleanupProtectionChanged();
             }
         }
 
@@ -68,6 +72,7 @@ namespace Rememory.Services
                 clip.TogglePropertyUpdate(nameof(clip.HasTags));
                 tag.TogglePropertyUpdate(nameof(tag.ClipsCount));
                 _storageService.DeleteClipTag(clip.Id, tag.Id);
+                OnCleanupProtectionChanged();
             }
         }
 
@@ -81,6 +86,11 @@ namespace Rememory.Services
             TagUnregistered?.Invoke(this, tagId);
         }
 
+        protected virtual void OnCleanupProtectionChanged()
+        {
+            CleanupProtectionChanged?.Invoke(this, EventArgs.Empty);
+        }
+
         private IList<TagModel> ReadTagsFromStorage()
         {
             try
@@ -136,7 +136,7 @@ namespace Rememory.ViewModels
                     SettingsContext.IsClipboardMonitoringEnabled = value;
                     if (value)
                     {
-                        _clipboardMonitor.StartMonitoring((ulong)App.Current.ClipboardWindowHandle);
+                        _clipboardMonitor.StartMonitoring();
                     }
                     else
                     {
@@ -234,7 +234,7 @@ namespace Rememory.ViewModels
         {
             if (IsClipboardMonitoringEnabled)
             {
-                _clipboardMonitor.StartMonitoring((ulong)App.Current.ClipboardWindowHandle);
+                _clipboardMonitor.StartMonitoring();
             }
 
             App.Current.ClipboardWindow.Showing += ClipboardWindow_Showing;
@@ -340,6 +340,9 @@ namespace Rememory.ViewModels
         private void ClipboardWindow_Showing(ClipboardWindow sender, EventArgs args)
         {
             _lastActiveWindowHandleBeforeShowing = NativeHelper.GetForegroundWindow();
+
+            // Content copied just before the window was opened is still waiting to be saved
+            _clipboardMonitor.CommitStagedCapture();
         }
 
         #region TagService events
@@ -488,10 +491,8 @@ namespace Rememory.ViewModels
                 {
                     if (dataItem.Value.IsFile() && !clip.IsLink)
                     {
-                        var storageFile = await StorageFile.GetFileFromPathAsync(dataItem.Value.Data)
-                            .AsTask().ConfigureAwait(false);
-                        using var storageStream = await storageFile.OpenReadAsync()
-                            .AsTask().ConfigureAwait(false);
+                        using var storageStream = await ClipboardFormatHelper.OpenHistoryFileAsync(dataItem.Value.Data)
+                            .ConfigureAwait(false);
 
                         switch (dataItem.Key)
                         {
@@ -571,8 +572,8 @@ namespace Rememory.ViewModels
                             }
                             else
                             {
-                                storageItems.Add(await StorageFile.GetFileFromPathAsync(dataItem.Value.Data)
-                                    .AsTask().ConfigureAwait(false));
+                                storageItems.Add(await ClipboardFormatHelper.GetHistoryStorageFileAsync(dataItem.Value.Data)
+                                    .ConfigureAwait(false));
                             }
                         }
                         catch { }
@@ -675,7 +676,7 @@ namespace Rememory.ViewModels
         private void OpenSettingsWindow() => SettingsWindow.ShowSettingsWindow();
 
         [RelayCommand]
-        private void ExitApp() => App.Current.Exit();
+        private void ExitApp() => App.Current.ExitAfterPendingClips();
 
         private bool CanEraseClipsOnSelectedTab() => ShowEraseButton;
 
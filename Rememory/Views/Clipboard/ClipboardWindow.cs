@@ -287,6 +287,8 @@ namespace Rememory.Views.Clipboard
                     break;
 
                 case NativeHelper.WM_ENDSESSION when args.Message.WParam != 0:   // wParam = 1 means the session is ending
+                    // The process can be ended as soon as this returns, so pending clips are saved here rather than awaited
+                    App.Current.SavePendingClips();
                     App.Current.Exit();
                     break;
 
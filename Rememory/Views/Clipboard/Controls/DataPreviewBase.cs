@@ -3,7 +3,7 @@ using Microsoft.UI.Xaml.Controls;
 using Microsoft.UI.Xaml.Documents;
 using Microsoft.UI.Xaml.Media;
 using Rememory.Models;
-using System.Text.RegularExpressions;
+using Rememory.Services;
 using Windows.UI;
 using Windows.UI.ViewManagement;
 
@@ -125,16 +125,15 @@ namespace Rememory.Views.Clipboard.Controls
                 return;
             }
 
-            // Regex to find all matches
-            var regex = new Regex(Regex.Escape(searchText), RegexOptions.IgnoreCase);
-            var matches = regex.Matches(textData ?? textBlock.Text);
+            // Same matching as the search, so every found clip shows why it was found
+            var spans = SearchService.GetMatchSpans(searchText, textData ?? textBlock.Text);
 
             var highlighter = new TextHighlighter();
             highlighter.Background = new SolidColorBrush(HighlightColor);
 
-            foreach (Match match in matches)
+            foreach (var span in spans)
             {
-                highlighter.Ranges.Add(new(match.Index, match.Length));
+                highlighter.Ranges.Add(new(span.Start, span.Length));
             }
 
             textBlock.TextHighlighters.Add(highlighter);
@@ -2,6 +2,8 @@ using Microsoft.UI.Dispatching;
 using Microsoft.UI.Xaml;
 using Microsoft.UI.Xaml.Controls;
 using Microsoft.Web.WebView2.Core;
+using Rememory.Core;
+using Rememory.Helper;
 using Rememory.Models;
 using System;
 using System.Linq;
@@ -18,6 +20,7 @@ namespace Rememory.Views.Clipboard.Controls
         private readonly DispatcherQueueTimer _cleanupTimer;
         private WebView2? _webViewBlock;
         private string _lastAllowedUriToNavigate = string.Empty;
+        private bool _isStringNavigationAllowed = false;
 
         public HtmlPreview()
         {
@@ -51,7 +54,15 @@ namespace Rememory.Views.Clipboard.Controls
                             _webViewBlock.CoreWebView2.NewWindowRequested += WebView_CoreWebView2_NewWindowRequested;
                         }
 
-                        NavigateTo(clipData.Data);
+                        // Encrypted HTML is decrypted in memory only
+                        if (FormatManager.IsHistoryFileSealed(clipData.Data))
+                        {
+                            NavigateToString(ClipboardFormatHelper.ReadHistoryText(clipData.Data));
+                        }
+                        else
+                        {
+                            NavigateTo(clipData.Data);
+                        }
                     }
                     catch { }
                 });
@@ -80,9 +91,17 @@ namespace Rememory.Views.Clipboard.Controls
         {
             var uri = new Uri(uriString);
             _lastAllowedUriToNavigate = uri.AbsoluteUri;
+            _isStringNavigationAllowed = false;
             _webViewBlock?.Source = uri;
         }
 
+        private void NavigateToString(string html)
+        {
+            _lastAllowedUriToNavigate = string.Empty;
+            _isStringNavigationAllowed = true;
+            _webViewBlock?.NavigateToString(html);
+        }
+
         private void CleanupTimer_Tick(DispatcherQueueTimer timer, object e)
         {
             StopCleanupTimer();
@@ -104,9 +123,10 @@ namespace Rememory.Views.Clipboard.Controls
 
         private void WebView_NavigationStarting(WebView2 sender, CoreWebView2NavigationStartingEventArgs args)
         {
-            if (_lastAllowedUriToNavigate == args.Uri)
+            if (_isStringNavigationAllowed || _lastAllowedUriToNavigate == args.Uri)
             {
                 _lastAllowedUriToNavigate = string.Empty;
+                _isStringNavigationAllowed = false;
             }
             else
             {
@@ -1,10 +1,80 @@
+using Microsoft.UI.Xaml;
+using Microsoft.UI.Xaml.Media.Imaging;
+using Rememory.Core;
+using Rememory.Helper;
+using System;
+
 namespace Rememory.Views.Clipboard.Controls
 {
     public sealed partial class ImagePreview : DataPreviewBase
     {
+        private const uint CompactThumbnailSize = 64;
+        private const uint StandardThumbnailSize = 256;
+
         public ImagePreview()
         {
             InitializeComponent();
         }
+
+        protected override void OnClipDataChanged(DependencyPropertyChangedEventArgs args)
+        {
+            base.OnClipDataChanged(args);
+            UpdateImageSource();
+        }
+
+        protected override void OnPreviewVisualStateChanged(DependencyPropertyChangedEventArgs args)
+        {
+            base.OnPreviewVisualStateChanged(args);
+            UpdateImageSource();
+        }
+
+        /// <summary>
+        /// List rows show the thumbnail generated at capture time, only the expanded view decodes the full image
+        /// </summary>
+        private void UpdateImageSource()
+        {
+            if (ClipData is null || string.IsNullOrEmpty(ClipData.Data))
+            {
+                PreviewImage.Source = null;
+                return;
+            }
+
+            string? imagePath = PreviewVisualState switch
+            {
+                DataPreviewVisualState.Compact => ClipData.GetThumbnailPath(CompactThumbnailSize),
+                DataPreviewVisualState.Standard => ClipData.GetThumbnailPath(StandardThumbnailSize),
+                _ => null
+            };
+
+            imagePath ??= ClipData.Data;
+
+            if (FormatManager.IsHistoryFileSealed(imagePath))
+            {
+                SetSealedImageSource(imagePath);
+            }
+            else
+            {
+                PreviewImage.Source = new BitmapImage(new Uri(imagePath));
+            }
+        }
+
+        /// <summary>
+        /// Encrypted images are decoded from memory, the source is skipped if another image was set meanwhile
+        /// </summary>
+        private async void SetSealedImageSource(string imagePath)
+        {
+            var bitmap = new BitmapImage();
+            PreviewImage.Source = bitmap;
+
+            try
+            {
+                using var stream = await ClipboardFormatHelper.OpenHistoryFileAsync(imagePath);
+                if (PreviewImage.Source == bitmap)
+                {
+                    await bitmap.SetSourceAsync(stream);
+                }
+            }
+            catch { }
+        }
     }
 }
@@ -1,8 +1,8 @@
 using Microsoft.UI.Text;
 using Microsoft.UI.Xaml;
+using Rememory.Helper;
 using Rememory.Models;
 using System;
-using System.IO;
 
 namespace Rememory.Views.Clipboard.Controls
 {
@@ -23,7 +23,7 @@ namespace Rememory.Views.Clipboard.Controls
             if (args.NewValue is DataModel clipData)
             {
                 PreviewFormatedTextBox.IsReadOnly = false;
-                string rtf = File.ReadAllText(clipData.Data);
+                string rtf = ClipboardFormatHelper.ReadHistoryText(clipData.Data);
 
                 // Normalize RTF string before preview
                 if (rtf.Length >= RtfLegacyMarker.Length && rtf.AsSpan().StartsWith(RtfLegacyMarker, StringComparison.Ordinal))
@@ -2,8 +2,13 @@ using CommunityToolkit.WinUI.Helpers;
 using Microsoft.UI.Xaml;
 using Microsoft.UI.Xaml.Controls;
 using Microsoft.UI.Xaml.Navigation;
+using Microsoft.Windows.Storage.Pickers;
+using Rememory.Core;
 using Rememory.Helper;
 using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
 using Windows.ApplicationModel;
 using Windows.System;
 
@@ -17,6 +22,9 @@ namespace Rememory.Views.Settings
         public string GithubLink { get; } = "https://github.com/hpavlo/Rememory";
         public string MicrosoftStoreReviewLink { get; } = "ms-windows-store://review/?ProductId=9NKGMCQGVPL1";
 
+        private static readonly string TraceFileNameFormat_ = "Rememory_Trace_{0:yyyyMMdd_HHmmss}";
+        private static readonly KeyValuePair<string, IList<string>> TraceFileType_ = new("Chrome trace (*.json)", [".json"]);
+
         public AboutPage()
         {
             InitializeComponent();
@@ -38,6 +46,52 @@ namespace Rememory.Views.Settings
             await Launcher.LaunchUriAsync(new(MicrosoftStoreReviewLink));
         }
 
+        private void PerformanceExpander_Expanded(object? sender, EventArgs e)
+        {
+            UpdatePerformanceSummary();
+        }
+
+        private void ResetMetricsButton_Click(object sender, RoutedEventArgs e)
+        {
+            PerformanceMetrics.Reset();
+            UpdatePerformanceSummary();
+        }
+
+        private async void ExportTraceButton_Click(object sender, RoutedEventArgs e)
+        {
+            var picker = new FileSavePicker(SettingsWindow.WindowId);
+            picker.SuggestedFileName = string.Format(TraceFileNameFormat_, DateTime.Now);
+            picker.FileTypeChoices.Add(TraceFileType_);
+
+            var pickFileResult = await picker.PickSaveFileAsync();
+
+            if (!string.IsNullOrEmpty(pickFileResult?.Path))
+            {
+                try
+                {
+                    await File.WriteAllTextAsync(pickFileResult.Path, PerformanceMetrics.ExportTrace());
+                }
+                catch { }
+            }
+        }
+
+        private void UpdatePerformanceSummary()
+        {
+            var timings = PerformanceMetrics.GetTimings()
+                .Where(timing => timing.Count > 0)
+                .Select(timing => "/Settings/About_PerformanceSummary".GetLocalizedFormatResource(
+                    timing.Name,
+                    timing.Count,
+                    timing.Median.TotalMilliseconds.ToString("0.##"),
+                    timing.P95.TotalMilliseconds.ToString("0.##"),
+                    timing.P99.TotalMilliseconds.ToString("0.##"),
+                    timing.Max.TotalMilliseconds.ToString("0.##")));
+
+            var counters = PerformanceMetrics.GetCounters().Select(counter => $"{counter.Key}: {counter.Value}");
+
+            PerformanceSummaryTextBlock.Text = string.Join(Environment.NewLine, timings.Concat(counters));
+        }
+
         protected override void OnNavigatedFrom(NavigationEventArgs e)
         {
             base.OnNavigatedFrom(e);